@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CommandBasedBackendRegisterAccessor.h"
+#include "PollScheduler.h"
+#include "UnsolicitedDispatcher.h"
+#include "ValueConverters.h"
+
+#include <ChimeraTK/AccessMode.h>
+#include <ChimeraTK/NDRegisterAccessor.h>
+#include <ChimeraTK/RegisterPath.h>
+
+#include <memory>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class CommandBasedBackend;
+
+  /********************************************************************************************************************/
+  /**
+   * Accessor with AccessMode::wait_for_new_data for CommandBasedBackend registers with a pollInterval or an
+   * unsolicitedPattern.
+   *
+   * With a pollInterval, the backend's PollScheduler reads the register through a synchronous
+   * CommandBasedBackendRegisterAccessor and pushes the values into the queue of this accessor, from which read() takes
+   * them. With an unsolicitedPattern, the backend's UnsolicitedDispatcher pushes the values of the lines the device
+   * sends on its own into the same queue. Exceptions are pushed into the queue by
+   * CommandBasedBackend::setExceptionImpl(). Writes, if the register is writeable, go through a second synchronous
+   * accessor, so they do not interfere with the polling.
+   *
+   * Registers without pollInterval are read once upon activation, which provides the initial value.
+   */
+  template<typename UserType>
+  class AsyncRegisterAccessor : public NDRegisterAccessor<UserType> {
+   public:
+    /**
+     * @param[in] plan The compiled register, see CommandBasedBackendRegisterAccessor.
+     * @throws ChimeraTK::logic_error if the register has neither pollInterval nor unsolicitedPattern.
+     */
+    AsyncRegisterAccessor(const boost::shared_ptr<DeviceBackend>& dev, std::shared_ptr<const CompiledRegisterPlan> plan,
+        const RegisterPath& registerPathName, size_t numberOfElements, size_t elementOffsetInRegister,
+        AccessModeFlags flags);
+
+    ~AsyncRegisterAccessor() override;
+
+    [[nodiscard]] bool isReadOnly() const override { return not _writeAccessor; }
+
+    [[nodiscard]] bool isReadable() const override { return true; }
+
+    [[nodiscard]] bool isWriteable() const override { return static_cast<bool>(_writeAccessor); }
+
+    std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      return {TransferElement::shared_from_this()};
+    }
+
+    std::list<boost::shared_ptr<TransferElement>> getInternalElements() override { return {}; }
+
+    void interrupt() override { this->interrupt_impl(this->_dataTransportQueue); }
+
+   protected:
+    /** A value as it travels through the queue */
+    struct Buffer {
+      std::vector<std::vector<UserType>> value;
+      VersionNumber versionNumber;
+      DataValidity dataValidity{DataValidity::ok};
+    };
+
+    /** Connects the accessor to the PollScheduler */
+    class PollSubscription : public PollScheduler::Subscription {
+     public:
+      PollSubscription(boost::shared_ptr<CommandBasedBackendRegisterAccessor<UserType>> pollAccessor,
+          cppext::future_queue<Buffer> dataTransportQueue)
+      : _pollAccessor(std::move(pollAccessor)), _dataTransportQueue(std::move(dataTransportQueue)) {}
+
+      void poll() override { _pollAccessor->read(); }
+
+      void push() override {
+        Buffer buffer;
+        buffer.value = _pollAccessor->accessChannels();
+        buffer.dataValidity = _pollAccessor->dataValidity();
+        _dataTransportQueue.push_overwrite(std::move(buffer));
+      }
+
+      void sendException(const std::exception_ptr& e) noexcept override {
+        _dataTransportQueue.push_overwrite_exception(e);
+      }
+
+     protected:
+      boost::shared_ptr<CommandBasedBackendRegisterAccessor<UserType>> _pollAccessor;
+      cppext::future_queue<Buffer> _dataTransportQueue; //!< Shares its state with the accessor's queue
+    };
+
+    /** Connects the accessor to the UnsolicitedDispatcher */
+    class UnsolicitedSubscription : public UnsolicitedDispatcher::Subscription {
+     public:
+      UnsolicitedSubscription(const InteractionInfo& readInfo, size_t numberOfElements, size_t elementOffsetInRegister,
+          cppext::future_queue<Buffer> dataTransportQueue)
+      : _readConverter(makeReadConverter<UserType>(readInfo)), _numberOfElements(numberOfElements),
+        _elementOffsetInRegister(elementOffsetInRegister), _dataTransportQueue(std::move(dataTransportQueue)) {}
+
+      /** Converts the accessor's range of elements, like CommandBasedBackendRegisterAccessor::doPostRead(). */
+      void push(const ResponseMatcher::Result& match) override;
+
+      void sendException(const std::exception_ptr& e) noexcept override {
+        _dataTransportQueue.push_overwrite_exception(e);
+      }
+
+     protected:
+      ReadConverter<UserType> _readConverter;
+      size_t _numberOfElements;
+      size_t _elementOffsetInRegister;
+      cppext::future_queue<Buffer> _dataTransportQueue; //!< Shares its state with the accessor's queue
+    };
+
+    void doPreRead(TransferType type) override;
+
+    /** Not used with wait_for_new_data, the TransferElement takes the values from the _readQueue. */
+    void doReadTransferSynchronously() override {}
+
+    void doPostRead(TransferType type, bool updateDataBuffer) override;
+
+    void doPreWrite(TransferType type, VersionNumber versionNumber) override;
+
+    bool doWriteTransfer(VersionNumber versionNumber) override;
+
+    void doPostWrite(TransferType type, VersionNumber versionNumber) override;
+
+    static constexpr size_t queueLength = 3;
+
+    boost::shared_ptr<CommandBasedBackend> _backend;
+    boost::shared_ptr<CommandBasedBackendRegisterAccessor<UserType>> _writeAccessor; //!< Not set if not writeable
+    cppext::future_queue<Buffer> _dataTransportQueue{queueLength};
+    Buffer _receiveBuffer; //!< Swapped with the front of the queue by the continuation which fills _readQueue
+    std::shared_ptr<PollSubscription> _pollSubscription;
+    std::shared_ptr<UnsolicitedSubscription> _unsolicitedSubscription; //!< Only set with an unsolicitedPattern
+
+    using NDRegisterAccessor<UserType>::buffer_2D;
+  };
+
+  /********************************************************************************************************************/
+
+  DECLARE_TEMPLATE_FOR_CHIMERATK_USER_TYPES(AsyncRegisterAccessor);
+
+} // namespace ChimeraTK
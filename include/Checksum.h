@@ -5,15 +5,137 @@
 #include "CommandBasedBackendRegisterInfo.h"
 #include "mapFileKeys.h"
 
-#include <functional>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct evp_md_ctx_st; // OpenSSL's EVP_MD_CTX
 
 namespace ChimeraTK {
 
   class InteractionInfo;
 
-  // Checksumers perform the chain: checksumOutputAdapter(checksumAlgorithm(checksumInputAdapter(data)))
-  using Checksumer = std::function<std::string(const std::string&)>;
+  /** The largest number of bytes of a checksum result, which is that of SHA256 */
+  constexpr size_t MAX_CHECKSUM_BYTES = 32;
+  using ChecksumBytes = std::array<char, MAX_CHECKSUM_BYTES>;
+
+  /**
+   * @brief Compute a checksum over raw bytes.
+   * @param[in] cs Enum indicating which checksum to compute
+   * @param[in] bytes The checksum payload
+   * @param[out] result Storage of the result
+   * @returns The big endian bytes of the checksum result in the front of result, getHexCharacterWidth(cs) / 2 of them.
+   * @throws ChimeraTK::logic_error if cs isn't mapped.
+   * @throws ChimeraTK::runtime_error if the SHA256 computation fails.
+   */
+  std::string_view computeChecksum(checksum cs, std::string_view bytes, ChecksumBytes& result);
+
+  /**
+   * The state of a checksum computation, to which the payload can be passed in parts.
+   * update() with all parts of a payload and then finish() is the same as computeChecksum() on the payload.
+   */
+  class ChecksumState {
+   public:
+    /**
+     * @throws ChimeraTK::logic_error if cs isn't mapped.
+     */
+    explicit ChecksumState(checksum cs);
+
+    /**
+     * @brief Start over with an empty payload.
+     * @throws ChimeraTK::runtime_error if the SHA256 initialisation fails.
+     */
+    void reset();
+
+    /**
+     * @brief Add the next bytes of the payload.
+     */
+    void update(std::string_view bytes);
+
+    /**
+     * @brief The checksum of the bytes since the last reset(), like computeChecksum(). Call reset() before reusing it.
+     */
+    std::string_view finish(ChecksumBytes& result);
+
+   private:
+    struct DigestContextDeleter {
+      void operator()(evp_md_ctx_st* ctx) const noexcept;
+    };
+
+    checksum _checksum;
+    uint32_t _value{0}; // Sum or CRC register
+    std::unique_ptr<evp_md_ctx_st, DigestContextDeleter> _digest; // Only for SHA256
+  };
+
+  /**
+   * Checksums over byte ranges of a response with a fixed layout, which are updated while the response is received.
+   * Pass each chunk of the response to update() as it arrives, e.g. from a ReceiveObserver. The checksums are ready
+   * when the last byte of their payload has been passed, without another pass over the buffered response.
+   */
+  class IncrementalChecksums {
+   public:
+    /**
+     * @param[in] checksums The checksum types
+     * @param[in] payloads The offset and length in bytes of the payload of each checksum in the response
+     * @throws ChimeraTK::logic_error if a checksum isn't mapped.
+     */
+    IncrementalChecksums(const std::vector<checksum>& checksums, const std::vector<std::pair<size_t, size_t>>& payloads);
+
+    /**
+     * @brief Prepare for the next response.
+     */
+    void reset();
+
+    /**
+     * @brief Pass the next bytes of the response.
+     */
+    void update(std::string_view bytes);
+
+    /**
+     * @brief The number of response bytes passed to update() since the last reset().
+     */
+    [[nodiscard]] size_t getNBytesReceived() const { return _position; }
+
+    /**
+     * @brief The result of checksum i, like computeChecksum() on its payload. Only valid once all of the payload has
+     * been received.
+     */
+    std::string_view finish(size_t i, ChecksumBytes& result) { return _payloads[i].state.finish(result); }
+
+   private:
+    struct Payload {
+      size_t offset;
+      size_t length;
+      ChecksumState state;
+    };
+    std::vector<Payload> _payloads;
+    size_t _position{0};
+  };
+
+  /**
+   * Computes a checksum of a command or response payload in the representation of the interaction's transport layer.
+   * For binary interactions the payload is hex text and so is the result. Otherwise the payload is used as it is and the
+   * result is decimal.
+   */
+  class Checksumer {
+   public:
+    Checksumer(checksum cs, bool isBinary) : _checksum(cs), _isBinary(isBinary) {}
+
+    [[nodiscard]] std::string operator()(std::string_view payload) const;
+
+    /**
+     * @brief Like operator() above, but into result, whose capacity is reused.
+     */
+    void operator()(std::string_view payload, std::string& result) const;
+
+   private:
+    checksum _checksum;
+    bool _isBinary;
+  };
 
   /*
    * The checksumAlgorithm performs the checksum computation.
@@ -24,10 +146,10 @@ namespace ChimeraTK {
   enum class interactionType : int { CMD = 0, RESP };
 
   /**
-   * @brief Construct the Checksumer functions so that they correctly interpret the checksum input and output.
+   * @brief Construct the Checksumers so that they correctly interpret the checksum input and output.
    * @param iType An enum indicating whether this is a Command or a Response
    * @param iInfo Holds all other needed and potentially useful details.
-   * @returns a vector of std::functions that will do the checksums.
+   * @returns a vector of Checksumers that will do the checksums.
    * @throws ChimeraTK::logic_error if the interactionInfo has a checksum enum that isn't mapped to an function.
    */
   std::vector<Checksumer> makeChecksumers(interactionType iType, const InteractionInfo& iInfo);
@@ -40,6 +162,13 @@ namespace ChimeraTK {
    */
   checksumAlgorithm getChecksumAlgorithm(checksum cs);
 
+  /**
+   * @brief The number of hexadecimal characters of the checksum result.
+   * @param cs Enum indicating which checksum to get
+   * @throws ChimeraTK::logic_error if cs isn't mapped.
+   */
+  [[nodiscard]] size_t getHexCharacterWidth(checksum cs);
+
   /**
    * @brief Retrieves a regex string to match the checksum
    * @param cs Enum indicating which checksum to get
@@ -2,9 +2,16 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "AsyncRegisterAccessor.h"
 #include "CommandBasedBackendRegisterAccessor.h"
 #include "CommandBasedBackendRegisterInfo.h"
 #include "CommandHandler.h"
+#include "CommandPipeline.h"
+#include "CompiledRegisterPlan.h"
+#include "IoReactor.h"
+#include "PollScheduler.h"
+#include "SerialPort.h"
+#include "UnsolicitedDispatcher.h"
 
 #include <ChimeraTK/AccessMode.h>
 #include <ChimeraTK/BackendFactory.h>
@@ -14,8 +21,12 @@
 
 #include <boost/make_shared.hpp>
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <vector>
 
 namespace ChimeraTK {
 
@@ -40,15 +51,24 @@ namespace ChimeraTK {
     void open() override;
     void close() override;
 
+    /**
+     * Starts the PollScheduler, which pushes the initial values to the accessors with wait_for_new_data, and the
+     * UnsolicitedDispatcher.
+     */
+    void activateAsyncRead() noexcept override;
+
     /**
      * @brief Send a single command through and receive a vector of responses.
      * This takes care of the details of whether or reading lines or bytes.
      * @param[in] command Is the exact string sent. This may differ from iInfo.commandPattern due to the use of inja templates.
-     * @returns a vector of responces, corresponding to lines if we're reading lines. If we're reading bytes, the return
-     * vector will have length 1.
-     * @throws ChimeraTK::runtime_error if any line of reply doesn't come before a timeout for that line.
+     * @param[out] response The responces, corresponding to lines if we're reading lines. If we're reading bytes, it
+     * will have length 1. If we're reading a block, it has length 1 and holds the payload only. The capacity of its
+     * strings is reused, so an accessor passing the same vector each time does not allocate memory for lines and bytes.
+     * @param[in] onReceive If set and reading bytes, called with the bytes of the response as they arrive.
+     * @throws ChimeraTK::runtime_error if the reply doesn't come before the timeout.
      */
-    std::vector<std::string> sendCommandAndRead(const std::string& cmd, const InteractionInfo& iInfo);
+    void sendCommandAndRead(std::string_view cmd, const InteractionInfo& iInfo, std::vector<std::string>& response,
+        const ReceiveObserver& onReceive = {});
 
     /**
      * @brief Send a single command through and receive a vector (of length nLinesToRead) responses.
@@ -59,7 +79,7 @@ namespace ChimeraTK {
      * @param[in] readDelimiter if set, this overrides the default _delimiter for the reading operation in this call.
      * @returns a vector of length nLinesToRead containing the response to cmd, with one line of response per entry in
      * the vector.
-     * @throws ChimeraTK::runtime_error if any line of reply doesn't come before a timeout for that line.
+     * @throws ChimeraTK::runtime_error if the reply doesn't come before the timeout.
      */
     std::vector<std::string> sendCommandAndReadLines(std::string cmd, size_t nLinesToRead = 1,
         const Delimiter& writeDelimiter = CommandHandlerDefaultDelimiter{},
@@ -95,6 +115,13 @@ namespace ChimeraTK {
 
     RegisterCatalogue getRegisterCatalogue() const override;
 
+    /**
+     * @brief Get the compiled plan of a register, which is shared by all accessors to that register.
+     * The plan is built on first use and cached for the lifetime of the backend.
+     * @throws ChimeraTK::logic_error if the register does not exist.
+     */
+    std::shared_ptr<const CompiledRegisterPlan> getRegisterPlan(const RegisterPath& registerPathName);
+
     std::string readDeviceInfo() override;
 
     /*----------------------------------------------------------------------------------------------------------------*/
@@ -111,6 +138,18 @@ namespace ChimeraTK {
      */
     std::string _port;
 
+    /**
+     * Serial line settings from the CDD parameters baud, dataBits, parity, stopBits and flowControl.
+     * Used when _commandBasedBackendType = CommandBasedBackendType::SERIAL
+     */
+    SerialPortSettings _serialPortSettings;
+
+    /**
+     * Minimum number of threads of the process-wide IoReactor, from the CDD parameter ioThreads.
+     * Used when _commandBasedBackendType = CommandBasedBackendType::ETHERNET
+     */
+    size_t _nIoThreads = IoReactor::defaultNumberOfThreads;
+
     /**
      * The timeout parameter given to the command handler upon open().
      * This becomes the timeout parameter of sendCommand
@@ -121,13 +160,58 @@ namespace ChimeraTK {
     std::mutex _mux; /**< mutex for protecting ordered port access */
     std::unique_ptr<CommandHandler> _commandHandler;
 
+    /**
+     * Number of commands in flight, from the map file metadata key pipelineDepth. With the default of 1, each transfer
+     * holds _mux for the whole round trip.
+     */
+    size_t _pipelineDepth = 1;
+
+    /** Orders the transfers instead of _mux if _pipelineDepth > 1. Created upon open(). */
+    std::unique_ptr<CommandPipeline> _pipeline;
+
+    /**
+     * Polls the registers of the accessors with AccessMode::wait_for_new_data, see AsyncRegisterAccessor. Active
+     * between activateAsyncRead() and the next exception or close().
+     */
+    PollScheduler _pollScheduler;
+
+    /**
+     * Poll interval of readable registers without pollInterval in the map file, from the CDD parameter pollInterval
+     * in milliseconds.
+     */
+    std::optional<std::chrono::milliseconds> _defaultPollInterval;
+
+    /** The registers with an unsolicitedPattern, whose lines are recognised from open() on. */
+    std::vector<RegisterPath> _unsolicitedRegisters;
+
+    /** Receives the line read by the listener of the _unsolicitedDispatcher in each turn. */
+    std::string _listenerLine;
+
+    /**
+     * Routes the lines the device sends on its own to the accessors with AccessMode::wait_for_new_data. Active like
+     * the _pollScheduler. Its listener thread runs while the device is open, unless _pipelineDepth > 1. Declared after
+     * the members the listener uses, so it is stopped first on destruction.
+     */
+    UnsolicitedDispatcher _unsolicitedDispatcher;
+
+    /** From the map file metadata key compoundCommand. If set, reads in a TransferGroup are merged. */
+    std::optional<CompoundCommandSettings> _compoundCommandSettings;
+
     // Obtained from map file
-    std::string _defaultRecoveryRegister;
+    RegisterPath _defaultRecoveryRegister;
     std::string _serialDelimiter; /**< The line delimiter between messages in serial communications. */
     BackendRegisterCatalogue<CommandBasedBackendRegisterInfo> _backendCatalogue;
 
-    /** The last register that was attempted to be written. Might have failed and is re-tried on open. */
+    /** Cache for getRegisterPlan(). Accessors may be created from several threads, hence the mutex. */
+    std::map<RegisterPath, std::shared_ptr<const CompiledRegisterPlan>> _registerPlans;
+    std::mutex _registerPlansMutex;
+
+    /**
+     * The last register that was attempted to be written. Might have failed and is re-tried on open. Set by the
+     * accessors from any thread, e.g. the PollScheduler's, hence the mutex.
+     */
     ChimeraTK::RegisterPath _lastWrittenRegister;
+    std::mutex _lastWrittenRegisterMutex;
 
     /**
      * Fill in the backend register catalog from the json map file.
@@ -136,9 +220,28 @@ namespace ChimeraTK {
      */
     void parseJsonAndPopulateCatalogue(const std::string& mapFileName);
 
+    /**
+     * @brief Parse the value of the map file metadata key compoundCommand.
+     * @throws ChimeraTK::logic_error for unknown keys or empty separators.
+     */
+    static CompoundCommandSettings parseCompoundCommandSettings(const json& j);
+
+    /**
+     * @brief Read the response to a command which has been sent already. Common part of the pipelined and the
+     * non-pipelined sendCommandAndRead().
+     */
+    void readResponse(const InteractionInfo& iInfo, std::vector<std::string>& response,
+        const ReceiveObserver& onReceive, std::chrono::milliseconds timeout);
+
+    /** Sends the exception to the accessors with wait_for_new_data and stops polling. */
+    void setExceptionImpl() noexcept override;
+
     template<typename UserType>
     friend class CommandBasedBackendRegisterAccessor;
 
+    template<typename UserType>
+    friend class AsyncRegisterAccessor;
+
   }; // end class CommandBasedBackend
 
   /********************************************************************************************************************/
@@ -149,10 +252,12 @@ namespace ChimeraTK {
   // NOLINTNEXTLINE(readability-identifier-naming)
   boost::shared_ptr<NDRegisterAccessor<UserType>> CommandBasedBackend::getRegisterAccessor_impl(
       const RegisterPath& registerPathName, size_t numberOfWords, size_t wordOffsetInRegister, AccessModeFlags flags) {
-    auto registerInfo = _backendCatalogue.getBackendRegister(registerPathName);
-
-    return boost::make_shared<CommandBasedBackendRegisterAccessor<UserType>>(
-        DeviceBackend::shared_from_this(), registerInfo, registerPathName, numberOfWords, wordOffsetInRegister, flags);
+    if(flags.has(AccessMode::wait_for_new_data)) {
+      return boost::make_shared<AsyncRegisterAccessor<UserType>>(DeviceBackend::shared_from_this(),
+          getRegisterPlan(registerPathName), registerPathName, numberOfWords, wordOffsetInRegister, flags);
+    }
+    return boost::make_shared<CommandBasedBackendRegisterAccessor<UserType>>(DeviceBackend::shared_from_this(),
+        getRegisterPlan(registerPathName), registerPathName, numberOfWords, wordOffsetInRegister, flags);
   }
 
 } // end namespace ChimeraTK
@@ -3,24 +3,23 @@
 #pragma once
 
 #include "CommandBasedBackendRegisterInfo.h"
+#include "CompiledRegisterPlan.h"
+#include "CompoundReadTransferElement.h"
+#include "RegisterReadTransferElement.h"
+#include "ResponseMatcher.h"
+#include "ValueConverters.h"
 
 #include <ChimeraTK/AccessMode.h>
 #include <ChimeraTK/BackendRegisterCatalogue.h>
 #include <ChimeraTK/NDRegisterAccessor.h>
 #include <ChimeraTK/RegisterPath.h>
 
-#include <functional>
+#include <variant>
 #include <memory>
-#include <regex>
+#include <optional>
 
 namespace ChimeraTK {
 
-  template<typename UserType>
-  using ToUserTypeFunc = std::function<UserType(const std::string&, const InteractionInfo&)>;
-
-  template<typename UserType>
-  using ToTransportLayerFunc = std::function<std::string(const UserType&, const InteractionInfo&)>;
-
   class CommandBasedBackend;
 
   /********************************************************************************************************************/
@@ -30,8 +29,12 @@ namespace ChimeraTK {
   template<typename UserType> //, DataConverterType>
   class CommandBasedBackendRegisterAccessor : public NDRegisterAccessor<UserType> {
    public:
+    /**
+     * @param[in] plan The compiled register, shared by all accessors to the same register. Obtain it from
+     * CommandBasedBackend::getRegisterPlan().
+     */
     CommandBasedBackendRegisterAccessor(const boost::shared_ptr<ChimeraTK::DeviceBackend>& dev,
-        CommandBasedBackendRegisterInfo& registerInfo, const RegisterPath& registerPathName, size_t numberOfElements,
+        std::shared_ptr<const CompiledRegisterPlan> plan, const RegisterPath& registerPathName, size_t numberOfElements,
         size_t elementOffsetInRegister, AccessModeFlags flags, bool isRecoveryTestAccessor = false);
 
     // Overridden functions should use Impl version if they may ever be called from the constructor.
@@ -42,16 +45,36 @@ namespace ChimeraTK {
     [[nodiscard]] bool isWriteable() const override { return isWriteableImpl(); }
 
     std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      if(_compoundRead) {
+        return {_compoundRead};
+      }
+      if(isReadOnly()) {
+        return {_registerRead};
+      }
       return {TransferElement::shared_from_this()}; // Returns a shared pointer to `this`
     }
 
     std::list<boost::shared_ptr<TransferElement>> getInternalElements() override {
-      // Return an empty list.
+      if(_compoundRead) {
+        return {_compoundRead, _registerRead};
+      }
+      if(_registerRead) {
+        return {_registerRead};
+      }
       return {};
     }
 
-    void replaceTransferElement([[maybe_unused]] boost::shared_ptr<TransferElement> newElement) override {
-    } // mayReplaceTransferElement = false, so this is just empty.
+    /**
+     * Accessors to the same register, with the same UserType and element range, are interchangeable.
+     */
+    [[nodiscard]] bool mayReplaceOther(const boost::shared_ptr<TransferElement const>& other) const override;
+
+    /**
+     * This is how a TransferGroup merges the reads of read-only accessors. They take over the given element if it reads
+     * the same register, so the register is transferred and parsed only once for all of them. With compound commands,
+     * they also move their RegisterReadTransferElement into a CompoundReadTransferElement which may adopt it.
+     */
+    void replaceTransferElement(boost::shared_ptr<TransferElement> newElement) override;
 
     /*----------------------------------------------------------------------------------------------------------------*/
    protected:
@@ -59,7 +82,8 @@ namespace ChimeraTK {
 
     size_t _numberOfElements;
     size_t _elementOffsetInRegister;
-    CommandBasedBackendRegisterInfo _registerInfo;
+    std::shared_ptr<const CompiledRegisterPlan> _plan;
+    const CommandBasedBackendRegisterInfo& _registerInfo; //!< Refers to _plan->registerInfo
 
     [[nodiscard]] bool isReadOnlyImpl() const { return _registerInfo.isReadable() && !isWriteable(); }
     [[nodiscard]] bool isReadableImpl() const { return _registerInfo.isReadable(); }
@@ -78,15 +102,48 @@ namespace ChimeraTK {
     /** the backend to use for the actual hardware access */
     boost::shared_ptr<CommandBasedBackend> _backend;
 
-    std::vector<std::string> _readTransferBuffer;
     std::string _writeTransferBuffer;
 
-    ToTransportLayerFunc<UserType> _transportLayerTypeFromUserType;
-    ToUserTypeFunc<UserType> _userTypeFromTransportLayerType;
+    // Reused between transfers when rendering the command templates, so their capacity is kept.
+    std::vector<std::string> _commandData;      //!< Values for the {{x.i}} tags
+    std::vector<std::string> _commandChecksums; //!< Values for the {{cs.i}} tags
+    std::string _checksumPayloadBuffer;
+    std::string _hexCommandBuffer; //!< Binary commands are rendered as hex into this, then decoded
 
-    void doPreRead([[maybe_unused]] TransferType) override;
+    // Reused between transfers when receiving and matching responses, so repeated transfers do not allocate memory.
+    std::vector<std::string> _writeResponseBuffer;
+    std::string _combinedResponseBuffer; //!< See makeCombinedReadString()
+    std::string _checksumResultBuffer;
 
-    void doPostRead([[maybe_unused]] TransferType t, bool updateDataBuffer) override;
+    // Selected once for the transport layer type, see ValueConverters.h
+    WriteConverter<UserType> _writeConverter;
+    ReadConverter<UserType> _readConverter;
+    /** Only set if the plan has a readBinaryLayout */
+    std::optional<BinaryReadConverter<UserType>> _binaryReadConverter;
+
+    /**
+     * Reads and parses the register, only set if it is readable. Shared with other accessors to the same register in a
+     * TransferGroup, see replaceTransferElement().
+     */
+    boost::shared_ptr<RegisterReadTransferElement> _registerRead;
+
+    /**
+     * Only set for read-only registers with a command and response that can be merged into compound commands, if the
+     * map file enables them. It then does the transfers of the _registerRead.
+     */
+    boost::shared_ptr<CompoundReadTransferElement> _compoundRead;
+
+    /** The element which does the read transfers, _compoundRead if set, otherwise _registerRead */
+    TransferElement& getReadElement() {
+      if(_compoundRead) {
+        return *_compoundRead;
+      }
+      return *_registerRead;
+    }
+
+    void doPreRead(TransferType type) override;
+
+    void doPostRead(TransferType t, bool updateDataBuffer) override;
 
     void doPreWrite([[maybe_unused]] TransferType, [[maybe_unused]] VersionNumber) override;
 
@@ -94,17 +151,21 @@ namespace ChimeraTK {
 
     void doReadTransferSynchronously() override;
 
-    std::regex _readResponseDataRegex;
-    std::regex _readResponseChecksumPayloadRegex;
-    std::regex _readResponseChecksumRegex;
-    std::regex _writeResponseDataRegex;
-    std::regex _writeResponseChecksumPayloadRegex;
-    std::regex _writeResponseChecksumRegex;
-
-    std::vector<Checksumer> _readCommandChecksumers;
-    std::vector<Checksumer> _readResponseChecksumers;
-    std::vector<Checksumer> _writeCommandChecksumers;
-    std::vector<Checksumer> _writeResponseChecksumers;
+    /**
+     * Convert the values matched by the _registerRead into the user buffer, visiting the converter once for all
+     * elements.
+     * @param[in] converter The _readConverter, or the _binaryReadConverter for raw bytes.
+     */
+    template<typename Converter>
+    void convertMatchedData(const Converter& converter);
+
+    /** The part of doPostRead for block data responses, see InteractionInfo::usesReadBlock() */
+    void decodeBlockResponse();
+
+    /** Remember this transfer's register for the recovery in CommandBasedBackend::open(). */
+    void setLastWrittenRegister(const RegisterPath& registerPath);
+
+    ResponseMatcher::Result _responseMatch; //!< Reused by each write response match
   }; // end class CommandBasedBackendRegisterAccessor
 
   DECLARE_TEMPLATE_FOR_CHIMERATK_USER_TYPES(CommandBasedBackendRegisterAccessor);
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Checksum.h"
+#include "CommandTemplate.h"
+#include "ResponseMatcher.h"
 #include "mapFileKeys.h"
 
 #include <ChimeraTK/BackendRegisterInfoBase.h>
@@ -10,10 +12,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <regex>
+#include <utility>
 #include <variant>
 
 using json = nlohmann::json;
@@ -29,14 +33,21 @@ namespace ChimeraTK {
     struct ResponseBytesInfo {
       size_t nBytesReadResponse = 0;
     };
+    struct ResponseBlockInfo {
+      BlockDataType elementType = BlockDataType::UINT8;
+      ByteOrder byteOrder = ByteOrder::BIG;
+      std::string terminator; // Sent by the device after the block, may be empty
+      size_t nBytes = 0;      // Expected payload size, set by CommandBasedBackendRegisterInfo::finalize()
+    };
     /*
      * responseInfo stores information relavent to line delimited reading when reading lines,
-     * or information about fixed byte reading when reading bytes.
+     * or information about fixed byte reading when reading bytes,
+     * or information about the elements when reading an IEEE 488.2 definite length block.
      * For readability, interact with it through the getters and setters.
      * Default=ResponseLinesInfo
      * responseInfo variant type order indicies must match the SendCommandType enum values
      */
-    std::variant<ResponseLinesInfo, ResponseBytesInfo> _responseInfo;
+    std::variant<ResponseLinesInfo, ResponseBytesInfo, ResponseBlockInfo> _responseInfo;
     std::optional<TransportLayerType> _transportLayerType = std::nullopt;
 
    public:
@@ -46,6 +57,14 @@ namespace ChimeraTK {
     std::vector<std::string> commandChecksumPayloadStrs; // semgnetns of the commandPattern which are inja tempaltes of
                                                          // the checksum payloads that will be inputs to the checksums.
 
+    // commandPattern and commandChecksumPayloadStrs compiled by compileCommandTemplates(), used for every transfer.
+    CommandTemplate commandTemplate;
+    std::vector<CommandTemplate> commandChecksumPayloadTemplates;
+
+    // The complete command including checksums, already converted to binary for binary interactions.
+    // Only set by foldConstantCommand() if the command does not depend on any data.
+    std::optional<std::string> constantCommand;
+
     /*
      * fixedRegexCharacterWidthOpt is the hexidecimal character width of the object to be searched for by the regex
      * in the reply string, and the character width inserted while writing.
@@ -74,6 +93,18 @@ namespace ChimeraTK {
     // interactionInfo, we can skip setting it again by setting skipSetType to true.
     void populateFromJson(const json& j, const std::string& errorMessageDetail, bool skipSetType = false);
 
+    /**
+     * @brief Parse commandPattern and commandChecksumPayloadStrs into commandTemplate and
+     * commandChecksumPayloadTemplates. Must be called again if the patterns are changed.
+     */
+    void compileCommandTemplates(const std::string& errorMessageDetail);
+
+    /**
+     * @brief Render the command once and store it in constantCommand, if commandTemplate does not depend on data.
+     * Must be called after compileCommandTemplates() and after the checksum enums have been set.
+     */
+    void foldConstantCommand();
+
     /*
      * If an InteractionInfo is not active, then it is disabled.
      * For example, if readInfo.isActive() is true, then the register is readable;
@@ -95,6 +126,10 @@ namespace ChimeraTK {
     [[nodiscard]] std::optional<size_t> getResponseNLines() const noexcept;
     [[nodiscard]] std::optional<std::string> getResponseLinesDelimiter() const noexcept;
     [[nodiscard]] std::optional<size_t> getResponseBytes() const noexcept;
+    [[nodiscard]] std::optional<BlockDataType> getResponseBlockElementType() const noexcept;
+    [[nodiscard]] std::optional<ByteOrder> getResponseBlockByteOrder() const noexcept;
+    [[nodiscard]] std::optional<std::string> getResponseBlockTerminator() const noexcept;
+    [[nodiscard]] std::optional<size_t> getResponseBlockBytes() const noexcept;
 
     /**
      * @brief Gets the regex pattern string for this InteractionInfo's type
@@ -110,10 +145,16 @@ namespace ChimeraTK {
     void setResponseDelimiter(std::string delimiter);
     void setResponseNLines(size_t nLines);
     void setResponseBytes(size_t nBytes) { _responseInfo = ResponseBytesInfo{nBytes}; }
+    void setResponseBlock(BlockDataType elementType, ByteOrder byteOrder, std::string terminator) {
+      _responseInfo = ResponseBlockInfo{elementType, byteOrder, std::move(terminator)};
+    }
+    /** Only for block data responses, i.e. after setResponseBlock(). */
+    void setResponseBlockBytes(size_t nBytes);
     void setTransportLayerType(TransportLayerType& type) noexcept;
 
     [[nodiscard]] inline bool usesReadLines() const { return std::holds_alternative<ResponseLinesInfo>(_responseInfo); }
     [[nodiscard]] inline bool usesReadBytes() const { return std::holds_alternative<ResponseBytesInfo>(_responseInfo); }
+    [[nodiscard]] inline bool usesReadBlock() const { return std::holds_alternative<ResponseBlockInfo>(_responseInfo); }
     [[nodiscard]] inline bool hasTransportLayerType() const { return _transportLayerType.has_value(); }
     /*----------------------------------------------------------------------------------------------------------------*/
    protected:
@@ -134,9 +175,11 @@ namespace ChimeraTK {
     /**
      * @brief Create and populate a CommandBasedBackendRegisterInfo directly from json.
      * @param[in] defaultSerialDelimiter Sets the serial delimiters in case no delimiter is mentioned in the json.
+     * @param[in] defaultPollInterval Sets the pollInterval of readable registers in case it is not in the json.
      */
-    explicit CommandBasedBackendRegisterInfo(
-        const RegisterPath& registerPath_, const json& j, const std::string& defaultSerialDelimiter);
+    explicit CommandBasedBackendRegisterInfo(const RegisterPath& registerPath_, const json& j,
+        const std::string& defaultSerialDelimiter,
+        std::optional<std::chrono::milliseconds> defaultPollInterval = std::nullopt);
 
     /**
      * @brief Validates the data
@@ -159,7 +202,12 @@ namespace ChimeraTK {
     [[nodiscard]] inline const DataDescriptor& getDataDescriptor() const override { return dataDescriptor; }
     [[nodiscard]] inline bool isReadable() const override { return readInfo.isActive(); }
     [[nodiscard]] inline bool isWriteable() const override { return writeInfo.isActive(); }
-    [[nodiscard]] inline AccessModeFlags getSupportedAccessModes() const override { return {}; }
+    [[nodiscard]] inline AccessModeFlags getSupportedAccessModes() const override {
+      if(pollInterval or not unsolicitedPattern.empty()) {
+        return {AccessMode::wait_for_new_data};
+      }
+      return {};
+    }
 
     [[nodiscard]] inline std::unique_ptr<BackendRegisterInfoBase> clone() const override {
       return std::make_unique<CommandBasedBackendRegisterInfo>(*this);
@@ -192,12 +240,40 @@ namespace ChimeraTK {
       return getResponseChecksumPayloadRegex(writeInfo, "write for " + registerPath);
     }
 
+    /**
+     * @brief Compiles the read response pattern into a ResponseMatcher, which falls back to the response regexes if
+     * the pattern cannot be compiled.
+     * @throws ChimeraTK::logic_error if the fallback regexes cannot be created.
+     */
+    [[nodiscard]] ResponseMatcher getReadResponseMatcher() const {
+      return getResponseMatcher(readInfo, "read for " + registerPath);
+    }
+    /**
+     * @brief Compiles the write response pattern into a ResponseMatcher, see getReadResponseMatcher().
+     */
+    [[nodiscard]] ResponseMatcher getWriteResponseMatcher() const {
+      return getResponseMatcher(writeInfo, "write for " + registerPath);
+    }
+    /**
+     * @brief Compiles the unsolicitedPattern with the read settings, see getReadResponseMatcher().
+     */
+    [[nodiscard]] ResponseMatcher getUnsolicitedResponseMatcher() const;
+
     unsigned int nChannels{1};
     unsigned int nElements{1};
     RegisterPath registerPath; // can be converted to string
     InteractionInfo readInfo;
     InteractionInfo writeInfo;
 
+    /** If set, the register is polled at this interval for accessors with AccessMode::wait_for_new_data. */
+    std::optional<std::chrono::milliseconds> pollInterval;
+
+    /**
+     * Response pattern of lines the device sends on its own for this register. Empty if there are none. Requires a read
+     * command, which provides the initial value and synchronous reads.
+     */
+    std::string unsolicitedPattern;
+
     DataDescriptor dataDescriptor;
 
    protected:
@@ -220,6 +296,9 @@ namespace ChimeraTK {
     [[nodiscard]] std::regex getResponseChecksumPayloadRegex(
         const InteractionInfo& info, const std::string& errorMessageDetail) const;
 
+    [[nodiscard]] ResponseMatcher getResponseMatcher(
+        const InteractionInfo& info, const std::string& errorMessageDetail) const;
+
     friend void throwIfBadCommandAndResponsePatterns(const CommandBasedBackendRegisterInfo& regInfo,
         const std::string& errorMessageDetail); // accesses getNumberOfElementsImpl()
   }; // end CommandBasedBackendRegisterInfo
@@ -2,9 +2,13 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "ReceiveBuffer.h"
+
 #include <chrono>
+#include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility> //for move()
 #include <variant>
 #include <vector>
@@ -44,7 +48,18 @@ class CommandHandler {
   std::vector<std::string> sendCommandAndReadLines(std::string cmd, size_t nLinesToRead = 1,
       const Delimiter& writeDelimiter = CommandHandlerDefaultDelimiter{},
       const Delimiter& readDelimiter = CommandHandlerDefaultDelimiter{}) {
-    return sendCommandAndReadLinesImpl(std::move(cmd), nLinesToRead, writeDelimiter, readDelimiter);
+    std::vector<std::string> lines;
+    sendCommandAndReadLinesImpl(cmd, nLinesToRead, writeDelimiter, readDelimiter, lines);
+    return lines;
+  }
+
+  /**
+   * @brief Like sendCommandAndReadLines(), but into lines, which is resized to nLinesToRead. The capacity of lines and
+   * of its strings is reused, so repeating a command does not allocate memory once the buffers are large enough.
+   */
+  void sendCommandAndReadLinesInto(std::string_view cmd, size_t nLinesToRead, const Delimiter& writeDelimiter,
+      const Delimiter& readDelimiter, std::vector<std::string>& lines) {
+    sendCommandAndReadLinesImpl(cmd, nLinesToRead, writeDelimiter, readDelimiter, lines);
   }
 
   /**
@@ -55,13 +70,124 @@ class CommandHandler {
    * @param[in] nBytesToRead The number of bytes required in reply to the sent command cmd. If 0, no read is attempted.
    * @param[in] writeDelimiter if set, the specified write delimiter is added for this call, which can be a string or
    * CommandHandlerDefaultDelimiter{}.
+   * @param[in] onReceive If set, called with the bytes of the response as they arrive, e.g. to compute checksums
+   * without a second pass over the response. It is done with the response once this function returns.
    * @returns A string as a container of bytes containing the response. The return string is not null terminated.
    * @throws ChimeraTK::runtime_error if those returns do not occur within timeout.
    */
-  std::string sendCommandAndReadBytes(std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter = "") {
-    return sendCommandAndReadBytesImpl(std::move(cmd), nBytesToRead, writeDelimiter);
+  std::string sendCommandAndReadBytes(std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter = "",
+      const ChimeraTK::ReceiveObserver& onReceive = {}) {
+    std::string bytes;
+    sendCommandAndReadBytesImpl(cmd, nBytesToRead, writeDelimiter, onReceive, bytes);
+    return bytes;
+  }
+
+  /**
+   * @brief Like sendCommandAndReadBytes(), but into bytes, whose capacity is reused.
+   */
+  void sendCommandAndReadBytesInto(std::string_view cmd, size_t nBytesToRead, const Delimiter& writeDelimiter,
+      std::string& bytes, const ChimeraTK::ReceiveObserver& onReceive = {}) {
+    sendCommandAndReadBytesImpl(cmd, nBytesToRead, writeDelimiter, onReceive, bytes);
+  }
+
+  /**
+   * @brief Send a command to a SCPI device, read back an IEEE 488.2 definite length arbitrary block response
+   * "#<n><length><payload>", where n is the number of digits of length, and length the number of payload bytes.
+   * @param[in] cmd The command to be sent, which should have no delimiter
+   * @param[in] nBytesExpected The payload length the header must announce. The payload is not read otherwise.
+   * @param[in] writeDelimiter if set, this overrides the default delimiter for the writing operation in this call.
+   * @param[in] terminator The bytes the device sends after the block, which are read and checked. May be empty.
+   * @returns A string as a container of bytes containing the payload only.
+   * @throws ChimeraTK::runtime_error on timeout, if the header is malformed or announces another length, or if the
+   * terminator does not match.
+   */
+  std::string sendCommandAndReadBlock(std::string_view cmd, size_t nBytesExpected,
+      const Delimiter& writeDelimiter = CommandHandlerDefaultDelimiter{}, const std::string& terminator = "") {
+    return sendCommandAndReadBlockImpl(cmd, nBytesExpected, writeDelimiter, terminator);
+  }
+
+  /**
+   * @brief Send a command without reading its response. Read it later with readLinesInto(), readBytesInto() or
+   * readBlock(), in the same order as the commands have been sent. This allows sending further commands before the
+   * responses have arrived (pipelining), for devices which queue their input and answer in order.
+   * Sending and reading may happen concurrently in two threads, but sends must not overlap with other sends, and reads
+   * not with other reads.
+   * @param[in] cmd The command to be sent, which should have no delimiter
+   * @param[in] writeDelimiter if set, this overrides the default delimiter for the writing operation in this call.
+   * @throws ChimeraTK::runtime_error if the send fails.
+   */
+  void sendCommand(std::string_view cmd, const Delimiter& writeDelimiter = CommandHandlerDefaultDelimiter{}) {
+    sendCommandImpl(cmd, writeDelimiter);
+  }
+
+  /**
+   * @brief Read the response lines of a command sent with sendCommand().
+   * @param[out] lines Resized to nLinesToRead and filled, reusing the capacity of its strings.
+   * @param[in] readTimeout Used instead of the timeout member for the whole response.
+   * @throws ChimeraTK::runtime_error if the lines do not arrive within readTimeout.
+   */
+  void readLinesInto(size_t nLinesToRead, const Delimiter& readDelimiter, std::vector<std::string>& lines,
+      std::chrono::milliseconds readTimeout) {
+    readLinesImpl(nLinesToRead, readDelimiter, lines, readTimeout);
+  }
+
+  /**
+   * @brief Read the response bytes of a command sent with sendCommand().
+   * @param[out] bytes Assigned the response, reusing its capacity.
+   * @param[in] readTimeout Used instead of the timeout member.
+   * @throws ChimeraTK::runtime_error if the bytes do not arrive within readTimeout.
+   */
+  void readBytesInto(size_t nBytesToRead, std::string& bytes, std::chrono::milliseconds readTimeout,
+      const ChimeraTK::ReceiveObserver& onReceive = {}) {
+    readBytesImpl(nBytesToRead, bytes, readTimeout, onReceive);
+  }
+
+  /**
+   * @brief Read the block data response of a command sent with sendCommand(), see sendCommandAndReadBlock().
+   * @param[in] readTimeout Used instead of the timeout member for each part of the block.
+   * @returns The payload of the block.
+   */
+  std::string readBlock(size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) {
+    return readBlockImpl(nBytesExpected, terminator, readTimeout);
+  }
+
+  /**
+   * @brief Read a single line with the default delimiter and hand it to the UnsolicitedLineHandler. Unlike
+   * readLinesInto(), no further line is read in place of a consumed one, so the call takes at most readTimeout also
+   * while the device keeps sending lines on its own.
+   * Lines which are not consumed by the UnsolicitedLineHandler have no command waiting for them, so they are dropped.
+   * @param[out] line The line read, reusing its capacity.
+   * @returns false if no line has arrived within readTimeout, which is normal while the device has nothing to send.
+   * @throws ChimeraTK::runtime_error if the read fails otherwise, e.g. because the connection has been lost.
+   */
+  bool readUnsolicitedLine(std::string& line, std::chrono::milliseconds readTimeout) {
+    if(not readLineImpl(line, readTimeout)) {
+      return false;
+    }
+    [[maybe_unused]] bool isConsumed = isUnsolicited(line);
+    return true;
   }
 
+  /**
+   * @brief Wait until the device has sent bytes which have not been received yet, without receiving them. Bytes which
+   * an earlier read has received already are not considered. Unlike the other functions, this may be called
+   * concurrently with a transfer in another thread, so the caller need not hold the transport layer while the device
+   * is idle.
+   * @returns Whether bytes are pending, or the connection reports an error, which the next read will throw.
+   */
+  bool waitForInput(std::chrono::milliseconds timeout) { return waitForInputImpl(timeout); }
+
+  /**
+   * @brief Handler for lines the device sends on its own, e.g. events or streamed measurements, see
+   * UnsolicitedDispatcher. It is called with each line read by the line based functions, and returns true if it has
+   * consumed the line. Consumed lines are not part of the response, the next line is read in their place, within the
+   * time left for the response.
+   * Set it before the first transfer, it is not synchronised with reads in progress.
+   */
+  using UnsolicitedLineHandler = std::function<bool(std::string_view line)>;
+
+  void setUnsolicitedLineHandler(UnsolicitedLineHandler handler) { _unsolicitedLineHandler = std::move(handler); }
+
   virtual ~CommandHandler() = default;
 
   /**
@@ -84,9 +210,73 @@ class CommandHandler {
   [[nodiscard]] std::string toStringGuarded(const Delimiter& delimOption) const;
 
  protected:
-  virtual std::vector<std::string> sendCommandAndReadLinesImpl(
-      std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) = 0;
+  using Clock = std::chrono::steady_clock;
+
+  /** @brief Whether the line has been consumed by the UnsolicitedLineHandler. Used by the readLinesImpl functions. */
+  [[nodiscard]] bool isUnsolicited(std::string_view line) const {
+    return _unsolicitedLineHandler and _unsolicitedLineHandler(line);
+  }
+
+  /**
+   * @param[out] lines Resized to nLinesToRead and filled, reusing the capacity of its strings.
+   */
+  virtual void sendCommandAndReadLinesImpl(std::string_view cmd, size_t nLinesToRead, const Delimiter& writeDelimiter,
+      const Delimiter& readDelimiter, std::vector<std::string>& lines) = 0;
+
+  /**
+   * @param[out] bytes Assigned the response, reusing its capacity.
+   */
+  virtual void sendCommandAndReadBytesImpl(std::string_view cmd, size_t nBytesToRead, const Delimiter& writeDelimiter,
+      const ChimeraTK::ReceiveObserver& onReceive, std::string& bytes) = 0;
+
+  virtual std::string sendCommandAndReadBlockImpl(
+      std::string_view cmd, size_t nBytesExpected, const Delimiter& writeDelimiter, const std::string& terminator) = 0;
+
+  virtual void sendCommandImpl(std::string_view cmd, const Delimiter& writeDelimiter) = 0;
+
+  virtual void readLinesImpl(size_t nLinesToRead, const Delimiter& readDelimiter, std::vector<std::string>& lines,
+      std::chrono::milliseconds readTimeout) = 0;
+
+  virtual void readBytesImpl(size_t nBytesToRead, std::string& bytes, std::chrono::milliseconds readTimeout,
+      const ChimeraTK::ReceiveObserver& onReceive) = 0;
+
+  virtual std::string readBlockImpl(
+      size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) = 0;
+
+  /**
+   * @brief Read one line with the default delimiter, without passing it to the UnsolicitedLineHandler.
+   * @param[out] line The line read, reusing its capacity.
+   * @returns false if no line has arrived within readTimeout.
+   * @throws ChimeraTK::runtime_error if the read fails otherwise.
+   */
+  virtual bool readLineImpl(std::string& line, std::chrono::milliseconds readTimeout) = 0;
+
+  virtual bool waitForInputImpl(std::chrono::milliseconds timeout) = 0;
+
+  /**
+   * @brief Time left until the deadline of a response, for reading its next line. Zero once the deadline has passed,
+   * so lines which have been received already are still returned. Used by the readLinesImpl functions, so lines
+   * consumed by the UnsolicitedLineHandler do not extend the time for the response.
+   */
+  static std::chrono::milliseconds getRemainingTime(Clock::time_point deadline);
+
+  /**
+   * @brief Read an arbitrary block with the given function reading a fixed number of bytes. Common part of the
+   * sendCommandAndReadBlockImpl implementations.
+   * @returns The payload of the block.
+   * @throws ChimeraTK::runtime_error if the header is malformed or announces another length than nBytesExpected, or if
+   * the terminator does not match.
+   */
+  static std::string readBlock(
+      const std::function<std::string(size_t)>& readBytes, size_t nBytesExpected, const std::string& terminator);
+
+  /**
+   * @brief Append the write delimiter to cmd.
+   * @returns A buffer which is reused by the next call, so the command is not copied into a new string each time.
+   */
+  const std::string& appendWriteDelimiter(std::string_view cmd, const Delimiter& writeDelimiter);
 
-  virtual std::string sendCommandAndReadBytesImpl(
-      std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) = 0;
+ private:
+  std::string _sendBuffer; //!< See appendWriteDelimiter()
+  UnsolicitedLineHandler _unsolicitedLineHandler;
 };
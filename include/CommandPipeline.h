@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+
+namespace ChimeraTK {
+
+  /**
+   * Lets several threads have commands in flight at the same time, for devices which queue their input and answer the
+   * commands in order.
+   *
+   * Without pipelining, a command is only sent after the response to the previous one has been received, which limits
+   * the throughput to one command per round trip. The CommandPipeline instead sends each command immediately (up to
+   * depth commands in flight), and hands the responses to the requesters in the order in which the commands have been
+   * sent: each transfer gets a ticket when sending, and reads its response once all earlier tickets are done.
+   *
+   * Each transfer has its own deadline, which is the timeout after its command has been sent. If a transfer fails, the
+   * responses of the later transfers in flight can no longer be told apart, so they fail as well, in order, with an
+   * error naming the first failure. So do all transfers after that, until reset() is called, e.g. when the device is
+   * opened again.
+   */
+  class CommandPipeline {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param[in] depth Maximum number of commands in flight. The device's input queue must hold that many commands.
+     * @param[in] timeout Time a transfer waits for its response after the command has been sent.
+     */
+    CommandPipeline(size_t depth, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Send a command and read its response in order with the other transfers. Thread safe.
+     * @param[in] send Called without arguments to send the command. The calls are serialised.
+     * @param[in] read Called with the remaining time until the deadline (std::chrono::milliseconds) to read the
+     * response, once the responses to all earlier commands have been read. The calls are serialised.
+     * @throws ChimeraTK::runtime_error from send or read, or if an earlier transfer has failed.
+     */
+    template<typename Send, typename Read>
+    void transfer(Send&& send, Read&& read);
+
+    /**
+     * @brief Forget a failure, so transfers are possible again. Must not be called while transfers are in flight.
+     */
+    void reset();
+
+    [[nodiscard]] size_t getDepth() const noexcept { return _depth; }
+
+   protected:
+    size_t _depth;
+    std::chrono::milliseconds _timeout;
+
+    std::mutex _sendMutex;            //!< Held while getting a ticket and sending
+    std::mutex _mutex;                //!< Protects the members below
+    std::condition_variable _changed; //!< Notified whenever _nowServing increases
+    uint64_t _nextTicket{0};          //!< Ticket of the next command to be sent
+    uint64_t _nowServing{0};          //!< Ticket of the command whose response is read next
+    bool _hasFailed{false};
+    std::string _failure; //!< Message of the first failed transfer
+
+    /**
+     * @brief Called with _mutex held when the transfer with the current ticket is done.
+     * @param[in] failure The error message if the transfer has failed, nullptr otherwise.
+     */
+    void finishTurn(const char* failure);
+
+    [[noreturn]] void throwAfterFailure() const;
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename Send, typename Read>
+  void CommandPipeline::transfer(Send&& send, Read&& read) {
+    // Sending under the send lock keeps the order on the wire the same as the order of the tickets.
+    std::unique_lock<std::mutex> sendLock(_sendMutex);
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [&] { return _hasFailed or _nextTicket - _nowServing < _depth; });
+    if(_hasFailed) {
+      throwAfterFailure();
+    }
+    uint64_t ticket = _nextTicket++;
+    lock.unlock();
+
+    // The reading transfer may finish its turn while this one is sending.
+    Clock::time_point deadline;
+    try {
+      send();
+      deadline = Clock::now() + _timeout;
+      sendLock.unlock();
+    }
+    catch(const std::exception& e) {
+      // The earlier transfers are not affected, but this one will never get a response.
+      sendLock.unlock();
+      lock.lock();
+      _changed.wait(lock, [&] { return _nowServing == ticket; });
+      finishTurn(e.what());
+      throw;
+    }
+
+    lock.lock();
+    _changed.wait(lock, [&] { return _nowServing == ticket; });
+    if(_hasFailed) {
+      finishTurn(nullptr);
+      throwAfterFailure();
+    }
+    lock.unlock();
+
+    // Only one transfer is reading at any time, so the read does not need the lock.
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+    try {
+      read(std::max(remaining, std::chrono::milliseconds(0)));
+    }
+    catch(const std::exception& e) {
+      lock.lock();
+      finishTurn(e.what());
+      throw;
+    }
+    lock.lock();
+    finishTurn(nullptr);
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
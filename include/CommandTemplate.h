@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * A command pattern, parsed once into a sequence of literal segments and placeholders.
+   *
+   * Command patterns are inja templates, but in practice only use the tags {{x.i}}, {{csStart.i}}, {{csEnd.i}} and
+   * {{cs.i}}. For such patterns, rendering is a plain append of the literal segments and the provided values, without
+   * parsing the template or building an inja::json on every transfer. csStart and csEnd tags render empty, so they are
+   * dropped when compiling.
+   * Patterns using any other inja feature (statements, comments, expressions) are kept as they are and rendered with
+   * inja, so the output is identical for all valid patterns.
+   */
+  class CommandTemplate {
+   public:
+    CommandTemplate() = default;
+
+    /**
+     * @brief Parse the inja template.
+     * @param[in] injaTemplate The command pattern, or a checksum payload snippet of it.
+     * @param[in] errorMessageDetail Orienting details to include in the error messages of render().
+     */
+    CommandTemplate(std::string injaTemplate, std::string errorMessageDetail);
+
+    /**
+     * @brief Append the rendered template to output.
+     * @param[in,out] output The rendered template is appended to it. Pass a reused string to avoid allocations.
+     * @param[in] data Values for the {{x.i}} tags.
+     * @param[in] checksums Values for the {{cs.i}} tags.
+     * @throws ChimeraTK::runtime_error if a tag refers to a value which has not been provided, or if the inja render
+     * fails.
+     */
+    void renderInto(
+        std::string& output, const std::vector<std::string>& data, const std::vector<std::string>& checksums) const;
+
+    /**
+     * @brief Convenience version of renderInto() returning a new string.
+     */
+    [[nodiscard]] std::string render(
+        const std::vector<std::string>& data = {}, const std::vector<std::string>& checksums = {}) const;
+
+    /**
+     * @brief Whether the pattern has been compiled, or will be rendered by inja.
+     */
+    [[nodiscard]] bool isCompiled() const { return not _useInja; }
+
+    /**
+     * @brief Whether the template is compiled and has no {{x.i}} tags, so rendering does not depend on the data.
+     */
+    [[nodiscard]] bool isDataIndependent() const { return not _useInja and _maxDataIndex == noIndex; }
+
+    /**
+     * @brief The inja template this has been compiled from.
+     */
+    [[nodiscard]] const std::string& getInjaTemplate() const { return _injaTemplate; }
+
+   private:
+    static constexpr size_t noIndex = static_cast<size_t>(-1);
+
+    enum class SegmentType { LITERAL, DATA, CHECKSUM_POINT };
+
+    struct Segment {
+      SegmentType type;
+      std::string literal; //!< Only used by LITERAL
+      size_t index{0};     //!< The i in {{x.i}} or {{cs.i}}, not used by LITERAL
+    };
+
+    std::vector<Segment> _segments;
+    std::string _injaTemplate;
+    std::string _errorMessageDetail;
+    bool _useInja{false};
+    size_t _maxDataIndex{noIndex};     //!< Highest i in the {{x.i}} tags
+    size_t _maxChecksumIndex{noIndex}; //!< Highest i in the {{cs.i}} tags
+
+    [[noreturn]] void throwMissingValue(const std::string& key, size_t index) const;
+  };
+
+} // namespace ChimeraTK
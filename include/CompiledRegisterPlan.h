@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Checksum.h"
+#include "CommandBasedBackendRegisterInfo.h"
+#include "ResponseMatcher.h"
+
+#include <optional>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Everything about a register that accessors need for their transfers, built once and never modified afterwards.
+   *
+   * Compiling the response matchers (and their fallback regexes) and building the checksumers is expensive compared to
+   * the rest of an accessor's construction. The CommandBasedBackend therefore keeps one plan per register path and
+   * hands out shared references to it, instead of every accessor copying the register info and compiling its own.
+   * Being immutable, a plan can be used by any number of accessors in any thread without locking.
+   */
+  class CompiledRegisterPlan {
+   public:
+    /**
+     * @throws ChimeraTK::logic_error if the response patterns cannot be compiled.
+     */
+    explicit CompiledRegisterPlan(CommandBasedBackendRegisterInfo info);
+
+    const CommandBasedBackendRegisterInfo registerInfo;
+
+    // Only set up if the register has a read command
+    const ResponseMatcher readResponseMatcher;
+    const std::vector<Checksumer> readCommandChecksumers;
+    const std::vector<Checksumer> readResponseChecksumers;
+    /** Set for binary responses of a fixed number of bytes with a fixed layout, which are decoded without hex. */
+    const std::optional<ResponseMatcher::BinaryLayout> readBinaryLayout;
+
+    // Only set up if the register is writeable
+    const ResponseMatcher writeResponseMatcher;
+    const std::vector<Checksumer> writeCommandChecksumers;
+    const std::vector<Checksumer> writeResponseChecksumers;
+
+    /** Matches the lines the device sends on its own for this register. Only set if it has an unsolicitedPattern. */
+    const std::optional<ResponseMatcher> unsolicitedResponseMatcher;
+
+   private:
+    static std::optional<ResponseMatcher::BinaryLayout> makeReadBinaryLayout(
+        const CommandBasedBackendRegisterInfo& info, const ResponseMatcher& matcher);
+  };
+
+} // namespace ChimeraTK
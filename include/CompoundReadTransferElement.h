@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CompiledRegisterPlan.h"
+#include "RegisterReadTransferElement.h"
+
+#include <ChimeraTK/NDRegisterAccessor.h>
+
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class CommandBasedBackend;
+
+  /**
+   * How the device combines commands, from the map file metadata key compoundCommand.
+   */
+  struct CompoundCommandSettings {
+    std::string separator{";"};         //!< Between the commands
+    std::string responseSeparator{";"}; //!< Between the responses
+    size_t maxCommands{0};              //!< Maximum number of commands in a compound command, 0 for no limit
+    size_t maxLength{0};                //!< Maximum length of a compound command without delimiter, 0 for no limit
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Low level transfer element, which reads several registers with one compound command like "CMD1?;CMD2?" and splits
+   * the one line response like "1;2" into the responses to the single commands. Each part is parsed by the
+   * RegisterReadTransferElement of its register.
+   *
+   * Each mergeable read-only CommandBasedBackendRegisterAccessor has a CompoundReadTransferElement with only its own
+   * RegisterReadTransferElement as its hardware accessing element. When the accessors are added to a TransferGroup,
+   * their replaceTransferElement() moves the registers into the elements of the other accessors, so the TransferGroup
+   * reads the registers with as few compound commands as the CompoundCommandSettings allow.
+   *
+   * The last response takes the rest of the line. So a register whose response may contain the responseSeparator,
+   * i.e. with string values or with the separator in its response pattern, is only merged as the last one.
+   */
+  class CompoundReadTransferElement : public TransferElement {
+   public:
+    using RegisterRead = boost::shared_ptr<RegisterReadTransferElement>;
+
+    CompoundReadTransferElement(const CompoundCommandSettings& settings, RegisterRead registerRead);
+
+    /**
+     * @brief Whether a read interaction can be part of a compound command: it must have a constant command and a
+     * response of one text line.
+     */
+    [[nodiscard]] static bool isMergeable(const InteractionInfo& readInfo);
+
+    /**
+     * @brief Whether the register should move from its current element owner into this element.
+     * This is the case if both belong to the same backend, the register fits into this element (including that at most
+     * one response may contain the responseSeparator), and this element has at least as many registers as the owner. The latter makes the registers gather in one element, whatever the order
+     * in which the TransferGroup offers the elements.
+     */
+    [[nodiscard]] bool mayAdopt(
+        const CompoundReadTransferElement& owner, const RegisterReadTransferElement& registerRead) const;
+
+    /** The element of the register with the given plan, if it is part of this compound command. */
+    [[nodiscard]] RegisterRead find(const CompiledRegisterPlan& plan) const;
+
+    void add(RegisterRead registerRead);
+    void remove(const RegisterRead& registerRead);
+
+    [[nodiscard]] size_t getNumberOfRegisters() const { return _registers.size(); }
+
+    [[nodiscard]] bool isReadOnly() const override { return true; }
+
+    [[nodiscard]] bool isReadable() const override { return true; }
+
+    [[nodiscard]] bool isWriteable() const override { return false; }
+
+    [[nodiscard]] const std::type_info& getValueType() const override { return typeid(std::string); }
+
+    std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      return {TransferElement::shared_from_this()};
+    }
+
+    std::list<boost::shared_ptr<TransferElement>> getInternalElements() override { return {}; }
+
+    boost::shared_ptr<TransferElement> makeCopyRegisterDecorator() override {
+      throw ChimeraTK::logic_error("CompoundReadTransferElement::makeCopyRegisterDecorator() is not implemented");
+    }
+
+   protected:
+    void doReadTransferSynchronously() override;
+
+    /** Join the commands of the registers into _command. Called whenever the registers change. */
+    void updateCommand();
+
+    /**
+     * @brief Whether the response of the register may contain the responseSeparator, so it can only be the last part
+     * of the compound response. Such a register is kept at the end of _registers.
+     */
+    [[nodiscard]] bool mayContainSeparator(const RegisterReadTransferElement& registerRead) const;
+
+    [[nodiscard]] static const InteractionInfo& getReadInfo(const RegisterReadTransferElement& registerRead) {
+      return registerRead.getPlan()->registerInfo.readInfo;
+    }
+
+    boost::shared_ptr<CommandBasedBackend> _backend;
+    CompoundCommandSettings _settings;
+    std::vector<RegisterRead> _registers;
+
+    std::string _command;               //!< The compound command, without delimiter
+    std::vector<std::string> _response; //!< Reused by each transfer
+  };
+
+} // namespace ChimeraTK
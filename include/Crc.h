@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ChimeraTK {
+
+  /*
+   * CRC computations behind the checksum enums. All of them use slicing-by-8 tables, which process 8 bytes per table
+   * round instead of one. CRC32 and CRC32C additionally have hardware kernels (PCLMUL carry-less multiplication and the
+   * SSE4.2 crc32 instruction) which are used if the CPU supports them.
+   *
+   * Each function continues from the result of a previous call, so a payload can be processed in parts:
+   * crc32(b, crc32(a)) equals crc32 of a followed by b.
+   */
+
+  enum class CrcKernel { SLICING_BY_8, HARDWARE };
+
+  /**
+   * @brief CRC-CCITT, with polynomial 0x1021, initial value 0xFFFF, no reflection and no final XOR. "123456789" yields
+   * 0x29B1.
+   */
+  [[nodiscard]] uint16_t crcCcitt16(std::string_view bytes, uint16_t crc = 0xFFFF) noexcept;
+
+  /**
+   * @brief CRC-32 as used by Ethernet, zlib and PNG (reflected polynomial 0xEDB88320). "123456789" yields 0xCBF43926.
+   * @param[in] kernel HARDWARE falls back to SLICING_BY_8 if the CPU does not support it.
+   */
+  [[nodiscard]] uint32_t crc32(
+      std::string_view bytes, uint32_t crc = 0, CrcKernel kernel = CrcKernel::HARDWARE) noexcept;
+
+  /**
+   * @brief CRC-32C (Castagnoli, reflected polynomial 0x82F63B78) as used by iSCSI and SCTP. "123456789" yields
+   * 0xE3069283.
+   * @param[in] kernel HARDWARE falls back to SLICING_BY_8 if the CPU does not support it.
+   */
+  [[nodiscard]] uint32_t crc32c(
+      std::string_view bytes, uint32_t crc = 0, CrcKernel kernel = CrcKernel::HARDWARE) noexcept;
+
+} // namespace ChimeraTK
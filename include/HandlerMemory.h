@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace ChimeraTK {
+
+  /**
+   * Memory for the operations which Boost.Asio creates when a handler is posted, so posting from a thread which does
+   * not run the io_context does not allocate. Asio only recycles the memory of operations on the io_context's threads.
+   *
+   * There are a few fixed slots, which are handed out in any thread. Requests which do not fit into a free slot fall
+   * back to the global operator new.
+   *
+   * Usage:
+   * boost::asio::post(strand, HandlerWithMemory{memory, [] { ... }});
+   */
+  class HandlerMemory {
+   public:
+    /** Each post takes up to two slots (the operation, and the invoker of a strand which is not running yet). */
+    static constexpr size_t nSlots = 4;
+    static constexpr size_t slotSize = 256;
+
+    HandlerMemory() = default;
+    HandlerMemory(const HandlerMemory&) = delete;
+    HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+    void* allocate(size_t size) {
+      if(size <= slotSize) {
+        for(auto& slot : _slots) {
+          if(not slot.isInUse.exchange(true, std::memory_order_acquire)) {
+            return slot.storage.data();
+          }
+        }
+      }
+      return ::operator new(size);
+    }
+
+    void deallocate(void* pointer) noexcept {
+      for(auto& slot : _slots) {
+        if(pointer == slot.storage.data()) {
+          slot.isInUse.store(false, std::memory_order_release);
+          return;
+        }
+      }
+      ::operator delete(pointer);
+    }
+
+   private:
+    struct Slot {
+      alignas(std::max_align_t) std::array<std::byte, slotSize> storage;
+      std::atomic<bool> isInUse{false};
+    };
+    std::array<Slot, nSlots> _slots;
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Allocator for Boost.Asio, handing out the memory of a HandlerMemory.
+   */
+  template<typename T>
+  class HandlerMemoryAllocator {
+   public:
+    using value_type = T;
+
+    explicit HandlerMemoryAllocator(HandlerMemory& memory) noexcept : _memory(&memory) {}
+
+    template<typename U>
+    // NOLINTNEXTLINE(google-explicit-constructor) Allocators must convert implicitly.
+    HandlerMemoryAllocator(const HandlerMemoryAllocator<U>& other) noexcept : _memory(other._memory) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(_memory->allocate(sizeof(T) * n)); }
+    void deallocate(T* pointer, size_t) noexcept { _memory->deallocate(pointer); }
+
+    template<typename U>
+    bool operator==(const HandlerMemoryAllocator<U>& other) const noexcept {
+      return _memory == other._memory;
+    }
+    template<typename U>
+    bool operator!=(const HandlerMemoryAllocator<U>& other) const noexcept {
+      return _memory != other._memory;
+    }
+
+   private:
+    template<typename>
+    friend class HandlerMemoryAllocator;
+    HandlerMemory* _memory;
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Wraps a handler, so Boost.Asio allocates the memory of its operations from the HandlerMemory.
+   */
+  template<typename Handler>
+  class HandlerWithMemory {
+   public:
+    using allocator_type = HandlerMemoryAllocator<Handler>;
+
+    HandlerWithMemory(HandlerMemory& memory, Handler handler) : _memory(&memory), _handler(std::move(handler)) {}
+
+    allocator_type get_allocator() const noexcept { return allocator_type(*_memory); }
+
+    template<typename... Args>
+    void operator()(Args&&... args) {
+      _handler(std::forward<Args>(args)...);
+    }
+
+   private:
+    HandlerMemory* _memory;
+    Handler _handler;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+#include <boost/asio.hpp>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * @class IoReactor
+   * @brief A process-wide Boost.Asio io_context (epoll based on Linux) with a small pool of threads running it.
+   *
+   * All TcpSockets of all CommandBasedBackend instances share one IoReactor, so the number of threads does not grow with
+   * the number of devices. Each TcpSocket serialises its own operations through a strand, hence the pool can have more
+   * than one thread.
+   *
+   * The reactor is created on first use and stopped when the last user releases it.
+   */
+  class IoReactor {
+   public:
+    /** The number of threads used if nobody asks for more. */
+    static constexpr size_t defaultNumberOfThreads = 1;
+    /** Upper limit for the pool size. The threads only dispatch completions, so more would not help. */
+    static constexpr size_t maxNumberOfThreads = 16;
+
+    /**
+     * @brief Get the shared reactor, creating it if needed.
+     * @param[in] minNumberOfThreads The pool is grown to at least this many threads (capped at maxNumberOfThreads). The
+     * pool never shrinks while the reactor is in use.
+     */
+    static std::shared_ptr<IoReactor> getInstance(size_t minNumberOfThreads = defaultNumberOfThreads);
+
+    boost::asio::io_context& getIoContext() { return _ioContext; }
+
+    [[nodiscard]] size_t getNumberOfThreads() const;
+
+    /** @brief Returns true if called from one of the reactor's threads. */
+    [[nodiscard]] bool isReactorThread() const;
+
+    ~IoReactor();
+
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+   protected:
+    IoReactor() = default;
+
+    void growThreadPool(size_t numberOfThreads);
+
+    boost::asio::io_context _ioContext;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> _workGuard{
+        boost::asio::make_work_guard(_ioContext)}; //!< Keeps the threads running while there is nothing to do.
+
+    mutable std::mutex _threadsMutex;
+    std::vector<std::thread> _threads;
+  };
+
+} // namespace ChimeraTK
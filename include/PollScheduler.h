@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Polls registers periodically in a thread of the backend, so accessors with AccessMode::wait_for_new_data get their
+   * values pushed instead of each application thread polling synchronously.
+   *
+   * Each Subscription is polled at its own interval while the scheduler is active, i.e. between activate() and the next
+   * deactivate() or sendException(). Upon activation, all subscriptions are polled immediately to provide the initial
+   * values, as are subscriptions added while active. Subscriptions without interval are only polled then. The values
+   * are only pushed if the scheduler is still in the same activation after the poll, so after an exception no stale
+   * value reaches the accessors before the next activation.
+   *
+   * A Subscription which fails reports the error to the backend itself (through the exception backend of its
+   * accessor), which in turn calls sendException(). The thread is only started with the first subscription.
+   *
+   * The subscriptions refer to the backend through their accessors, so the backend, which owns the scheduler, outlives
+   * them. They must be unsubscribed when their accessor is destroyed.
+   */
+  class PollScheduler {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Interface of a polled register towards the scheduler.
+     */
+    class Subscription {
+     public:
+      virtual ~Subscription() = default;
+
+      /**
+       * @brief Read the register. Called from the poll thread without the scheduler's lock.
+       * @throws ChimeraTK::runtime_error if the transfer fails.
+       */
+      virtual void poll() = 0;
+
+      /** @brief Hand the value read by the last poll() to the accessor. Called with the scheduler's lock held. */
+      virtual void push() = 0;
+
+      /** @brief Hand an exception to the accessor. Called with the scheduler's lock held. */
+      virtual void sendException(const std::exception_ptr& e) noexcept = 0;
+    };
+
+    PollScheduler() = default;
+    ~PollScheduler();
+
+    PollScheduler(const PollScheduler&) = delete;
+    PollScheduler& operator=(const PollScheduler&) = delete;
+
+    /**
+     * @brief Poll the subscription every interval, starting immediately if the scheduler is active. Thread safe.
+     * @param[in] interval If not set, the subscription is only polled for the initial value, e.g. for registers whose
+     * values are pushed by the device otherwise.
+     */
+    void subscribe(std::shared_ptr<Subscription> subscription, std::optional<std::chrono::milliseconds> interval);
+
+    /**
+     * @brief Stop polling the subscription. Waits for a running poll of it to finish. Thread safe, but must not be
+     * called from the poll thread.
+     */
+    void unsubscribe(const Subscription* subscription);
+
+    /** @brief Start polling, with an immediate poll of all subscriptions for the initial values. Thread safe. */
+    void activate();
+
+    /**
+     * @brief Stop polling without sending exceptions, e.g. when the device is closed. Waits for a running poll to
+     * finish, unless called from the poll thread, so the transport layer may be torn down afterwards. Thread safe.
+     */
+    void deactivate();
+
+    /**
+     * @brief Stop polling and send the exception to all subscriptions, if the scheduler is active. Does not wait for
+     * a running poll, so it can be called from the backend's setException() in any thread.
+     */
+    void sendException(const std::exception_ptr& e);
+
+    [[nodiscard]] bool isActive() const;
+
+   protected:
+    struct Entry {
+      std::shared_ptr<Subscription> subscription;
+      std::optional<std::chrono::milliseconds> interval; //!< If not set, only the initial poll is done
+      Clock::time_point due;                             //!< Clock::time_point::max() after the initial poll then
+    };
+
+    /** Body of the poll thread */
+    void run();
+
+    mutable std::mutex _mutex;         //!< Protects the members below
+    std::condition_variable _wakeUp;   //!< Notified when the entries or the activation change
+    std::condition_variable _pollDone; //!< Notified when a poll has finished
+    std::vector<Entry> _entries;
+    bool _isActive{false};
+    uint64_t _activation{0}; //!< Incremented upon each activate(), so pushes after a deactivation are dropped
+    const Subscription* _polled{nullptr}; //!< The subscription which is being polled, if any
+    bool _stop{false};
+    std::thread _thread;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Called with the bytes of a response in the order and in the chunks in which they are received, so they can be
+   * processed (e.g. checksummed) before the response is complete. The views are only valid during the call.
+   */
+  using ReceiveObserver = std::function<void(std::string_view)>;
+
+  /**
+   * The ReceiveBuffer holds bytes that have been received from a device but not yet handed out to the caller.
+   *
+   * It is a single contiguous chunk of memory which is filled at the back and consumed from the front. Consumed space is
+   * reclaimed by moving the (usually short) unconsumed rest to the front, so the storage only grows if a single
+   * message is longer than the current capacity. All operations are binary safe, NUL bytes are ordinary data.
+   *
+   * Delimiter searches are incremental: bytes which have already been searched for a delimiter are not searched again,
+   * except for the last delimiter.size()-1 bytes, which might hold the beginning of a delimiter straddling two reads.
+   *
+   * Usage:
+   * auto space = buffer.prepare(256);
+   * buffer.commit(read(fd, space.data(), space.size()));
+   * if(auto pos = buffer.findDelimiter("\r\n")) { line = buffer.consume(*pos); buffer.discard(2); }
+   */
+  class ReceiveBuffer {
+   public:
+    static constexpr size_t defaultCapacity = 4096;
+
+    explicit ReceiveBuffer(size_t initialCapacity = defaultCapacity);
+
+    /**
+     * @brief Get writable space at the end of the buffered data. Use commit() to mark bytes as received.
+     * @param[in] minFree The minimum size of the returned span.
+     * @returns a span of at least minFree bytes, which stays valid until the next non-const call.
+     */
+    std::span<char> prepare(size_t minFree);
+
+    /**
+     * @brief Append nBytes from the span returned by the last prepare() call to the buffered data.
+     */
+    void commit(size_t nBytes) noexcept;
+
+    /**
+     * @brief Search the buffered data for the delimiter, starting where the last search with the same delimiter ended.
+     * @returns the position of the delimiter relative to the beginning of the buffered data, or nullopt if the
+     * delimiter has not been received yet.
+     */
+    std::optional<size_t> findDelimiter(const std::string& delimiter);
+
+    /**
+     * @brief Remove the first nBytes from the buffered data and return them as a string.
+     */
+    std::string consume(size_t nBytes);
+
+    /**
+     * @brief Like consume(), but into output, whose capacity is reused.
+     */
+    void consume(size_t nBytes, std::string& output);
+
+    /**
+     * @brief Remove the first nBytes from the buffered data without copying them.
+     */
+    void discard(size_t nBytes) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept { return _end - _begin; }
+    [[nodiscard]] bool empty() const noexcept { return _end == _begin; }
+    [[nodiscard]] std::string_view view() const noexcept { return {_storage.data() + _begin, size()}; }
+
+   protected:
+    std::vector<char> _storage;
+    size_t _begin{0}; // index of the first unconsumed byte
+    size_t _end{0};   // index after the last received byte
+
+    size_t _searchPosition{0}; // index where the next delimiter search starts
+    std::string _searchDelimiter;
+  }; // end ReceiveBuffer
+
+} // namespace ChimeraTK
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Checksum.h"
+#include "CompiledRegisterPlan.h"
+#include "ResponseMatcher.h"
+
+#include <ChimeraTK/NDRegisterAccessor.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class CommandBasedBackend;
+
+  /**
+   * Low level transfer element, which reads a register and parses the response: it matches the response pattern and
+   * checks the checksums, independent of the UserType.
+   *
+   * Each readable CommandBasedBackendRegisterAccessor reads through one of these, and converts its range of elements
+   * from the match in doPostRead(). Read-only accessors expose it as their hardware accessing element, so accessors to
+   * the same register in a TransferGroup share one element, see replaceTransferElement(). The register is then only
+   * transferred and parsed once, even if the accessors cover different element ranges.
+   */
+  class RegisterReadTransferElement : public TransferElement {
+   public:
+    /**
+     * @param[in] isRecoveryTestAccessor Skip the test whether the backend is functional, see
+     * CommandBasedBackendRegisterAccessor::_isRecoveryTestAccessor.
+     */
+    RegisterReadTransferElement(boost::shared_ptr<CommandBasedBackend> backend,
+        std::shared_ptr<const CompiledRegisterPlan> plan, bool isRecoveryTestAccessor = false);
+
+    [[nodiscard]] const std::shared_ptr<const CompiledRegisterPlan>& getPlan() const { return _plan; }
+
+    [[nodiscard]] const boost::shared_ptr<CommandBasedBackend>& getBackend() const { return _backend; }
+
+    /** The data, checksum payloads and checksums matched in the last response. Not used for block data. */
+    [[nodiscard]] const ResponseMatcher::Result& getMatch() const { return _responseMatch; }
+
+    /** The payload of the last block data response, see InteractionInfo::usesReadBlock(). */
+    [[nodiscard]] const std::string& getBlockPayload() const { return _readTransferBuffer[0]; }
+
+    /**
+     * @brief Parse a response line which has been received for this register by a CompoundReadTransferElement.
+     * @throws ChimeraTK::runtime_error if the line does not match the response pattern or a checksum fails.
+     */
+    void parseResponseLine(std::string_view line);
+
+    [[nodiscard]] bool isReadOnly() const override { return true; }
+
+    [[nodiscard]] bool isReadable() const override { return true; }
+
+    [[nodiscard]] bool isWriteable() const override { return false; }
+
+    [[nodiscard]] const std::type_info& getValueType() const override { return typeid(std::string); }
+
+    std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      return {TransferElement::shared_from_this()};
+    }
+
+    std::list<boost::shared_ptr<TransferElement>> getInternalElements() override { return {}; }
+
+    boost::shared_ptr<TransferElement> makeCopyRegisterDecorator() override {
+      throw ChimeraTK::logic_error("RegisterReadTransferElement::makeCopyRegisterDecorator() is not implemented");
+    }
+
+   protected:
+    void doReadTransferSynchronously() override;
+
+    /**
+     * Match the response in _readTransferBuffer and check its checksums, or check the size of block data.
+     * @throws ChimeraTK::runtime_error if the response is not valid.
+     */
+    void parseResponse();
+
+    /** The part of parseResponse() for responses with a CompiledRegisterPlan::readBinaryLayout */
+    void parseBinaryResponse();
+
+    boost::shared_ptr<CommandBasedBackend> _backend;
+    std::shared_ptr<const CompiledRegisterPlan> _plan;
+    const InteractionInfo& _readInfo; //!< Refers to _plan->registerInfo.readInfo
+    bool _isRecoveryTestAccessor;
+
+    std::vector<std::string> _readTransferBuffer;
+
+    // Reused between transfers, so repeated transfers do not allocate memory.
+    std::vector<std::string> _commandChecksums; //!< Values for the {{cs.i}} tags
+    std::string _readCommandBuffer;
+    std::string _hexCommandBuffer;       //!< Binary commands are rendered as hex into this, then decoded
+    std::string _combinedResponseBuffer; //!< See makeCombinedReadString()
+    std::string _checksumResultBuffer;
+    ResponseMatcher::Result _responseMatch;
+
+    /** Only set if the plan has a readBinaryLayout with checksums. Updated while the response is received. */
+    std::optional<IncrementalChecksums> _readResponseChecksums;
+  };
+
+  /********************************************************************************************************************/
+  // Shared with the write path of CommandBasedBackendRegisterAccessor
+
+  /**
+   * @brief Combine the response, which has been read line by line, back into a single string, reusing the capacity of
+   * combinedReadString. Binary responses are converted to hex.
+   */
+  void makeCombinedReadString(
+      const std::vector<std::string>& transferBuffer, const InteractionInfo& iInfo, std::string& combinedReadString);
+
+  /**
+   * @brief This computes the checksums on the checksum payloads extracted from the response, and compares them to the
+   * received checksums.
+   * @param[in] match The checksum payloads and checksums extracted by the ResponseMatcher.
+   * @param[in] iInfo The InteractionInfo correspondign to read/write
+   * @param[in] responseChecksumers The Checksumers to compute the checksums from the payloads.
+   * @param[in] interaction "read" or "write", for the error messages. They are only assembled if a check fails.
+   * @param[in] registerPath For the error messages.
+   * @param[out] checksumResult Buffer for the computed checksums, reused between calls.
+   * @throws ChimeraTK::runtime_error if a checksum is missing or does not match.
+   */
+  void inspectChecksum(const ResponseMatcher::Result& match, const InteractionInfo& iInfo,
+      const std::vector<Checksumer>& responseChecksumers, const char* interaction, const RegisterPath& registerPath,
+      std::string& checksumResult);
+
+} // namespace ChimeraTK
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "mapFileKeys.h"
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Matches a response against the responsePattern and extracts the data values, checksum payloads and checksums.
+   *
+   * Response patterns are inja templates rendering to a regex. Most of them are plain text with {{x.i}}, {{cs.i}},
+   * {{csStart.i}} and {{csEnd.i}} tags. Those are compiled into a sequence of literal segments and typed fields, which
+   * is matched in a single linear pass without backtracking, and extracts everything in that one pass.
+   *
+   * The compiled matcher is only used if it gives exactly the same result as the regexes: the literal segments must
+   * not contain regex syntax, and a variable width field must not be followed by another field or by a literal
+   * starting with a character the field could also consume. All other patterns use the std::regex fallback set with
+   * setFallbackRegexes().
+   *
+   * Inja statements, like a for loop over x, are rendered first, with each tag rendering to itself. If the result is
+   * such a plain pattern, it is compiled like one.
+   *
+   * A compiled pattern which is just a list of numeric values with the same separator between them, like the comma
+   * separated traces of SCPI devices, is matched by searching for the separators instead of stepping through the
+   * pattern element by element.
+   *
+   * As with the regexes, values are returned in the order of their appearance in the pattern, checksum payloads in the
+   * order of their {{csStart.i}} tags.
+   */
+  class ResponseMatcher {
+   public:
+    /**
+     * The extracted parts of a response. The views point into the matched input.
+     */
+    struct Result {
+      std::vector<std::string_view> data;
+      std::vector<std::string_view> checksumPayloads;
+      std::vector<std::string_view> checksums;
+    };
+
+    /**
+     * Byte offsets of the parts of a binary response with a fixed layout, see getBinaryLayout().
+     */
+    struct BinaryLayout {
+      struct Span {
+        size_t offset{0}; //!< In bytes from the start of the response
+        size_t length{0}; //!< In bytes
+      };
+      std::vector<std::pair<size_t, std::string>> literals; //!< Offset and expected bytes of the literal segments
+      std::vector<Span> data;
+      std::vector<Span> checksumPayloads;
+      std::vector<Span> checksums;
+      size_t nBytes{0}; //!< Total length of the response
+
+      /**
+       * @brief Match raw response bytes. Same as ResponseMatcher::match() on their hex representation, but the views
+       * in result point into the raw bytes.
+       */
+      bool match(std::string_view bytes, Result& result) const;
+    };
+
+    ResponseMatcher() = default;
+
+    /**
+     * @brief Try to compile the response pattern. Check isCompiled() whether the fallback regexes are needed.
+     * @param[in] responsePattern The inja response pattern.
+     * @param[in] type The transport layer type of the {{x.i}} values.
+     * @param[in] fixedCharacterWidth The fixed number of characters of the values, if any.
+     * @param[in] responseChecksums The checksum types, in the order of the {{cs.i}} index.
+     * @param[in] nElements The number of elements of the register, i.e. the number of available {{x.i}} values.
+     */
+    ResponseMatcher(const std::string& responsePattern, TransportLayerType type,
+        std::optional<size_t> fixedCharacterWidth, const std::vector<checksum>& responseChecksums, size_t nElements);
+
+    /**
+     * @brief Whether the pattern has been compiled. If not, setFallbackRegexes() must be called before match().
+     */
+    [[nodiscard]] bool isCompiled() const { return _isCompiled; }
+
+    /**
+     * @brief Whether the compiled pattern is a list of separated numeric values, which is split by its separators.
+     */
+    [[nodiscard]] bool isDelimitedList() const { return _delimitedList.has_value(); }
+
+    /**
+     * @brief Set the regexes used if the pattern could not be compiled.
+     * @param[in] dataRegex Captures the values.
+     * @param[in] checksumPayloadRegex Captures the checksum payloads.
+     * @param[in] checksumRegex Captures the checksums.
+     */
+    void setFallbackRegexes(std::regex dataRegex, std::regex checksumPayloadRegex, std::regex checksumRegex);
+
+    /**
+     * @brief Match the complete input against the pattern.
+     * @param[in] input The response.
+     * @param[out] result The extracted parts. Its vectors are reused to avoid allocations.
+     * @returns false if the input does not match the pattern.
+     */
+    bool match(std::string_view input, Result& result) const;
+
+    /**
+     * @brief Get the byte layout of a binary response, for decoding the received bytes without converting them to hex.
+     * Binary responses are matched in their hex representation. If every field of the compiled pattern has a fixed,
+     * even number of hex characters and all literals are upper case hex digits forming whole bytes, each part of the
+     * response is at a fixed byte offset.
+     * @returns nullopt if the pattern is not compiled or does not have such a fixed layout.
+     */
+    [[nodiscard]] std::optional<BinaryLayout> getBinaryLayout() const;
+
+   private:
+    enum class ElementType { LITERAL, VALUE, CHECKSUM, CHECKSUM_START, CHECKSUM_END };
+
+    enum class CharacterClass { DECIMAL_INT, HEX, DECIMAL_FLOAT, STRING };
+
+    struct Element {
+      ElementType type;
+      std::string literal;           //!< Only for LITERAL
+      CharacterClass characterClass; //!< Only for VALUE and CHECKSUM
+      size_t width{0};               //!< Fixed number of characters for VALUE and CHECKSUM, 0 means variable
+      size_t slot{0};                //!< Index in the Result vector for VALUE, CHECKSUM and CHECKSUM_START/END
+    };
+
+    /** A pattern of the form prefix, value, separator, value, ..., separator, value, suffix. */
+    struct DelimitedList {
+      std::string prefix;
+      std::string separator;
+      std::string suffix;
+      Element field; //!< The same for all values
+    };
+
+    bool _isCompiled{false};
+    std::vector<Element> _elements;
+    std::optional<DelimitedList> _delimitedList;
+    size_t _nData{0};
+    size_t _nChecksums{0};
+    size_t _nChecksumPayloads{0};
+
+    std::regex _dataRegex;
+    std::regex _checksumPayloadRegex;
+    std::regex _checksumRegex;
+
+    /** Parse the pattern into _elements. Returns false if it needs the regex fallback. */
+    bool compile(const std::string& responsePattern, TransportLayerType type, std::optional<size_t> fixedCharacterWidth,
+        const std::vector<checksum>& responseChecksums, size_t nElements);
+
+    /** Check that no variable width field can give up characters to what follows it. */
+    [[nodiscard]] bool isUnambiguous() const;
+
+    /** Returns the list form of the compiled _elements, if they have one. */
+    [[nodiscard]] std::optional<DelimitedList> findDelimitedList() const;
+
+    /** Returns the end position of the field starting at pos, or npos if it does not match. */
+    static size_t matchField(std::string_view input, size_t pos, const Element& field);
+
+    bool matchCompiled(std::string_view input, Result& result) const;
+    bool matchDelimitedList(std::string_view input, Result& result) const;
+    bool matchRegex(std::string_view input, Result& result) const;
+  };
+
+} // namespace ChimeraTK
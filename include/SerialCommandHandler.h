@@ -8,6 +8,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -21,9 +22,11 @@ class SerialCommandHandler : public CommandHandler {
    * @param[in] device The address of the serial device, such as /tmp/virtual-tty
    * @param[in] delimiter Sets the default line delimiter seperating serial communication messages.
    * @param[in] timeoutInMilliseconds The timeout duration in ms
+   * @param[in] settings The serial line settings: baud rate, data bits, parity, stop bits and flow control.
    */
   explicit SerialCommandHandler(const std::string& device,
-      const std::string& delimiter = ChimeraTK::SERIAL_DEFAULT_DELIMITER, ulong timeoutInMilliseconds = 1000);
+      const std::string& delimiter = ChimeraTK::SERIAL_DEFAULT_DELIMITER, ulong timeoutInMilliseconds = 1000,
+      const ChimeraTK::SerialPortSettings& settings = {});
 
   ~SerialCommandHandler() override = default;
 
@@ -38,11 +41,29 @@ class SerialCommandHandler : public CommandHandler {
   [[nodiscard]] std::string waitAndReadline(const Delimiter& delimiter = CommandHandlerDefaultDelimiter{}) const;
 
  protected:
-  std::vector<std::string> sendCommandAndReadLinesImpl(
-      std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) override;
+  void sendCommandAndReadLinesImpl(std::string_view cmd, size_t nLinesToRead, const Delimiter& writeDelimiter,
+      const Delimiter& readDelimiter, std::vector<std::string>& lines) override;
 
-  std::string sendCommandAndReadBytesImpl(
-      std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) override;
+  void sendCommandAndReadBytesImpl(std::string_view cmd, size_t nBytesToRead, const Delimiter& writeDelimiter,
+      const ChimeraTK::ReceiveObserver& onReceive, std::string& bytes) override;
+
+  std::string sendCommandAndReadBlockImpl(std::string_view cmd, size_t nBytesExpected,
+      const Delimiter& writeDelimiter, const std::string& terminator) override;
+
+  void sendCommandImpl(std::string_view cmd, const Delimiter& writeDelimiter) override;
+
+  void readLinesImpl(size_t nLinesToRead, const Delimiter& readDelimiter, std::vector<std::string>& lines,
+      std::chrono::milliseconds readTimeout) override;
+
+  void readBytesImpl(size_t nBytesToRead, std::string& bytes, std::chrono::milliseconds readTimeout,
+      const ChimeraTK::ReceiveObserver& onReceive) override;
+
+  std::string readBlockImpl(
+      size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) override;
+
+  bool readLineImpl(std::string& line, std::chrono::milliseconds readTimeout) override;
+
+  bool waitForInputImpl(std::chrono::milliseconds timeout) override;
 
   /**
    * The SerialPort handle
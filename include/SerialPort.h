@@ -2,6 +2,10 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "ReceiveBuffer.h"
+
+#include <sys/types.h>
+
 #include <atomic>
 #include <chrono>
 #include <optional>
@@ -11,6 +15,30 @@
 namespace ChimeraTK {
 
   const std::string SERIAL_DEFAULT_DELIMITER = "\r\n";
+
+  /**
+   * The line settings of a serial port. The defaults are 9600 baud, 8N1 without flow control.
+   */
+  struct SerialPortSettings {
+    enum class Parity { NONE, EVEN, ODD };
+    enum class FlowControl { NONE, RTS_CTS, XON_XOFF };
+
+    /** Any positive rate. Rates without a Bxxx constant are set through termios2/BOTHER. */
+    unsigned int baudRate = 9600;
+    unsigned int dataBits = 8; /**< 5 to 8 */
+    unsigned int stopBits = 1; /**< 1 or 2 */
+    Parity parity = Parity::NONE;
+    FlowControl flowControl = FlowControl::NONE;
+
+    /**
+     * @brief Check that the settings can be expressed by termios.
+     * @throws ChimeraTK::logic_error if a setting is out of range.
+     */
+    void validate() const;
+
+    /** Human readable form, like "115200 8N1 RTS/CTS". */
+    [[nodiscard]] std::string toString() const;
+  };
   /**
    * The SerialPort class handles, opens, closes, and
    * gives read/write access to a specified serial port.
@@ -24,18 +52,15 @@ namespace ChimeraTK {
     /**
      * Sets-up a bidirectional serial port, and flushes the port.
      *
-     * Port settings:
-     *  Baud rate = B9600
-     *  No parity checking (~PARENB)
-     *  Singe stop bit (~CSTOPB)
-     *  8-bit character size (CS8)
-     *  Ignore ctrl lines
+     * Port settings are taken from the settings parameter (default 9600 8N1, no flow control).
+     * The port is always set to non-canonical (raw) mode and ignores modem ctrl lines.
      *
      * @param[in] device The serial port address of the device, such as /tmp/virtual-tty
-     * @param[in] delmimiter The line delimiter seperating serial port messages.
-     * @throws ChimeraTK::runtime_error
+     * @param[in] settings Baud rate, character size, parity, stop bits and flow control.
+     * @throws ChimeraTK::logic_error if the settings are invalid.
+     * @throws ChimeraTK::runtime_error if the port cannot be opened or does not accept the settings.
      */
-    explicit SerialPort(const std::string& device);
+    explicit SerialPort(const std::string& device, const SerialPortSettings& settings = {});
 
     /**
      * Closes the port.
@@ -58,7 +83,7 @@ namespace ChimeraTK {
 
     /**
      * @brief Read a the specified number of bytes from the serial port, formatted as a string.
-     * The return string will not be null-terminated.
+     * The return string will not be null-terminated. Bytes already received by a previous readline are returned first.
      * @param[in] nBytesToRead The number of bytes that it will attempt to read.
      * @returns an empty optional if terminateRead() has been called.
      */
@@ -70,40 +95,125 @@ namespace ChimeraTK {
      * @param[in] delimiter The line delimiter
      * @return The response as a sting
      * @throws ChimeraTK::runtime_error if timeout exceeded.
+     * The wait happens in the calling thread. Data received before a timeout is kept for the next read.
      */
     std::string readlineWithTimeout(
         const std::chrono::milliseconds& timeout, const std::string& delimiter = SERIAL_DEFAULT_DELIMITER);
 
+    /**
+     * @brief Like readlineWithTimeout() above, but into line, whose capacity is reused.
+     */
+    void readlineWithTimeout(
+        const std::chrono::milliseconds& timeout, const std::string& delimiter, std::string& line);
+
+    /**
+     * @brief Like readlineWithTimeout(), but a timeout is not an error, e.g. while waiting for lines the device only
+     * sends now and then.
+     * @returns false if no line has arrived within the timeout.
+     * @throws ChimeraTK::runtime_error if the other end has hung up or the port reports read errors, or if the read
+     * has been terminated.
+     */
+    bool tryReadlineWithTimeout(
+        const std::chrono::milliseconds& timeout, const std::string& delimiter, std::string& line);
+
     /**
      * @brief Read a the specified number of bytes from the serial port, formatted as a string that will not be
      * null-terminated.
      * @param[in] nBytesToRead The number of bytes that it will attempt to read.
      * @param[in] timeout the timeout in milliseconds
+     * @param[in] onReceive If set, called with the bytes of the response as they arrive.
      * @return The response as a sting
      * @throws ChimeraTK::runtime_error if timeout exceeded.
      */
-    std::string readBytesWithTimeout(size_t nBytesToRead, const std::chrono::milliseconds& timeout);
+    std::string readBytesWithTimeout(
+        size_t nBytesToRead, const std::chrono::milliseconds& timeout, const ReceiveObserver& onReceive = {});
 
     /**
-     * Terminate a blocking read call.
+     * @brief Like readBytesWithTimeout() above, but into bytes, whose capacity is reused.
+     */
+    void readBytesWithTimeout(size_t nBytesToRead, const std::chrono::milliseconds& timeout, std::string& bytes,
+        const ReceiveObserver& onReceive = {});
+
+    /**
+     * @brief Wait until the port has bytes to read, without reading them. Unlike the read functions, this may be called
+     * concurrently with a read in another thread, as it does not touch the receive buffer.
+     * @returns Whether bytes are pending, or the port reports a hangup or an error.
+     */
+    bool waitForPendingInput(const std::chrono::milliseconds& timeout) const noexcept;
+
+    /**
+     * Terminate a blocking read call. This is safe to call from another thread; it wakes up the waiting read
+     * immediately.
      */
     void terminateRead();
 
    protected:
+    using Clock = std::chrono::steady_clock;
+
+    enum class WaitResult { READY, TERMINATED, TIMED_OUT };
+
+    /**
+     * @brief Block until the port has data to read, terminateRead() has been called or the deadline has passed,
+     * without consuming CPU while idle.
+     * @param[in] deadline Point in time after which the wait gives up. No deadline means wait forever.
+     */
+    WaitResult waitForInput(const std::optional<Clock::time_point>& deadline) noexcept;
+
+    /**
+     * @brief Common implementation of readline() and readlineWithTimeout(). All waiting happens in the calling thread.
+     * @param[out] waitResult Tells why false has been returned.
+     * @param[out] line The line without the delimiter. Only written if true is returned.
+     */
+    bool readlineUntil(const std::string& delimiter, const std::optional<Clock::time_point>& deadline,
+        WaitResult& waitResult, std::string& line) noexcept;
+
+    /**
+     * @brief Common implementation of readBytes() and readBytesWithTimeout(). All waiting happens in the calling
+     * thread.
+     * @param[out] waitResult Tells why false has been returned.
+     * @param[out] bytes The bytes read. Only written if true is returned.
+     * @param[in] onReceive If set, called with the bytes of the response as they arrive.
+     * @throws ChimeraTK::runtime_error on read errors.
+     */
+    bool readBytesUntil(size_t nBytesToRead, const std::optional<Clock::time_point>& deadline, WaitResult& waitResult,
+        std::string& bytes, const ReceiveObserver& onReceive = {});
+
+    /**
+     * @brief Read whatever is available on the port into the receive buffer. Updates _hasHungUp.
+     * @returns the return value of read(), errno is left untouched.
+     */
+    ssize_t receive() noexcept;
+
+    /**
+     * @brief Reset the terminate request, so a new read can be started.
+     */
+    void clearTerminateRead() noexcept;
+
     /**
      * The serial port handle.
      */
     int _fileDescriptor;
 
     /**
-     * Carries-over the not returned data from readline() call to the next.
+     * An eventfd which is signalled by terminateRead() to wake up a read waiting in poll().
      */
-    std::string _persistentBufferStr;
+    int _wakeupFileDescriptor;
+
+    /**
+     * Carries-over the not returned data from one read call to the next.
+     */
+    ReceiveBuffer _receiveBuffer;
 
     /**
      * Setting this to true using the terminateRead() function interrupts readline().
      */
     std::atomic_bool _terminateRead{false};
+
+    /**
+     * Set when the port reports a hangup or a read error, cleared when data arrives again. Timeouts of
+     * tryReadlineWithTimeout() are errors then. Only used by the reading thread.
+     */
+    bool _hasHungUp{false};
   }; // end SerialPort
 
 } // namespace ChimeraTK
@@ -4,10 +4,13 @@
 #include "CommandHandler.h"
 #include "TcpSocket.h"
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ChimeraTK {
@@ -23,17 +26,56 @@ namespace ChimeraTK {
      * @param[in] port
      * @param[in] delimiter Sets the line default line delimiter. This can be overridden on a per-command basis.
      * @param[in] timeoutInMilliseconds The timeout duration in ms.
+     * @param[in] nIoThreads Minimum number of threads of the process-wide IoReactor serving all TCP connections.
      */
     TcpCommandHandler(const std::string& host, const std::string& port,
-        const std::string& delimiter = ChimeraTK::TCP_DEFAULT_DELIMITER, ulong timeoutInMilliseconds = 1000);
+        const std::string& delimiter = ChimeraTK::TCP_DEFAULT_DELIMITER, ulong timeoutInMilliseconds = 1000,
+        size_t nIoThreads = IoReactor::defaultNumberOfThreads);
 
    protected:
-    std::vector<std::string> sendCommandAndReadLinesImpl(
-        std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) override;
+    void sendCommandAndReadLinesImpl(std::string_view cmd, size_t nLinesToRead, const Delimiter& writeDelimiter,
+        const Delimiter& readDelimiter, std::vector<std::string>& lines) override;
 
-    std::string sendCommandAndReadBytesImpl(
-        std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) override;
+    void sendCommandAndReadBytesImpl(std::string_view cmd, size_t nBytesToRead, const Delimiter& writeDelimiter,
+        const ReceiveObserver& onReceive, std::string& bytes) override;
 
+    std::string sendCommandAndReadBlockImpl(std::string_view cmd, size_t nBytesExpected,
+        const Delimiter& writeDelimiter, const std::string& terminator) override;
+
+    void sendCommandImpl(std::string_view cmd, const Delimiter& writeDelimiter) override;
+
+    void readLinesImpl(size_t nLinesToRead, const Delimiter& readDelimiter, std::vector<std::string>& lines,
+        std::chrono::milliseconds readTimeout) override;
+
+    void readBytesImpl(size_t nBytesToRead, std::string& bytes, std::chrono::milliseconds readTimeout,
+        const ReceiveObserver& onReceive) override;
+
+    std::string readBlockImpl(
+        size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) override;
+
+    bool readLineImpl(std::string& line, std::chrono::milliseconds readTimeout) override;
+
+    bool waitForInputImpl(std::chrono::milliseconds timeout) override;
+
+    /**
+     * @brief Post the command with the write delimiter to the socket's reactor without waiting, so the send overlaps
+     * with setting up the read. The command is sent from the reused send buffer, see appendWriteDelimiter(). Each
+     * postSend() must be followed by throwIfSendFailed(), also if the read fails, before the send buffer is used again.
+     */
+    void postSend(std::string_view cmd, const Delimiter& writeDelimiter);
+
+    /**
+     * @brief Wait for the send posted by postSend() to complete.
+     * @throws ChimeraTK::runtime_error if the send failed.
+     */
+    void throwIfSendFailed();
+
+    /** Result of the send posted by postSend(), set on a reactor thread. Reused, unlike a std::promise per send. */
+    std::optional<boost::system::error_code> _sendResult;
+    std::mutex _sendResultMutex;
+    std::condition_variable _sendCompleted;
+
+    // Destroyed first, which waits for the handler of a pending send to set the _sendResult.
     std::unique_ptr<TcpSocket> _tcpDevice;
   };
 
@@ -1,11 +1,18 @@
 // SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
+#include "HandlerMemory.h"
+#include "IoReactor.h"
+#include "ReceiveBuffer.h"
+
 #include <boost/asio.hpp>
 
 #include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 namespace ChimeraTK {
@@ -20,17 +27,27 @@ namespace ChimeraTK {
    *
    * This class provides functionality for establishing a TCP connection, sending commands,
    * and reading responses with support for timeout and delimiter-based communication.
+   *
+   * All socket operations run on the process-wide IoReactor, serialised by a strand per socket. The async* functions
+   * post an operation to the reactor and return immediately, the handler is called on a reactor thread on completion.
+   * The synchronous functions are thin wrappers which post the corresponding async operation and wait for it. Apart
+   * from the data they return, they do not allocate memory in the calling thread.
    */
   class TcpSocket {
    public:
+    /** Completion handler for reads. The string holds the data read, and is empty if the error code is set. */
+    using ReadHandler = std::function<void(const boost::system::error_code&, std::string)>;
+    /** Completion handler for sends. */
+    using SendHandler = std::function<void(const boost::system::error_code&)>;
+
     /**
-     * @brief Constructor to initialize the TCP socket.
+     * @brief Constructor to initialize the TCP socket and register it with the shared reactor.
      *
      * @param[in] host The remote host address to connect to.
      * @param[in] port The remote port to connect to.
-     * @param[in] timeoutInMilliseconds Timeout duration for read/write operations, in milliseconds.
+     * @param[in] nIoThreads Minimum number of threads of the shared reactor, see IoReactor::getInstance().
      */
-    TcpSocket(std::string host, std::string port);
+    TcpSocket(std::string host, std::string port, size_t nIoThreads = IoReactor::defaultNumberOfThreads);
 
     /**
      * @brief Sends a command to the connected remote host.
@@ -47,20 +64,62 @@ namespace ChimeraTK {
      * Reads data from the socket until the configured delimiter is encountered.
      * @param[in] timeout the timeout in milliseconds
      * @param[in] delimiter The line delimiter string.
-     * @return The response as a string.
+     * @return The response as a string, without the delimiter.
      * @throws ChimeraTK::runtime_error If the socket is not connected or the read operation fails.
      */
     std::string readlineWithTimeout(
         const std::chrono::milliseconds& timeout, const std::string& delimiter = TCP_DEFAULT_DELIMITER);
 
+    /**
+     * @brief Like readlineWithTimeout(), but a timeout is not an error, e.g. while waiting for lines the remote host
+     * only sends now and then.
+     * @return The line without the delimiter, or std::nullopt if no line has arrived within the timeout.
+     * @throws ChimeraTK::runtime_error If the socket is not connected or the read operation fails otherwise.
+     */
+    std::optional<std::string> tryReadlineWithTimeout(
+        const std::chrono::milliseconds& timeout, const std::string& delimiter = TCP_DEFAULT_DELIMITER);
+
     /**
      * @brief Read a the specified number of bytes from the remote host, return-formatted as a string that will not be
      * null-terminated.
      * @param[in] nBytesToRead The number of bytes that it will attempt to read.
      * @param[in] timeout the timeout in milliseconds
+     * @param[in] onReceive If set, called with the bytes of the response as they arrive, on a reactor thread.
      * @return The response as a string.
      * @throws ChimeraTK::runtime_error if timeout exceeded.     */
-    std::string readBytesWithTimeout(size_t nBytesToRead, const std::chrono::milliseconds& timeout);
+    std::string readBytesWithTimeout(
+        size_t nBytesToRead, const std::chrono::milliseconds& timeout, const ReceiveObserver& onReceive = {});
+
+    /**
+     * @brief Wait until the remote host has sent bytes which the socket has not received yet, without receiving them.
+     * Unlike the other functions, it does not run on the reactor, so it can be called while a read is in progress. It
+     * must not be called concurrently with connect() or disconnect().
+     * @returns Whether bytes are pending, or the connection has been closed or reports an error.
+     */
+    bool waitForPendingInput(const std::chrono::milliseconds& timeout) noexcept;
+
+    /**
+     * @brief Asynchronously send command. The handler is called on the strand once all bytes are written.
+     */
+    void asyncSend(std::string command, SendHandler handler);
+
+    /**
+     * @brief Like asyncSend(), but without copying the command. It must stay unchanged until the handler has been
+     * called.
+     */
+    void asyncSendFrom(const std::string& command, SendHandler handler);
+
+    /**
+     * @brief Asynchronously read a delimited line. On timeout, the handler gets boost::asio::error::timed_out.
+     */
+    void asyncReadline(std::string delimiter, std::chrono::milliseconds timeout, ReadHandler handler);
+
+    /**
+     * @brief Asynchronously read nBytesToRead bytes. On timeout, the handler gets boost::asio::error::timed_out.
+     * If set, onReceive is called on the strand with the bytes as they arrive, before the handler.
+     */
+    void asyncReadBytes(size_t nBytesToRead, std::chrono::milliseconds timeout, ReadHandler handler,
+        ReceiveObserver onReceive = {});
 
     /**
      * @brief Establishes a connection to the specified host and port.
@@ -81,13 +140,17 @@ namespace ChimeraTK {
     /**
      * @brief Destructor for the TcpSocket.
      *
-     * Ensures the socket is properly closed if still open.
+     * Ensures the socket is properly closed if still open, and waits until no operation of this socket is left on the
+     * reactor.
      */
     ~TcpSocket();
 
    private:
-    boost::asio::io_context _io_context;                //!< Boost.Asio I/O context for asynchronous operations.
-    std::condition_variable _ioContextStoppedCondition; //!< For synchronization management of io_context state
+    /** Memory for posting to the strand from other threads. Declared first, as operations may use it until the end. */
+    HandlerMemory _handlerMemory;
+    std::shared_ptr<IoReactor> _reactor; //!< The shared reactor running all asynchronous operations.
+    boost::asio::strand<boost::asio::io_context::executor_type>
+        _strand; //!< Serialises the operations of this socket on the reactor's threads.
 
     boost::asio::ip::tcp::socket _socket; //!< TCP socket used for communication.
 
@@ -97,12 +160,61 @@ namespace ChimeraTK {
     std::atomic<bool> _opened{false};         //!< Indicates whether the socket is currently open.
 
     /**
-     * @brief A common underlying read function used by readBytesWithTimeout and readlineWithTimeout.
+     * Receive buffer persisting over reads. Reads may receive more than requested, e.g. the start of the next line
+     * after a delimiter. Those bytes are kept here and used up first by the next read.
+     * Only accessed on the strand.
+     */
+    boost::asio::streambuf _receiveBuffer;
+
+    /** Set by disconnect(), so cancelled sends are not resumed. Only accessed on the strand after connect(). */
+    bool _isDisconnecting{false};
+
+    /** Number of posted sends and reads whose handler has not finished yet. The destructor waits for zero. */
+    size_t _pendingOperations{0};
+    std::mutex _pendingOperationsMutex;
+    std::condition_variable _pendingOperationsCondition;
+
+    /**
+     * @brief Count an operation as pending until the returned wrapper of handler has been called.
+     */
+    template<typename Handler>
+    auto trackOperation(Handler handler);
+
+    /**
+     * @brief A common underlying read function used by asyncReadBytes and asyncReadline.
+     * Reads into _receiveBuffer and cancels the read if the timeout expires first.
      * @param[in] timeout the timeout in milliseconds
      * @param[in] asyncReadFn A lambda wrapping the async read function to be used.
-     * @throws ChimeraTK::runtime_error if timeout exceeded.
+     * @param[in] onReadFinish Called on the strand with the error code and bytesTransferred reported by the
+     * async read function. The error code is boost::asio::error::timed_out on timeout.
+     */
+    void asyncReadWithTimeout(const std::chrono::milliseconds& timeout, AsyncReadFn asyncReadFn,
+        std::function<void(const boost::system::error_code&, std::size_t)> onReadFinish);
+
+    /**
+     * @brief Post the handler to the strand, using the _handlerMemory.
+     */
+    template<typename Handler>
+    void postToStrand(Handler handler);
+
+    /**
+     * @brief Post an operation to the reactor and wait for its completion.
+     * @param[in] operation Name of the operation for the error message.
+     * @throws ChimeraTK::runtime_error with the error reported by the operation.
+     */
+    template<typename ResultType, typename AsyncOperation>
+    ResultType waitFor(const char* operation, AsyncOperation&& asyncOperation);
+
+    /**
+     * @brief Write the bytes of buffer from offset on, on the strand. Resumes if a read timeout has cancelled the write.
+     * The buffer must stay unchanged until the handler has been called.
+     */
+    void asyncWriteFrom(const std::string& buffer, size_t offset, SendHandler handler);
+
+    /**
+     * @brief Remove nBytesToConsume from the front of the receive buffer, returning the first nBytesToReturn of them.
      */
-    std::string readWithTimeout(const std::chrono::milliseconds& timeout, const AsyncReadFn& asyncReadFn);
+    std::string extractFromReceiveBuffer(size_t nBytesToReturn, size_t nBytesToConsume);
   };
 
 } // namespace ChimeraTK
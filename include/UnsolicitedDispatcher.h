@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CompiledRegisterPlan.h"
+#include "ResponseMatcher.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Routes lines which the device sends on its own, like events or streamed measurements, to the accessors with
+   * AccessMode::wait_for_new_data of the registers with an unsolicitedPattern.
+   *
+   * The CommandHandler hands every line it reads to dispatch(), see CommandHandler::setUnsolicitedLineHandler(). A line
+   * matching the pattern of a register is consumed, whether the register has subscribers or not, so it never ends up as
+   * the response to a command. Between commands, the lines are picked up by the listener thread, see startListening().
+   *
+   * Like the PollScheduler, values are only pushed while the dispatcher is active, i.e. between activate() and the next
+   * deactivate() or sendException(). Lines arriving while inactive are consumed and dropped.
+   */
+  class UnsolicitedDispatcher {
+   public:
+    /**
+     * How long the listener waits for the device in each turn. It waits without holding the transport layer, and only
+     * holds it for up to listenTimeout while the bytes of a line are arriving, which is the most a command is delayed.
+     */
+    static constexpr std::chrono::milliseconds listenTimeout{10};
+
+    /** Pause of the listener between turns, so commands get the transport layer. */
+    static constexpr std::chrono::milliseconds listenPause{10};
+
+    /**
+     * Interface of an accessor towards the dispatcher.
+     */
+    class Subscription {
+     public:
+      virtual ~Subscription() = default;
+
+      /**
+       * @brief Hand the values of a matching line to the accessor. Called with the dispatcher's lock held.
+       * @param[in] match The views point into the line and are only valid during the call.
+       */
+      virtual void push(const ResponseMatcher::Result& match) = 0;
+
+      /** @brief Hand an exception to the accessor. Called with the dispatcher's lock held. */
+      virtual void sendException(const std::exception_ptr& e) noexcept = 0;
+    };
+
+    UnsolicitedDispatcher() = default;
+    ~UnsolicitedDispatcher();
+
+    UnsolicitedDispatcher(const UnsolicitedDispatcher&) = delete;
+    UnsolicitedDispatcher& operator=(const UnsolicitedDispatcher&) = delete;
+
+    /**
+     * @brief Recognise the lines of the register from now on. Adding the same plan again has no effect. Thread safe.
+     * @param[in] plan Must have an unsolicitedResponseMatcher.
+     */
+    void addRegister(std::shared_ptr<const CompiledRegisterPlan> plan);
+
+    /** @brief Push the values of the register's lines to the subscription. Adds the register if needed. Thread safe. */
+    void subscribe(std::shared_ptr<const CompiledRegisterPlan> plan, std::shared_ptr<Subscription> subscription);
+
+    /** @brief Stop pushing to the subscription. Thread safe. */
+    void unsubscribe(const Subscription* subscription);
+
+    /**
+     * @brief Match the line against the patterns of all registers and push the values to the subscribers if active.
+     * @returns true if the line matched, i.e. it has been consumed.
+     */
+    bool dispatch(std::string_view line);
+
+    /** @brief Start pushing values. Thread safe. */
+    void activate();
+
+    /** @brief Stop pushing values without sending exceptions, e.g. when the device is closed. Thread safe. */
+    void deactivate();
+
+    /** @brief Stop pushing values and send the exception to all subscriptions, if the dispatcher is active. */
+    void sendException(const std::exception_ptr& e);
+
+    [[nodiscard]] bool isActive() const;
+
+    /**
+     * @brief Start the listener thread, which calls listen() in turns while the dispatcher is active. Each call should
+     * wait for the device up to listenTimeout, see CommandHandler::waitForInput(), and then read at most one line, which
+     * reaches dispatch() through the CommandHandler, see CommandHandler::readUnsolicitedLine(). listen() must report
+     * transfer errors itself, e.g. through the backend's setException(), which deactivates the dispatcher through
+     * sendException(). Has no effect if the listener is running.
+     */
+    void startListening(std::function<void()> listen);
+
+    /** @brief Stop the listener thread and wait for it. Must be called before the transport layer is torn down. */
+    void stopListening();
+
+   protected:
+    struct Entry {
+      std::shared_ptr<const CompiledRegisterPlan> plan;
+      std::vector<std::shared_ptr<Subscription>> subscriptions;
+    };
+
+    /** Body of the listener thread */
+    void listen();
+
+    mutable std::mutex _mutex;       //!< Protects the members below
+    std::condition_variable _wakeUp; //!< Notified when the activation changes or the listener shall stop
+    std::vector<Entry> _entries;
+    ResponseMatcher::Result _match; //!< Reused between dispatches
+    bool _isActive{false};
+    bool _stopListening{false};
+    std::function<void()> _listen;
+    std::thread _listener;
+  };
+
+} // namespace ChimeraTK
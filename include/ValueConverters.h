@@ -0,0 +1,348 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CommandBasedBackendRegisterInfo.h"
+#include "stringUtils.h"
+
+#include <ChimeraTK/Exception.h>
+#include <ChimeraTK/SupportedUserTypes.h>
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+/*
+ * Conversions of single values between the UserType and their transport layer representation.
+ *
+ * Each converter is a small struct, specialised at compile time on the UserType and on the properties of the transport
+ * layer which change the conversion, like the signedness. Remaining parameters, like a fixed width, are members.
+ * An accessor selects the alternative of a ReadConverter, BinaryReadConverter or WriteConverter once when it is
+ * constructed, and visits it once per transfer with the loop over the elements inside. The conversion of each element
+ * is then a direct call, which the compiler can inline into the loop.
+ *
+ * Alternatives which do not apply to a UserType, e.g. a hex reader for strings, are never selected. As std::visit
+ * instantiates all of them, their call operators still compile for every UserType and use the string conversion.
+ */
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+  // Readers from the text of a value in the response
+
+  /**
+   * Through ChimeraTK::userTypeToUserType. For strings, booleans, and decimal floats into integers, which it rounds.
+   */
+  template<typename UserType>
+  struct StringReader {
+    UserType operator()(std::string_view text) const {
+      return ChimeraTK::userTypeToUserType<UserType, std::string>(std::string(text));
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Decimal text parsed with std::from_chars. Values out of range keep the clamping behaviour of the string conversion.
+   */
+  template<typename UserType>
+  struct DecimalReader {
+    UserType operator()(std::string_view text) const {
+      if constexpr(std::is_integral_v<UserType> or std::is_floating_point_v<UserType>) {
+        if(auto value = numberFromDecStr<UserType>(text)) {
+          return *value;
+        }
+      }
+      return StringReader<UserType>{}(text);
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Hex text of an integer, also used for binary integers. Signed values are sign extended from their number of digits.
+   */
+  template<typename UserType, bool isSigned>
+  struct HexIntReader {
+    UserType operator()(std::string_view text) const {
+      if constexpr(std::is_integral_v<UserType>) {
+        if constexpr(isSigned) {
+          std::string bytes; // Short enough for the small string buffer, unless padded with many leading zeros
+          binaryStrFromHexStr(text, bytes, true);
+          auto maybeInt = intFromBinaryStr<UserType>(bytes);
+          if(not maybeInt) {
+            throw ChimeraTK::runtime_error(
+                "Unable to fit the value " + std::string(text) + " into the UserType for reading");
+          }
+          return *maybeInt;
+        }
+        else {
+          if(auto value = intFromHexStr<UserType>(text)) {
+            return *value;
+          }
+          // Out of range: the string conversion clamps. It only supports unsigned hex.
+          return ChimeraTK::userTypeToUserType<UserType, std::string>("0x" + std::string(text));
+        }
+      }
+      else {
+        return StringReader<UserType>{}(text);
+      }
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Hex text of the bytes of a float.
+   */
+  template<typename UserType>
+  struct HexFloatReader {
+    UserType operator()(std::string_view text) const {
+      if constexpr(std::is_floating_point_v<UserType>) {
+        std::string bytes;
+        binaryStrFromHexStr(text, bytes, false);
+        auto maybeFloat = floatFromBinaryStr<UserType>(bytes);
+        if(not maybeFloat) {
+          throw ChimeraTK::runtime_error(
+              "Unable to fit the value " + std::string(text) + " into the UserType for reading");
+        }
+        return *maybeFloat;
+      }
+      else {
+        return StringReader<UserType>{}(text);
+      }
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  using ReadConverter = std::variant<StringReader<UserType>, DecimalReader<UserType>, HexIntReader<UserType, false>,
+      HexIntReader<UserType, true>, HexFloatReader<UserType>>;
+
+  /**
+   * @brief Select the reader for values of the interaction's transport layer type.
+   */
+  template<typename UserType>
+  ReadConverter<UserType> makeReadConverter(const InteractionInfo& iInfo) {
+    TransportLayerType type = iInfo.getTransportLayerType();
+    if constexpr(std::is_integral_v<UserType>) {
+      if((type == TransportLayerType::BIN_INT) or (type == TransportLayerType::HEX_INT)) {
+        if(iInfo.isSigned) {
+          return HexIntReader<UserType, true>{};
+        }
+        return HexIntReader<UserType, false>{};
+      }
+      if(type == TransportLayerType::DEC_INT) {
+        return DecimalReader<UserType>{};
+      }
+    }
+    else if constexpr(std::is_floating_point_v<UserType>) {
+      if(type == TransportLayerType::BIN_FLOAT) {
+        return HexFloatReader<UserType>{};
+      }
+      if((type == TransportLayerType::DEC_INT) or (type == TransportLayerType::DEC_FLOAT)) {
+        return DecimalReader<UserType>{};
+      }
+    }
+    return StringReader<UserType>{};
+  }
+
+  /********************************************************************************************************************/
+  // Readers from the raw bytes of a value in a binary response, see CompiledRegisterPlan::readBinaryLayout
+
+  template<typename UserType, bool isSigned>
+  struct BinaryIntReader {
+    UserType operator()(std::string_view bytes) const {
+      if constexpr(std::is_integral_v<UserType>) {
+        if constexpr(isSigned) {
+          if(auto maybeInt = intFromBinaryStr<UserType>(bytes)) {
+            return *maybeInt;
+          }
+        }
+        else if(auto maybeUint = intFromBinaryStr<uint64_t>(bytes);
+                maybeUint and *maybeUint <= static_cast<uint64_t>(std::numeric_limits<UserType>::max())) {
+          return static_cast<UserType>(*maybeUint);
+        }
+      }
+      // Out of range: keep the error or conversion behaviour of the hex path.
+      return HexIntReader<UserType, isSigned>{}(hexStrFromBinaryStr(bytes));
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  struct BinaryFloatReader {
+    UserType operator()(std::string_view bytes) const {
+      if constexpr(std::is_floating_point_v<UserType>) {
+        if(auto maybeFloat = floatFromBinaryStr<UserType>(bytes)) {
+          return *maybeFloat;
+        }
+      }
+      return HexFloatReader<UserType>{}(hexStrFromBinaryStr(bytes));
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * The string conversion of the hex representation, for user types which do not match the binary type.
+   */
+  template<typename UserType>
+  struct BinaryAsHexReader {
+    UserType operator()(std::string_view bytes) const {
+      return StringReader<UserType>{}(hexStrFromBinaryStr(bytes));
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  using BinaryReadConverter = std::variant<BinaryAsHexReader<UserType>, BinaryIntReader<UserType, false>,
+      BinaryIntReader<UserType, true>, BinaryFloatReader<UserType>>;
+
+  /**
+   * @brief Select the reader for the raw bytes of values of the interaction's binary transport layer type.
+   */
+  template<typename UserType>
+  BinaryReadConverter<UserType> makeBinaryReadConverter(const InteractionInfo& iInfo) {
+    TransportLayerType type = iInfo.getTransportLayerType();
+    if constexpr(std::is_integral_v<UserType>) {
+      if(type == TransportLayerType::BIN_INT) {
+        if(iInfo.isSigned) {
+          return BinaryIntReader<UserType, true>{};
+        }
+        return BinaryIntReader<UserType, false>{};
+      }
+    }
+    else if constexpr(std::is_floating_point_v<UserType>) {
+      if(type == TransportLayerType::BIN_FLOAT) {
+        return BinaryFloatReader<UserType>{};
+      }
+    }
+    return BinaryAsHexReader<UserType>{};
+  }
+
+  /********************************************************************************************************************/
+  // Writers of the text of a value in the command
+
+  // FIXME: does not know about formating. TODO ticket 13534.
+  // May need leading zeros or other formatting to satisfy the hardware interface.
+
+  template<typename UserType>
+  struct StringWriter {
+    std::string operator()(const UserType& value) const {
+      return ChimeraTK::userTypeToUserType<std::string, UserType>(value);
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  struct DecimalWriter {
+    std::string operator()(const UserType& value) const {
+      if constexpr(std::is_integral_v<UserType> or std::is_floating_point_v<UserType>) {
+        return decStrFromNumber(value);
+      }
+      else {
+        return StringWriter<UserType>{}(value);
+      }
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Hex text of an integer, also used for binary integers.
+   */
+  template<typename UserType, bool isSigned, bool hasFixedWidth>
+  struct HexIntWriter {
+    size_t width{0}; //!< Number of hex characters, only used if hasFixedWidth
+
+    std::string operator()(const UserType& value) const {
+      if constexpr(std::is_integral_v<UserType>) {
+        std::optional<std::string> maybeStr;
+        if constexpr(hasFixedWidth) {
+          maybeStr = hexStrFromInt(value, width, isSigned, OverflowBehavior::NULLOPT);
+        }
+        else {
+          maybeStr = hexStrFromInt(value, WidthOption::COMPACT, isSigned);
+        }
+        if(not maybeStr) {
+          throw ChimeraTK::runtime_error("Unable to fit value into the fixed_width write slot");
+        }
+        return *maybeStr;
+      }
+      else {
+        return StringWriter<UserType>{}(value);
+      }
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Hex text of the bytes of a float.
+   */
+  template<typename UserType>
+  struct HexFloatWriter {
+    std::string operator()(const UserType& value) const {
+      if constexpr(std::is_floating_point_v<UserType>) {
+        return hexStrFromFloat(value);
+      }
+      else {
+        return StringWriter<UserType>{}(value);
+      }
+    }
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  using WriteConverter = std::variant<StringWriter<UserType>, DecimalWriter<UserType>,
+      HexIntWriter<UserType, false, false>, HexIntWriter<UserType, false, true>, HexIntWriter<UserType, true, false>,
+      HexIntWriter<UserType, true, true>, HexFloatWriter<UserType>>;
+
+  /**
+   * @brief Select the writer for values of the interaction's transport layer type.
+   */
+  template<typename UserType>
+  WriteConverter<UserType> makeWriteConverter(const InteractionInfo& iInfo) {
+    TransportLayerType type = iInfo.getTransportLayerType();
+    if constexpr(std::is_integral_v<UserType>) {
+      if((type == TransportLayerType::HEX_INT) or (type == TransportLayerType::BIN_INT)) {
+        const auto& width = iInfo.fixedRegexCharacterWidthOpt;
+        if(iInfo.isSigned) {
+          if(width) {
+            return HexIntWriter<UserType, true, true>{*width};
+          }
+          return HexIntWriter<UserType, true, false>{};
+        }
+        if(width) {
+          return HexIntWriter<UserType, false, true>{*width};
+        }
+        return HexIntWriter<UserType, false, false>{};
+      }
+    }
+    else if constexpr(std::is_floating_point_v<UserType>) {
+      if(type == TransportLayerType::BIN_FLOAT) {
+        return HexFloatWriter<UserType>{};
+      }
+    }
+    if constexpr(std::is_integral_v<UserType> or std::is_floating_point_v<UserType>) {
+      if((type == TransportLayerType::DEC_INT) or (type == TransportLayerType::DEC_FLOAT)) {
+        return DecimalWriter<UserType>{};
+      }
+    }
+    // STRING, and Boolean, string and Void user types
+    return StringWriter<UserType>{};
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
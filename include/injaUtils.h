@@ -4,7 +4,9 @@
 
 #include <inja/inja.hpp>
 
+#include <optional>
 #include <regex>
+#include <string>
 
 namespace ChimeraTK {
   /********************************************************************************************************************/
@@ -34,4 +36,27 @@ namespace ChimeraTK {
       const std::string& injaTemplate, const inja::json& j, const std::string& errorMessageDetail);
 
   /********************************************************************************************************************/
+
+  /**
+   * @brief A tag of the form {{key.index}}, e.g. {{x.0}} or {{csStart.1}}
+   */
+  struct InjaTag {
+    std::string key;
+    size_t index;
+    size_t length; //!< Length of the whole tag including the braces
+  };
+
+  /**
+   * @brief Parse a tag of the form {{ key.index }} starting at pos, which must point to "{{".
+   * @returns the tag, or nullopt for anything else, e.g. whitespace control, expressions or filters.
+   */
+  std::optional<InjaTag> parseSimpleInjaTag(const std::string& pattern, size_t pos);
+
+  /**
+   * @brief Whether the pattern contains inja syntax beyond {{...}} expressions, i.e. statements, comments or line
+   * statements.
+   */
+  bool usesInjaStatements(const std::string& pattern);
+
+  /********************************************************************************************************************/
 } // end namespace ChimeraTK
@@ -18,6 +18,10 @@
  *  toStr(mapFileTopLevelKeys::METADATA): {
  *      toStr(mapFileMetadataKeys::DEFAULT_RECOVERY_REGISTER): <string>,
  *      toStr(mapFileMetadataKeys::DELIMITER): <string>,
+ *      toStr(mapFileMetadataKeys::PIPELINE_DEPTH): <unsigned int>,
+ *      toStr(mapFileMetadataKeys::COMPOUND_COMMAND): {
+ *          toStr(mapFileCompoundCommandKeys:: ...): <value>
+ *      },
  *  },
  *  toStr(mapFileTopLevelKeys::REGISTERS): {
  *      "registerPath1":{
@@ -52,6 +56,25 @@
  *  Setting mapFileInteractionInfoKeys::N_RESPONSE_BYTES turns the interaction to binary mode, there is no responce
  * delimiter, and the interaction's mapFileInteractionInfoKeys::COMMAND_DELIMITER defaults to "", overriding the
  * metadata and register delimiter, unless DELIMITER or COMMAND_DELIMITER is explicitly set.
+ *
+ *  Setting mapFileInteractionInfoKeys::BLOCK_DATA in the read interaction makes the response an IEEE 488.2 definite
+ * length arbitrary block of that element type, in mapFileInteractionInfoKeys::BLOCK_BYTE_ORDER. There is no response
+ * pattern, the block is decoded into the register directly. The response delimiter, if any, is the terminator after
+ * the block.
+ *
+ *  Setting mapFileRegisterKeys::POLL_INTERVAL makes a readable register support AccessMode::wait_for_new_data. The
+ * backend then polls it at that interval in milliseconds and pushes the values. The CDD parameter pollInterval sets
+ * the interval for all readable registers without their own.
+ *
+ *  Setting mapFileRegisterKeys::UNSOLICITED to a response pattern like "EVT:LIMIT {{x.0}}" (one line, without the
+ * delimiter) routes lines of that pattern, which the device sends on its own, to the register's accessors with
+ * AccessMode::wait_for_new_data. They are recognised between and within command responses, so the pattern must not
+ * match any response to a command. The register needs a read command as well, which provides the initial value upon
+ * activation.
+ *
+ *  Setting mapFileMetadataKeys::COMPOUND_COMMAND lets read-only registers in a TransferGroup be read with SCPI style
+ * compound commands like "CMD1?;CMD2?", answered by one line like "1;2". Only registers whose read command is constant
+ * and whose response is a single text line are merged.
  */
 /**********************************************************************************************************************/
 /**********************************************************************************************************************/
@@ -129,6 +152,8 @@ inline std::unordered_map<mapFileTopLevelKeys, std::string> getMapForEnum<mapFil
 enum class mapFileMetadataKeys {
   DEFAULT_RECOVERY_REGISTER,
   DELIMITER,
+  PIPELINE_DEPTH, // Number of commands in flight for devices answering queued commands in order, see CommandPipeline
+  COMPOUND_COMMAND, // Merge reads in a TransferGroup into compound commands, see CompoundReadTransferElement
 };
 
 // Associate json key strings with mapFileMetadataKeys enums.
@@ -137,7 +162,31 @@ inline std::unordered_map<mapFileMetadataKeys, std::string> getMapForEnum<mapFil
   static const std::unordered_map<mapFileMetadataKeys, std::string> uMap = {
       // clang-format off
         {mapFileMetadataKeys::DEFAULT_RECOVERY_REGISTER, "defaultRecoveryRegister"},
-        {mapFileMetadataKeys::DELIMITER, "delimiter"} // clang-format on
+        {mapFileMetadataKeys::DELIMITER, "delimiter"},
+        {mapFileMetadataKeys::PIPELINE_DEPTH, "pipelineDepth"},
+        {mapFileMetadataKeys::COMPOUND_COMMAND, "compoundCommand"} // clang-format on
+  };
+  return uMap;
+}
+
+/**********************************************************************************************************************/
+
+enum class mapFileCompoundCommandKeys {
+  SEPARATOR,          // Between the commands, default ";"
+  RESPONSE_SEPARATOR, // Between the responses, defaults to the SEPARATOR
+  MAX_COMMANDS,       // Maximum number of commands in a compound command, default unlimited
+  MAX_LENGTH,         // Maximum length of a compound command without delimiter, e.g. the device's input buffer size
+};
+
+// Associate json key strings with mapFileCompoundCommandKeys enums.
+template<>
+inline std::unordered_map<mapFileCompoundCommandKeys, std::string> getMapForEnum<mapFileCompoundCommandKeys>() {
+  static const std::unordered_map<mapFileCompoundCommandKeys, std::string> uMap = {
+      // clang-format off
+        {mapFileCompoundCommandKeys::SEPARATOR, "separator"},
+        {mapFileCompoundCommandKeys::RESPONSE_SEPARATOR, "responseSeparator"},
+        {mapFileCompoundCommandKeys::MAX_COMMANDS, "maxCommands"},
+        {mapFileCompoundCommandKeys::MAX_LENGTH, "maxLength"} // clang-format on
   };
   return uMap;
 }
@@ -148,6 +197,8 @@ enum class mapFileRegisterKeys {
   WRITE,
   READ,
   N_ELEM,
+  POLL_INTERVAL, // In milliseconds. Makes the register support AccessMode::wait_for_new_data, see PollScheduler
+  UNSOLICITED,   // Pattern of lines the device sends on its own for this register, see UnsolicitedDispatcher
   TYPE, // TYPE and below need to be in common with mapFileInteractionInfoKeys
   N_RESPONSE_BYTES,
   N_RESPONSE_LINES,
@@ -168,6 +219,8 @@ inline std::unordered_map<mapFileRegisterKeys, std::string> getMapForEnum<mapFil
         {mapFileRegisterKeys::WRITE, "write"},
         {mapFileRegisterKeys::READ, "read"},
         {mapFileRegisterKeys::N_ELEM, "nElem"},
+        {mapFileRegisterKeys::POLL_INTERVAL, "pollInterval"},
+        {mapFileRegisterKeys::UNSOLICITED, "unsolicited"},
         {mapFileRegisterKeys::TYPE, "type"}, //TYPE and below need to be in common with mapFileInteractionInfoKeys
         {mapFileRegisterKeys::N_RESPONSE_BYTES, "nRespBytes"},
         {mapFileRegisterKeys::N_RESPONSE_LINES, "nRespLines"},
@@ -190,6 +243,8 @@ enum class mapFileInteractionInfoKeys {
   RESPESPONSE,
   CMD_CHECKSUM,
   RESP_CHECKSUM,
+  BLOCK_DATA,
+  BLOCK_BYTE_ORDER,
   TYPE, // TYPE and below need to be in common with mapFileRegisterKeys
   N_RESPONSE_BYTES,
   N_RESPONSE_LINES,
@@ -211,6 +266,8 @@ inline std::unordered_map<mapFileInteractionInfoKeys, std::string> getMapForEnum
         {mapFileInteractionInfoKeys::RESPESPONSE, "resp"},
         {mapFileInteractionInfoKeys::CMD_CHECKSUM, "cmdChecksum"},
         {mapFileInteractionInfoKeys::RESP_CHECKSUM, "respChecksum"},
+        {mapFileInteractionInfoKeys::BLOCK_DATA, "blockData"},
+        {mapFileInteractionInfoKeys::BLOCK_BYTE_ORDER, "byteOrder"},
 
         //unordered_map<mapFileRegisterKeys.. is the single source of truth for these shared JSON key strings.
         {mapFileInteractionInfoKeys::TYPE,
@@ -279,7 +336,9 @@ enum class checksum {
     CS8,
     CS32,
     SHA256,
-    CRC_CCIT16
+    CRC_CCIT16,
+    CRC32,
+    CRC32C
   // clang-format on
 };
 // When updating these, also update Checksum.cc::
@@ -293,6 +352,88 @@ inline std::unordered_map<checksum, std::string> getMapForEnum<checksum>() {
     {checksum::CS32, "cs32"},
     {checksum::SHA256, "sha256"},
     {checksum::CRC_CCIT16, "crcccit16"},
+    {checksum::CRC32, "crc32"},
+    {checksum::CRC32C, "crc32c"},
+      // clang-format on
+  };
+  return uMap;
+}
+
+/**********************************************************************************************************************/
+
+/*
+ * Element types of IEEE 488.2 definite length arbitrary block responses "#<n><length><payload>",
+ * (associated with the toStr(BLOCK_DATA) key). Setting it makes the read response a block instead of lines or bytes.
+ */
+enum class BlockDataType {
+  INT8,
+  UINT8,
+  INT16,
+  UINT16,
+  INT32,
+  UINT32,
+  INT64,
+  UINT64,
+  FLOAT32,
+  FLOAT64,
+};
+
+template<>
+inline std::unordered_map<BlockDataType, std::string> getMapForEnum<BlockDataType>() {
+  static const std::unordered_map<BlockDataType, std::string> uMap = {
+      // clang-format off
+    {BlockDataType::INT8, "int8"},
+    {BlockDataType::UINT8, "uint8"},
+    {BlockDataType::INT16, "int16"},
+    {BlockDataType::UINT16, "uint16"},
+    {BlockDataType::INT32, "int32"},
+    {BlockDataType::UINT32, "uint32"},
+    {BlockDataType::INT64, "int64"},
+    {BlockDataType::UINT64, "uint64"},
+    {BlockDataType::FLOAT32, "float32"},
+    {BlockDataType::FLOAT64, "float64"},
+      // clang-format on
+  };
+  return uMap;
+}
+
+/**
+ * The number of bytes per element of a BlockDataType.
+ */
+inline size_t getByteWidth(BlockDataType type) {
+  switch(type) {
+    case BlockDataType::INT8:
+    case BlockDataType::UINT8:
+      return 1;
+    case BlockDataType::INT16:
+    case BlockDataType::UINT16:
+      return 2;
+    case BlockDataType::INT32:
+    case BlockDataType::UINT32:
+    case BlockDataType::FLOAT32:
+      return 4;
+    case BlockDataType::INT64:
+    case BlockDataType::UINT64:
+    case BlockDataType::FLOAT64:
+      return 8;
+  }
+  return 0;
+}
+
+/**********************************************************************************************************************/
+
+// Byte order of the block data elements, (associated with the toStr(BLOCK_BYTE_ORDER) key). SCPI defaults to BIG.
+enum class ByteOrder {
+  BIG,
+  LITTLE,
+};
+
+template<>
+inline std::unordered_map<ByteOrder, std::string> getMapForEnum<ByteOrder>() {
+  static const std::unordered_map<ByteOrder, std::string> uMap = {
+      // clang-format off
+    {ByteOrder::BIG, "big"},
+    {ByteOrder::LITTLE, "little"},
       // clang-format on
   };
   return uMap;
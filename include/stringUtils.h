@@ -4,10 +4,13 @@
 
 #include <ChimeraTK/SupportedUserTypes.h>
 
+#include <array>
 #include <cassert>
+#include <charconv>
 #include <cstring> //for memcpy
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <variant>
 #include <vector>
@@ -82,6 +85,11 @@ std::string getLower(const std::string& str) noexcept;
  */
 [[nodiscard]] std::string binaryStrFromHexStr(const std::string& hexStr, bool isSigned = false) noexcept;
 
+/**
+ * @brief Like binaryStrFromHexStr() above, but into binOut, whose capacity is reused.
+ */
+void binaryStrFromHexStr(std::string_view hexStr, std::string& binOut, bool isSigned = false) noexcept;
+
 /**
  * @brief Convert a string container of bytes into the string hexidecimal representation of that data.
  * @param[in] byteStr A string container of bytes (like "\xFF"). It must have the length set accurately, since without
@@ -90,7 +98,31 @@ std::string getLower(const std::string& str) noexcept;
  * is fully determined by the length of byteStr: return length = 2 byteStr.length. string is guarenteed to be exactly
  * twice as long as the input string.
  */
-[[nodiscard]] std::string hexStrFromBinaryStr(const std::string& byteStr) noexcept;
+[[nodiscard]] std::string hexStrFromBinaryStr(std::string_view byteStr) noexcept;
+
+/**
+ * Instruction sets of the kernels behind binaryStrFromHexStr() and hexStrFromBinaryStr(byteStr), which are chosen
+ * according to the CPU at runtime.
+ */
+enum class HexKernel { SCALAR, SSE2, AVX2 };
+
+/**
+ * @brief The fastest hex kernel this CPU supports, which binaryStrFromHexStr() and hexStrFromBinaryStr() use.
+ */
+[[nodiscard]] HexKernel getHexKernel() noexcept;
+
+/**
+ * @brief Write the 2 * nBytes upper case hex digits of the bytes to hexOut. Exposed for tests and benchmarks.
+ * @param[in] kernel Kernels the CPU does not support are replaced by getHexKernel().
+ */
+void encodeHex(const char* bytes, size_t nBytes, char* hexOut, HexKernel kernel) noexcept;
+
+/**
+ * @brief Write the nBytes bytes of 2 * nBytes hex digits (case insensitive) to bytesOut. Exposed for tests and
+ * benchmarks.
+ * @param[in] kernel Kernels the CPU does not support are replaced by getHexKernel().
+ */
+void decodeHex(const char* hex, size_t nBytes, char* bytesOut, HexKernel kernel) noexcept;
 
 /**
  * @brief Convert a string container of bytes into the string hexidecimal representation of that data. The hex output
@@ -522,10 +554,10 @@ template<typename intType, typename = enableIfIntegral<intType>>
  * param[in] interpretAsPositive Whether or not to binaryContainer as positive or negative.
  */
 static inline size_t getStrNaturalByteWidth(
-    const std::string& binaryContainer, const bool interpretAsPositive = true) noexcept {
+    std::string_view binaryContainer, const bool interpretAsPositive = true) noexcept {
   const char leftpackChar = (interpretAsPositive ? '\0' : '\xFF');
   size_t naturalWidth = binaryContainer.find_first_not_of(leftpackChar);
-  return ((naturalWidth == std::string::npos) ? 1 : binaryContainer.size() - naturalWidth);
+  return ((naturalWidth == std::string_view::npos) ? 1 : binaryContainer.size() - naturalWidth);
 }
 
 /*--------------------------------------------------------------------------------------------------------------------*/
@@ -543,7 +575,7 @@ static inline size_t getStrNaturalByteWidth(
  * @returns integer of type intType, if possible, representing the data in binaryContainer.
  */
 template<typename intType>
-[[nodiscard]] std::optional<intType> intFromBinaryStr(const std::string& binaryContainer,
+[[nodiscard]] std::optional<intType> intFromBinaryStr(std::string_view binaryContainer,
     const bool truncateIfOverflow = false, enableIfNonBoolIntegral<intType>* = nullptr) noexcept {
   if(binaryContainer.empty()) {
     return 0;
@@ -589,7 +621,7 @@ template<typename intType>
 /*--------------------------------------------------------------------------------------------------------------------*/
 
 template<typename boolType>
-[[nodiscard]] std::optional<boolType> intFromBinaryStr(const std::string& binaryContainer,
+[[nodiscard]] std::optional<boolType> intFromBinaryStr(std::string_view binaryContainer,
     const bool truncateIfOverflow = false, enableIfBool<boolType>* = nullptr) noexcept {
   if(binaryContainer.empty()) {
     return false; // TODO FIXME overflowBehavior
@@ -610,7 +642,7 @@ template<typename boolType>
  * Converts a string containing the binary representation of a floating poitn number into the floating point number.
  */
 template<typename floatType, typename = enableIfFloat<floatType>>
-[[nodiscard]] std::optional<floatType> floatFromBinaryStr(const std::string& binaryContainer) noexcept {
+[[nodiscard]] std::optional<floatType> floatFromBinaryStr(std::string_view binaryContainer) noexcept {
   constexpr size_t nBytes = sizeof(floatType);
   static_assert(nBytes <= sizeof(uint64_t));
 
@@ -632,3 +664,68 @@ template<typename floatType, typename = enableIfFloat<floatType>>
   std::memcpy(&result, &result_uint, nBytes);
   return result;
 }
+
+/**********************************************************************************************************************/
+/**********************************************************************************************************************/
+// Locale independent decimal and hex text conversions, based on std::from_chars and std::to_chars.
+
+/**
+ * Parses the whole string as a decimal number. A leading '+' is accepted, like in the response patterns.
+ * Floating point numbers are parsed in fixed notation.
+ * @returns nullopt if the string is not entirely a number, or if the number does not fit into numType.
+ */
+template<typename numType, typename = enableIfNonBoolNumeric<numType>>
+[[nodiscard]] std::optional<numType> numberFromDecStr(std::string_view str) noexcept {
+  if(not str.empty() and str[0] == '+') {
+    str.remove_prefix(1);
+  }
+  numType result;
+  std::from_chars_result parsed;
+  if constexpr(std::is_floating_point_v<numType>) {
+    parsed = std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::fixed);
+  }
+  else {
+    parsed = std::from_chars(str.data(), str.data() + str.size(), result);
+  }
+  if(parsed.ec != std::errc() or parsed.ptr != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+/**********************************************************************************************************************/
+
+/**
+ * Parses the whole string as an unsigned hexadecimal number without "0x" prefix, in upper or lower case.
+ * @returns nullopt if the string is not entirely hex digits, or if the number does not fit into intType.
+ */
+template<typename intType, typename = enableIfNonBoolIntegral<intType>>
+[[nodiscard]] std::optional<intType> intFromHexStr(std::string_view str) noexcept {
+  intType result;
+  auto parsed = std::from_chars(str.data(), str.data() + str.size(), result, 16);
+  if(parsed.ec != std::errc() or parsed.ptr != str.data() + str.size() or (not str.empty() and str[0] == '-')) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+/**********************************************************************************************************************/
+
+/**
+ * Formats the number in decimal. Floating point numbers get the shortest fixed notation which parses back to the same
+ * value, e.g. "2.5" rather than "2.500000", so no precision is lost for small values either.
+ */
+template<typename numType, typename = enableIfNonBoolNumeric<numType>>
+[[nodiscard]] std::string decStrFromNumber(const numType payload) noexcept {
+  // Large enough for any double in fixed notation, down to the smallest denormal.
+  std::array<char, std::is_floating_point_v<numType> ? 512 : 24> buffer;
+  std::to_chars_result formatted;
+  if constexpr(std::is_floating_point_v<numType>) {
+    formatted = std::to_chars(buffer.data(), buffer.data() + buffer.size(), payload, std::chars_format::fixed);
+  }
+  else {
+    formatted = std::to_chars(buffer.data(), buffer.data() + buffer.size(), payload);
+  }
+  assert(formatted.ec == std::errc());
+  return {buffer.data(), formatted.ptr};
+}
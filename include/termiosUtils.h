@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+/*
+ * Helpers which need the kernel's termios2 interface. <asm/termbits.h> clashes with the glibc <termios.h>, so these
+ * live in their own translation unit and this header must not include either of them.
+ */
+
+namespace ChimeraTK {
+
+  /**
+   * @brief Set an arbitrary input and output baud rate using termios2 and BOTHER. All other settings of the port are
+   * left untouched, so call this after tcsetattr().
+   * @returns false if the driver rejects the rate (errno is set), true otherwise.
+   */
+  bool setCustomBaudRate(int fileDescriptor, unsigned int baudRate) noexcept;
+
+} // namespace ChimeraTK
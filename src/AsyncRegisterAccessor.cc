@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "AsyncRegisterAccessor.h"
+
+#include "CommandBasedBackend.h"
+
+#include <algorithm>
+#include <utility>
+#include <variant>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  AsyncRegisterAccessor<UserType>::AsyncRegisterAccessor(const boost::shared_ptr<DeviceBackend>& dev,
+      std::shared_ptr<const CompiledRegisterPlan> plan, const RegisterPath& registerPathName, size_t numberOfElements,
+      size_t elementOffsetInRegister, AccessModeFlags flags)
+  : NDRegisterAccessor<UserType>(registerPathName, flags),
+    _backend(boost::dynamic_pointer_cast<CommandBasedBackend>(dev)) {
+    flags.checkForUnknownFlags({AccessMode::wait_for_new_data});
+    if(!_backend) {
+      throw ChimeraTK::logic_error("AsyncRegisterAccessor is used with a backend which is not "
+                                   "a CommandBasedBackend.");
+    }
+    const auto& registerInfo = plan->registerInfo;
+    if(not registerInfo.pollInterval and not plan->unsolicitedResponseMatcher) {
+      throw ChimeraTK::logic_error("Register " + registerInfo.registerPath +
+          " does not support wait_for_new_data. Set " + toStr(mapFileRegisterKeys::POLL_INTERVAL) + " or " +
+          toStr(mapFileRegisterKeys::UNSOLICITED) + " in the map file, or pollInterval in the CDD.");
+    }
+    this->_exceptionBackend = dev;
+
+    // Checks the size and the data type, and provides the shape of the buffers.
+    auto syncAccessor = boost::make_shared<CommandBasedBackendRegisterAccessor<UserType>>(
+        dev, plan, registerPathName, numberOfElements, elementOffsetInRegister, AccessModeFlags{});
+    if(registerInfo.isWriteable()) {
+      _writeAccessor = boost::make_shared<CommandBasedBackendRegisterAccessor<UserType>>(
+          dev, plan, registerPathName, numberOfElements, elementOffsetInRegister, AccessModeFlags{});
+    }
+    buffer_2D = syncAccessor->accessChannels();
+    _receiveBuffer.value = buffer_2D;
+
+    // The continuation runs in the reading thread when it takes the value from the _readQueue.
+    this->_readQueue = _dataTransportQueue.template then<void>(
+        [this](Buffer& buffer) { std::swap(_receiveBuffer, buffer); }, std::launch::deferred);
+
+    if(plan->unsolicitedResponseMatcher) {
+      _unsolicitedSubscription = std::make_shared<UnsolicitedSubscription>(
+          registerInfo.readInfo, buffer_2D[0].size(), elementOffsetInRegister, _dataTransportQueue);
+      _backend->_unsolicitedDispatcher.subscribe(plan, _unsolicitedSubscription);
+    }
+    // Without pollInterval, the PollScheduler only reads the initial value.
+    _pollSubscription = std::make_shared<PollSubscription>(std::move(syncAccessor), _dataTransportQueue);
+    _backend->_pollScheduler.subscribe(_pollSubscription, registerInfo.pollInterval);
+  } // end constructor AsyncRegisterAccessor
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  AsyncRegisterAccessor<UserType>::~AsyncRegisterAccessor() {
+    _backend->_pollScheduler.unsubscribe(_pollSubscription.get());
+    if(_unsolicitedSubscription) {
+      _backend->_unsolicitedDispatcher.unsubscribe(_unsolicitedSubscription.get());
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void AsyncRegisterAccessor<UserType>::UnsolicitedSubscription::push(const ResponseMatcher::Result& match) {
+    const auto& data = match.data;
+    size_t nMatched = 0;
+    if(data.size() > _elementOffsetInRegister) {
+      nMatched = std::min(_numberOfElements, data.size() - _elementOffsetInRegister);
+    }
+    Buffer buffer;
+    buffer.value.resize(1);
+    buffer.value[0].reserve(_numberOfElements);
+    std::visit(
+        [&](const auto& convert) {
+          for(size_t i = 0; i < nMatched; ++i) {
+            buffer.value[0].push_back(convert(data[i + _elementOffsetInRegister]));
+          }
+          // As with unmatched regex groups, values missing in the pattern are empty.
+          buffer.value[0].resize(_numberOfElements, convert(std::string_view()));
+        },
+        _readConverter);
+    _dataTransportQueue.push_overwrite(std::move(buffer));
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void AsyncRegisterAccessor<UserType>::doPreRead([[maybe_unused]] TransferType type) {
+    if(!_backend->isOpen()) {
+      throw ChimeraTK::logic_error("Device not opened.");
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void AsyncRegisterAccessor<UserType>::doPostRead([[maybe_unused]] TransferType type, bool updateDataBuffer) {
+    if(not updateDataBuffer) {
+      return;
+    }
+    buffer_2D.swap(_receiveBuffer.value);
+    this->_versionNumber = _receiveBuffer.versionNumber;
+    this->_dataValidity = _receiveBuffer.dataValidity;
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void AsyncRegisterAccessor<UserType>::doPreWrite(TransferType type, VersionNumber versionNumber) {
+    if(not _writeAccessor) {
+      throw ChimeraTK::logic_error("Writing to the read-only register " + this->getName() + " is not allowed.");
+    }
+    // Lend the data to the write accessor until doPostWrite().
+    buffer_2D.swap(_writeAccessor->accessChannels());
+    _writeAccessor->setDataValidity(this->_dataValidity);
+    _writeAccessor->preWrite(type, versionNumber);
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  bool AsyncRegisterAccessor<UserType>::doWriteTransfer(VersionNumber versionNumber) {
+    return _writeAccessor->writeTransfer(versionNumber);
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void AsyncRegisterAccessor<UserType>::doPostWrite(TransferType type, VersionNumber versionNumber) {
+    if(not _writeAccessor) {
+      return; // doPreWrite has thrown already
+    }
+    buffer_2D.swap(_writeAccessor->accessChannels());
+    _writeAccessor->postWrite(type, versionNumber);
+  }
+
+  /********************************************************************************************************************/
+  // Magic from SupportedUserTypes.h
+  INSTANTIATE_TEMPLATE_FOR_CHIMERATK_USER_TYPES(AsyncRegisterAccessor);
+} // namespace ChimeraTK
@@ -3,6 +3,7 @@
 
 #include "Checksum.h"
 
+#include "Crc.h"
 #include "stringUtils.h"
 
 #include <ChimeraTK/Exception.h> //for ChimeraTK::logic_error
@@ -10,8 +11,11 @@
 #include <openssl/evp.h> // OpenSSL 3.0 EVP API
 #include <openssl/sha.h> // For SHA256_DIGEST_LENGTH
 
-#include <boost/crc.hpp>
-
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <memory> // For std::unique_ptr
 #include <regex>
 
@@ -20,62 +24,193 @@
 namespace ChimeraTK {
   /********************************************************************************************************************/
 
-  static std::string checksum8(const std::string& binData) {
-    uint8_t sum = 0;
-    for(unsigned char c : binData) {
+  template<typename SumType>
+  static SumType byteSum(std::string_view bytes) {
+    uint32_t sum = 0; // wraps like SumType, but is wide enough for the loop to vectorise
+    for(unsigned char c : bytes) {
       sum += c;
     }
-    return hexStrFromInt<uint8_t>(sum, WidthOption::TYPE_WIDTH).value();
+    return static_cast<SumType>(sum);
   }
 
   /********************************************************************************************************************/
 
-  static std::string checksum32(const std::string& binData) {
-    uint32_t sum = 0;
-    for(unsigned char c : binData) {
-      sum += c;
+  /*
+   * Fetching the algorithm costs more than hashing a typical payload, so it is done once.
+   */
+  static const EVP_MD* getSha256() {
+    static const std::unique_ptr<EVP_MD, decltype(&EVP_MD_free)> md(
+        EVP_MD_fetch(nullptr, "SHA256", nullptr), &EVP_MD_free);
+    if(not md) {
+      throw ChimeraTK::runtime_error("Failed to fetch SHA256");
     }
-    return hexStrFromInt<uint32_t>(sum, WidthOption::TYPE_WIDTH).value();
+    return md.get();
   }
 
   /********************************************************************************************************************/
 
-  static std::string checksumCrcCcit16(const std::string& binData) {
-    boost::crc_optimal<16, 0x1021, 0xFFFF, 0x0000, false, false> crc;
-    /*
-     * see https://www.scadacore.com/tools/programming-calculators/online-checksum-calculator/
-     * Explanation of the above crc_optimal template parameters
-     * 16: CRC width is 16 bits.
-     * 0x1021: Polynomial.
-     * 0xFFFF: Initial value.
-     * 0x0000: Final XOR value.
-     * false: ReflectIn - input data bits are not reflected.
-     * false: ReflectOut - output CRC bits are not reflected.
-     */
-    crc.process_bytes(binData.data(), binData.size());
-    uint16_t result = crc.checksum();
-    return hexStrFromInt<uint16_t>(result, WidthOption::TYPE_WIDTH).value();
+  static void sha256(std::string_view bytes, ChecksumBytes& result) {
+    static_assert(SHA256_DIGEST_LENGTH == MAX_CHECKSUM_BYTES);
+    // Creating a context costs more than hashing a typical payload as well, so it is reused.
+    thread_local const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    if(not ctx) {
+      throw ChimeraTK::runtime_error("Failed to create EVP_MD_CTX");
+    }
+
+    if(EVP_DigestInit_ex(ctx.get(), getSha256(), nullptr) != 1 ||
+        EVP_DigestUpdate(ctx.get(), bytes.data(), bytes.size()) != 1 ||
+        EVP_DigestFinal_ex(ctx.get(), reinterpret_cast<unsigned char*>(result.data()), nullptr) != 1) {
+      throw ChimeraTK::runtime_error("SHA256 computation failed");
+    }
   }
 
   /********************************************************************************************************************/
 
-  static std::string checksumSha256(const std::string& binData) {
-    std::vector<unsigned char> binDataVec(binData.begin(), binData.end());
-    std::vector<unsigned char> binResultVec(SHA256_DIGEST_LENGTH);
+  static std::string_view storeBigEndian(uint64_t value, size_t nBytes, ChecksumBytes& result) {
+    for(size_t i = 0; i < nBytes; ++i) {
+      result[nBytes - 1 - i] = static_cast<char>(value >> (8 * i));
+    }
+    return {result.data(), nBytes};
+  }
 
-    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
-    if(not ctx) {
-      throw ChimeraTK::runtime_error("Failed to create EVP_MD_CTX");
+  /********************************************************************************************************************/
+
+  std::string_view computeChecksum(checksum cs, std::string_view bytes, ChecksumBytes& result) {
+    switch(cs) {
+      case checksum::CS8:
+        return storeBigEndian(byteSum<uint8_t>(bytes), 1, result);
+      case checksum::CS32:
+        return storeBigEndian(byteSum<uint32_t>(bytes), 4, result);
+      case checksum::CRC_CCIT16:
+        return storeBigEndian(crcCcitt16(bytes), 2, result);
+      case checksum::CRC32:
+        return storeBigEndian(crc32(bytes), 4, result);
+      case checksum::CRC32C:
+        return storeBigEndian(crc32c(bytes), 4, result);
+      case checksum::SHA256:
+        sha256(bytes, result);
+        return {result.data(), SHA256_DIGEST_LENGTH};
     }
+    throw ChimeraTK::logic_error(FUNC_NAME + "Encountered unmapped checksum " + toStr(cs));
+  }
 
-    if(EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) != 1 ||
-        EVP_DigestUpdate(ctx.get(), binDataVec.data(), binDataVec.size()) != 1 ||
-        EVP_DigestFinal_ex(ctx.get(), binResultVec.data(), nullptr) != 1) {
-      throw ChimeraTK::runtime_error("SHA256 computation failed");
+  /********************************************************************************************************************/
+
+  void ChecksumState::DigestContextDeleter::operator()(evp_md_ctx_st* ctx) const noexcept {
+    EVP_MD_CTX_free(ctx);
+  }
+
+  /********************************************************************************************************************/
+
+  ChecksumState::ChecksumState(checksum cs) : _checksum(cs) {
+    [[maybe_unused]] size_t width = getHexCharacterWidth(cs); // throws for unmapped checksums
+    reset();
+  }
+
+  /********************************************************************************************************************/
+
+  void ChecksumState::reset() {
+    switch(_checksum) {
+      case checksum::CRC_CCIT16:
+        _value = 0xFFFF;
+        return;
+      case checksum::SHA256:
+        if(not _digest) {
+          _digest.reset(EVP_MD_CTX_new());
+          if(not _digest) {
+            throw ChimeraTK::runtime_error("Failed to create EVP_MD_CTX");
+          }
+        }
+        if(EVP_DigestInit_ex(_digest.get(), getSha256(), nullptr) != 1) {
+          throw ChimeraTK::runtime_error("SHA256 computation failed");
+        }
+        return;
+      default: // Sums, CRC32 and CRC32C
+        _value = 0;
     }
+  }
+
+  /********************************************************************************************************************/
 
-    std::string binResult(binResultVec.begin(), binResultVec.end());
-    return hexStrFromBinaryStr(binResult);
+  void ChecksumState::update(std::string_view bytes) {
+    switch(_checksum) {
+      case checksum::CS8:
+      case checksum::CS32:
+        _value += byteSum<uint32_t>(bytes);
+        return;
+      case checksum::CRC_CCIT16:
+        _value = crcCcitt16(bytes, static_cast<uint16_t>(_value));
+        return;
+      case checksum::CRC32:
+        _value = crc32(bytes, _value);
+        return;
+      case checksum::CRC32C:
+        _value = crc32c(bytes, _value);
+        return;
+      case checksum::SHA256:
+        if(EVP_DigestUpdate(_digest.get(), bytes.data(), bytes.size()) != 1) {
+          throw ChimeraTK::runtime_error("SHA256 computation failed");
+        }
+        return;
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::string_view ChecksumState::finish(ChecksumBytes& result) {
+    if(_checksum == checksum::SHA256) {
+      if(EVP_DigestFinal_ex(_digest.get(), reinterpret_cast<unsigned char*>(result.data()), nullptr) != 1) {
+        throw ChimeraTK::runtime_error("SHA256 computation failed");
+      }
+      return {result.data(), SHA256_DIGEST_LENGTH};
+    }
+    return storeBigEndian(_checksum == checksum::CS8 ? (_value & 0xFFU) : _value, getHexCharacterWidth(_checksum) / 2,
+        result);
+  }
+
+  /********************************************************************************************************************/
+
+  IncrementalChecksums::IncrementalChecksums(
+      const std::vector<checksum>& checksums, const std::vector<std::pair<size_t, size_t>>& payloads) {
+    assert(checksums.size() == payloads.size());
+    _payloads.reserve(checksums.size());
+    for(size_t i = 0; i < checksums.size(); ++i) {
+      _payloads.push_back({payloads[i].first, payloads[i].second, ChecksumState(checksums[i])});
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void IncrementalChecksums::reset() {
+    for(auto& payload : _payloads) {
+      payload.state.reset();
+    }
+    _position = 0;
+  }
+
+  /********************************************************************************************************************/
+
+  void IncrementalChecksums::update(std::string_view bytes) {
+    // Each payload gets the part of the bytes which overlaps with it.
+    for(auto& payload : _payloads) {
+      size_t begin = std::max(payload.offset, _position);
+      size_t end = std::min(payload.offset + payload.length, _position + bytes.size());
+      if(begin < end) {
+        payload.state.update(bytes.substr(begin - _position, end - begin));
+      }
+    }
+    _position += bytes.size();
+  }
+
+  /********************************************************************************************************************/
+
+  /*
+   * The checksumAlgorithm of cs: the hex text of its result.
+   */
+  template<checksum cs>
+  static std::string hexChecksum(const std::string& binData) {
+    ChecksumBytes result;
+    return hexStrFromBinaryStr(std::string(computeChecksum(cs, binData, result)));
   }
 
   /********************************************************************************************************************/
@@ -84,10 +219,12 @@ namespace ChimeraTK {
   checksumAlgorithm getChecksumAlgorithm(const checksum cs) {
     static const std::map<checksum, checksumAlgorithm> checksumToFuncMap = {
         // clang-format off
-            {checksum::CS8, checksum8},
-            {checksum::CS32, checksum32},
-            {checksum::SHA256, checksumSha256},
-            {checksum::CRC_CCIT16, checksumCrcCcit16}
+            {checksum::CS8, hexChecksum<checksum::CS8>},
+            {checksum::CS32, hexChecksum<checksum::CS32>},
+            {checksum::SHA256, hexChecksum<checksum::SHA256>},
+            {checksum::CRC_CCIT16, hexChecksum<checksum::CRC_CCIT16>},
+            {checksum::CRC32, hexChecksum<checksum::CRC32>},
+            {checksum::CRC32C, hexChecksum<checksum::CRC32C>}
         // clang-format on
     };
     try {
@@ -101,39 +238,64 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
   /********************************************************************************************************************/
 
-  std::string getRegexString(checksum cs) {
-    static const std::map<checksum, std::string> checksumToRegexStrMap = {
+  size_t getHexCharacterWidth(checksum cs) {
+    static const std::map<checksum, size_t> checksumToWidthMap = {
         // clang-format off
-            // String values must be parentheses bound capture groups.
-            {checksum::CS8,        "([0-9A-Fa-f]{2})"},
-            {checksum::CS32,       "([0-9A-Fa-f]{8})"},
-            {checksum::SHA256,     "([0-9A-Fa-f]{64})"},
-            {checksum::CRC_CCIT16, "([0-9A-Fa-f]{4})"} // clang-format on
+            {checksum::CS8,        2},
+            {checksum::CS32,       8},
+            {checksum::SHA256,     64},
+            {checksum::CRC_CCIT16, 4},
+            {checksum::CRC32,      8},
+            {checksum::CRC32C,     8} // clang-format on
     };
     try {
-      return checksumToRegexStrMap.at(cs);
+      return checksumToWidthMap.at(cs);
     }
     catch(const std::out_of_range&) {
       throw ChimeraTK::logic_error(FUNC_NAME + "Encountered unmapped checksum " + toStr(cs));
     }
   }
 
-  /********************************************************************************************************************/
   /********************************************************************************************************************/
 
-  // A do-nothing function for use as either a checksumInputAdapter or checksumOutputAdapter
-  static std::string identity(const std::string& s) {
-    return s;
+  std::string getRegexString(checksum cs) {
+    // Must be a parentheses bound capture group.
+    return "([0-9A-Fa-f]{" + std::to_string(getHexCharacterWidth(cs)) + "})";
   }
 
-  // Converts hexidecimal input strings into binary strings for input into the algol function
-  static std::string binFromHex(const std::string& hexData) {
-    return binaryStrFromHexStr(hexData);
+  /********************************************************************************************************************/
+  /********************************************************************************************************************/
+
+  std::string Checksumer::operator()(std::string_view payload) const {
+    std::string result;
+    (*this)(payload, result);
+    return result;
   }
 
-  // Get a decimal representation string from the hexidecimal checksum result
-  static std::string decFromHex(const std::string& hexChecksumResult) {
-    return std::to_string(ChimeraTK::userTypeToUserType<int, std::string>("0x" + hexChecksumResult));
+  /********************************************************************************************************************/
+
+  void Checksumer::operator()(std::string_view payload, std::string& result) const {
+    ChecksumBytes computed;
+    if(_isBinary) {
+      // The payload is hex text. Decode it into a buffer kept per thread, the result is hex again.
+      thread_local std::string bytes;
+      binaryStrFromHexStr(payload, bytes);
+      std::string_view resultBytes = computeChecksum(_checksum, bytes, computed);
+      result.resize(2 * resultBytes.size());
+      encodeHex(resultBytes.data(), resultBytes.size(), result.data(), getHexKernel());
+      return;
+    }
+
+    // Decimal, saturating at the maximum of int like the conversion of the hex result to int it replaces.
+    int64_t value = 0;
+    for(unsigned char byte : computeChecksum(_checksum, payload, computed)) {
+      value = (value << 8) | byte;
+      if(value > std::numeric_limits<int>::max()) {
+        value = std::numeric_limits<int>::max();
+        break;
+      }
+    }
+    result = decStrFromNumber(static_cast<int>(value));
   }
 
   /********************************************************************************************************************/
@@ -142,23 +304,13 @@ namespace ChimeraTK {
     const std::vector<checksum>& csEnums =
         ((iType == interactionType::CMD) ? iInfo.commandChecksumEnums : iInfo.responseChecksumEnums);
 
-    std::vector<Checksumer> Checksumers;
-    Checksumers.reserve(csEnums.size());
-
+    std::vector<Checksumer> checksumers;
+    checksumers.reserve(csEnums.size());
     for(const auto& csEnum : csEnums) {
-      /*
-       * This is designed to allow extensions where the adapters depend on the checksumEnum csEnum,
-       * so that csEnum can specify both the algorithm and the interpretation/adapter format.
-       * inputAdapter and outputAdapter are string to string function pointers.
-       */
-      auto inputAdapter = (iInfo.isBinary() ? binFromHex : identity);
-      auto outputAdapter = (iInfo.isBinary() ? identity : decFromHex);
-      checksumAlgorithm algolFunc = getChecksumAlgorithm(csEnum);
-
-      Checksumers.emplace_back([inputAdapter, outputAdapter, algolFunc](
-                                   const std::string& data) { return outputAdapter(algolFunc(inputAdapter(data))); });
+      [[maybe_unused]] size_t width = getHexCharacterWidth(csEnum); // throws for unmapped checksums
+      checksumers.emplace_back(csEnum, iInfo.isBinary());
     }
-    return Checksumers;
+    return checksumers;
   } // end makeChecksumers
 
   /********************************************************************************************************************/
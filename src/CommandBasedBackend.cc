@@ -12,7 +12,10 @@
 #include <nlohmann/json.hpp>
 
 #include <fstream>
+#include <limits>
+#include <map>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -20,6 +23,108 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  static std::string getInvalidParameterErrorPrefix(const std::map<std::string, std::string>& parameters,
+      const std::string& key, const std::string& backendName, const std::string& instance) {
+    return "Invalid value \"" + parameters.at(key) + "\" for parameter \"" + key + "\" in CDD of backend " +
+        backendName + " " + instance + ": ";
+  }
+
+  /********************************************************************************************************************/
+
+  /**
+   * @brief Get an unsigned integer CDD parameter.
+   * @returns defaultValue if the parameter is not set.
+   * @throws ChimeraTK::logic_error if the value is not a non-negative integer in the range of unsigned int.
+   */
+  static unsigned int getUnsignedParameter(const std::map<std::string, std::string>& parameters, const std::string& key,
+      unsigned int defaultValue, const std::string& backendName, const std::string& instance) {
+    if(parameters.count(key) == 0) {
+      return defaultValue;
+    }
+    const auto& str = parameters.at(key);
+    if(str.empty() or str.find_first_not_of("0123456789") != std::string::npos) {
+      throw ChimeraTK::logic_error(
+          getInvalidParameterErrorPrefix(parameters, key, backendName, instance) + "expected a positive integer.");
+    }
+    try {
+      unsigned long value = std::stoul(str);
+      if(value > std::numeric_limits<unsigned int>::max()) {
+        throw std::out_of_range(str);
+      }
+      return static_cast<unsigned int>(value);
+    }
+    catch(const std::out_of_range&) {
+      throw ChimeraTK::logic_error(
+          getInvalidParameterErrorPrefix(parameters, key, backendName, instance) + "value out of range.");
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  /**
+   * @brief Parse the serial line settings from the CDD parameters.
+   * @throws ChimeraTK::logic_error if a parameter has an invalid value, or if serial parameters are given for a
+   * network device.
+   */
+  static SerialPortSettings parseSerialPortSettings(const std::map<std::string, std::string>& parameters,
+      CommandBasedBackend::CommandBasedBackendType type, const std::string& instance) {
+    static const std::vector<std::string> serialParameterKeys{"baud", "dataBits", "parity", "stopBits", "flowControl"};
+    SerialPortSettings settings;
+
+    if(type != CommandBasedBackend::CommandBasedBackendType::SERIAL) {
+      for(const auto& key : serialParameterKeys) {
+        if(parameters.count(key) != 0) {
+          throw ChimeraTK::logic_error("Parameter \"" + key + "\" in CDD of backend CommandBasedTCP " + instance +
+              " is only supported by CommandBasedTTY");
+        }
+      }
+      return settings;
+    }
+
+    auto getUnsigned = [&](const std::string& key, unsigned int defaultValue) {
+      return getUnsignedParameter(parameters, key, defaultValue, "CommandBasedTTY", instance);
+    };
+    auto getChoice = [&]<typename EnumType>(const std::string& key, const std::map<std::string, EnumType>& choices,
+                         EnumType defaultValue) -> EnumType {
+      if(parameters.count(key) == 0) {
+        return defaultValue;
+      }
+      auto it = choices.find(getLower(parameters.at(key)));
+      if(it == choices.end()) {
+        std::string allowed;
+        for(const auto& [name, _] : choices) {
+          allowed += (allowed.empty() ? "" : ", ") + name;
+        }
+        throw ChimeraTK::logic_error(getInvalidParameterErrorPrefix(parameters, key, "CommandBasedTTY", instance) +
+            "allowed are " + allowed + ".");
+      }
+      return it->second;
+    };
+
+    settings.baudRate = getUnsigned("baud", settings.baudRate);
+    settings.dataBits = getUnsigned("dataBits", settings.dataBits);
+    settings.stopBits = getUnsigned("stopBits", settings.stopBits);
+    settings.parity = getChoice("parity",
+        std::map<std::string, SerialPortSettings::Parity>{{"none", SerialPortSettings::Parity::NONE},
+            {"even", SerialPortSettings::Parity::EVEN}, {"odd", SerialPortSettings::Parity::ODD}},
+        settings.parity);
+    settings.flowControl = getChoice("flowControl",
+        std::map<std::string, SerialPortSettings::FlowControl>{{"none", SerialPortSettings::FlowControl::NONE},
+            {"rtscts", SerialPortSettings::FlowControl::RTS_CTS},
+            {"xonxoff", SerialPortSettings::FlowControl::XON_XOFF}},
+        settings.flowControl);
+
+    try {
+      settings.validate();
+    }
+    catch(const ChimeraTK::logic_error& e) {
+      throw ChimeraTK::logic_error(std::string(e.what()) + " In CDD of backend CommandBasedTTY " + instance);
+    }
+    return settings;
+  }
+
+  /********************************************************************************************************************/
+
   CommandBasedBackend::CommandBasedBackend(
       CommandBasedBackendType type, std::string instance, std::map<std::string, std::string> parameters)
   : _commandBasedBackendType(type), _instance(std::move(instance)) {
@@ -31,6 +136,29 @@ namespace ChimeraTK {
         throw ChimeraTK::logic_error("Missing parameter \"port\" in CDD of backend CommandBasedTCP " + _instance);
       }
       _port = parameters.at("port");
+
+      _nIoThreads = getUnsignedParameter(
+          parameters, "ioThreads", static_cast<unsigned int>(_nIoThreads), "CommandBasedTCP", _instance);
+      if(_nIoThreads == 0 or _nIoThreads > IoReactor::maxNumberOfThreads) {
+        auto errorPrefix = getInvalidParameterErrorPrefix(parameters, "ioThreads", "CommandBasedTCP", _instance);
+        throw ChimeraTK::logic_error(
+            errorPrefix + "allowed are 1 to " + std::to_string(IoReactor::maxNumberOfThreads) + ".");
+      }
+    }
+    else if(parameters.count("ioThreads") != 0) {
+      throw ChimeraTK::logic_error("Parameter \"ioThreads\" in CDD of backend CommandBasedTTY " + _instance +
+          " is only supported by CommandBasedTCP");
+    }
+    _serialPortSettings = parseSerialPortSettings(parameters, _commandBasedBackendType, _instance);
+    if(parameters.count("pollInterval") != 0) {
+      std::string backendName =
+          _commandBasedBackendType == CommandBasedBackendType::SERIAL ? "CommandBasedTTY" : "CommandBasedTCP";
+      auto pollInterval = getUnsignedParameter(parameters, "pollInterval", 0, backendName, _instance);
+      if(pollInterval == 0) {
+        auto errorPrefix = getInvalidParameterErrorPrefix(parameters, "pollInterval", backendName, _instance);
+        throw ChimeraTK::logic_error(errorPrefix + "expected a positive number of milliseconds.");
+      }
+      _defaultPollInterval = std::chrono::milliseconds(pollInterval);
     }
     if(parameters.count("map") == 0) {
       throw ChimeraTK::logic_error("No map file parameter");
@@ -45,27 +173,74 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   void CommandBasedBackend::open() {
+    // A poll and the listener may still use the command handler and the pipeline which are replaced now, if this is a
+    // recovery. PollScheduler::sendException() does not wait for a running poll.
+    _pollScheduler.deactivate();
+    _unsolicitedDispatcher.stopListening();
+
     if(_commandBasedBackendType == CommandBasedBackendType::SERIAL) {
-      _commandHandler = std::make_unique<SerialCommandHandler>(_instance, _serialDelimiter, _timeoutInMilliseconds);
+      _commandHandler = std::make_unique<SerialCommandHandler>(
+          _instance, _serialDelimiter, _timeoutInMilliseconds, _serialPortSettings);
     }
     else if(_commandBasedBackendType == CommandBasedBackendType::ETHERNET) {
-      _commandHandler = std::make_unique<TcpCommandHandler>(_instance, _port, _serialDelimiter, _timeoutInMilliseconds);
+      _commandHandler = std::make_unique<TcpCommandHandler>(
+          _instance, _port, _serialDelimiter, _timeoutInMilliseconds, _nIoThreads);
     }
     else {
       // Then this is not part of the proper interface. Throw a std::logic_error as
       // intermediate debugging solution.
       throw std::logic_error("CommandBasedBackend: FIXME: Unsupported type");
     }
+    if(_pipelineDepth > 1) {
+      _pipeline =
+          std::make_unique<CommandPipeline>(_pipelineDepth, std::chrono::milliseconds(_timeoutInMilliseconds));
+    }
+    if(not _unsolicitedRegisters.empty()) {
+      for(const auto& registerPath : _unsolicitedRegisters) {
+        _unsolicitedDispatcher.addRegister(getRegisterPlan(registerPath));
+      }
+      _commandHandler->setUnsolicitedLineHandler(
+          [this](std::string_view line) { return _unsolicitedDispatcher.dispatch(line); });
+    }
 
     // Try to read from the last register that has been used.
     // Do not try writing as we don't have a valid value and would alter the device.
-    auto registerInfo = _backendCatalogue.getBackendRegister(_lastWrittenRegister);
-
     // testAccessor has isRecoveryTestAccessor flag set to true.
+    RegisterPath lastWrittenRegister;
+    {
+      std::lock_guard<std::mutex> lock(_lastWrittenRegisterMutex);
+      lastWrittenRegister = _lastWrittenRegister;
+    }
     CommandBasedBackendRegisterAccessor<std::string> testAccessor(
-        DeviceBackend::shared_from_this(), registerInfo, _lastWrittenRegister, 0, 0, {}, true);
+        DeviceBackend::shared_from_this(), getRegisterPlan(lastWrittenRegister), lastWrittenRegister, 0, 0, {}, true);
     testAccessor.read();
 
+    // With pipelining, the responses are read in order of the commands, so lines between them cannot be picked up.
+    // Unsolicited lines are then only recognised among the responses.
+    if(not _unsolicitedRegisters.empty() and not _pipeline) {
+      _unsolicitedDispatcher.startListening([this] {
+        // Wait without _mux, so commands are not delayed while the device is idle.
+        _commandHandler->waitForInput(UnsolicitedDispatcher::listenTimeout);
+        std::unique_lock<std::mutex> lock(_mux, std::try_to_lock);
+        if(not lock.owns_lock()) {
+          return;
+        }
+        try {
+          // A command may have received the pending bytes meanwhile, or left complete lines in the receive buffer. So
+          // only wait for the rest of a line while bytes are arriving, and otherwise just take the buffered lines.
+          bool isPending = _commandHandler->waitForInput(std::chrono::milliseconds(0));
+          // Only one line per turn, so _mux is released regularly also while the device keeps sending lines.
+          _commandHandler->readUnsolicitedLine(
+              _listenerLine, isPending ? UnsolicitedDispatcher::listenTimeout : std::chrono::milliseconds(0));
+        }
+        catch(const ChimeraTK::runtime_error& e) {
+          // With registers which are only polled upon activation, there may be no command to notice the error.
+          lock.unlock();
+          setException(e.what());
+        }
+      });
+    }
+
     // Backends must call this function at the end of a successful open() call.
     setOpenedAndClearException();
   }
@@ -73,18 +248,59 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   void CommandBasedBackend::close() {
+    // Waits for a running poll, which still uses the command handler, and for the listener.
+    _pollScheduler.deactivate();
+    _unsolicitedDispatcher.deactivate();
+    _unsolicitedDispatcher.stopListening();
+    _pipeline.reset();
     _commandHandler.reset();
     _opened = false;
   }
 
   /********************************************************************************************************************/
 
+  void CommandBasedBackend::activateAsyncRead() noexcept {
+    if(not isFunctional()) {
+      return;
+    }
+    _pollScheduler.activate();
+    _unsolicitedDispatcher.activate();
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandBasedBackend::setExceptionImpl() noexcept {
+    auto e = std::make_exception_ptr(ChimeraTK::runtime_error(getActiveExceptionMessage()));
+    _pollScheduler.sendException(e);
+    _unsolicitedDispatcher.sendException(e);
+  }
+
+  /********************************************************************************************************************/
+
   RegisterCatalogue CommandBasedBackend::getRegisterCatalogue() const {
     return RegisterCatalogue(_backendCatalogue.clone());
   }
 
   /********************************************************************************************************************/
 
+  std::shared_ptr<const CompiledRegisterPlan> CommandBasedBackend::getRegisterPlan(
+      const RegisterPath& registerPathName) {
+    std::lock_guard<std::mutex> lock(_registerPlansMutex);
+    auto& plan = _registerPlans[registerPathName];
+    if(not plan) {
+      try {
+        plan = std::make_shared<const CompiledRegisterPlan>(_backendCatalogue.getBackendRegister(registerPathName));
+      }
+      catch(...) {
+        _registerPlans.erase(registerPathName); // Do not leave an empty entry behind.
+        throw;
+      }
+    }
+    return plan;
+  }
+
+  /********************************************************************************************************************/
+
   boost::shared_ptr<DeviceBackend> CommandBasedBackend::createInstanceSerial(
       std::string instance, std::map<std::string, std::string> parameters) {
     return boost::make_shared<CommandBasedBackend>(
@@ -101,21 +317,55 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
-  std::vector<std::string> CommandBasedBackend::sendCommandAndRead(
-      const std::string& cmd, const InteractionInfo& iInfo) {
+  void CommandBasedBackend::sendCommandAndRead(std::string_view cmd, const InteractionInfo& iInfo,
+      std::vector<std::string>& response, const ReceiveObserver& onReceive) {
     assert(_commandHandler);
+    if(_pipeline) {
+      // Let the next transfer send while this one waits for its response.
+      _pipeline->transfer([&] { _commandHandler->sendCommand(cmd, iInfo.cmdLineDelimiter); },
+          [&](std::chrono::milliseconds remaining) { readResponse(iInfo, response, onReceive, remaining); });
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(_mux);
-    std::vector<std::string> ret;
     if(iInfo.usesReadLines()) {
-      ret = _commandHandler->sendCommandAndReadLines(
-          cmd, *iInfo.getResponseNLines(), iInfo.cmdLineDelimiter, *iInfo.getResponseLinesDelimiter());
+      _commandHandler->sendCommandAndReadLinesInto(
+          cmd, *iInfo.getResponseNLines(), iInfo.cmdLineDelimiter, *iInfo.getResponseLinesDelimiter(), response);
     }
     else if(iInfo.usesReadBytes()) {
-      std::string binResponce =
-          _commandHandler->sendCommandAndReadBytes(cmd, *iInfo.getResponseBytes(), iInfo.cmdLineDelimiter);
-      ret.push_back(binResponce);
+      response.resize(1);
+      _commandHandler->sendCommandAndReadBytesInto(
+          cmd, *iInfo.getResponseBytes(), iInfo.cmdLineDelimiter, response[0], onReceive);
+    }
+    else if(iInfo.usesReadBlock()) {
+      response.resize(1);
+      response[0] = _commandHandler->sendCommandAndReadBlock(
+          cmd, *iInfo.getResponseBlockBytes(), iInfo.cmdLineDelimiter, *iInfo.getResponseBlockTerminator());
+    }
+    else {
+      response.clear();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandBasedBackend::readResponse(const InteractionInfo& iInfo, std::vector<std::string>& response,
+      const ReceiveObserver& onReceive, std::chrono::milliseconds timeout) {
+    if(iInfo.usesReadLines()) {
+      _commandHandler->readLinesInto(*iInfo.getResponseNLines(), *iInfo.getResponseLinesDelimiter(), response, timeout);
+    }
+    else if(iInfo.usesReadBytes()) {
+      response.resize(1);
+      _commandHandler->readBytesInto(*iInfo.getResponseBytes(), response[0], timeout, onReceive);
+    }
+    else if(iInfo.usesReadBlock()) {
+      response.resize(1);
+      response[0] =
+          _commandHandler->readBlock(*iInfo.getResponseBlockBytes(), *iInfo.getResponseBlockTerminator(), timeout);
+    }
+    else {
+      response.clear();
     }
-    return ret;
   }
 
   /********************************************************************************************************************/
@@ -123,6 +373,14 @@ namespace ChimeraTK {
   std::vector<std::string> CommandBasedBackend::sendCommandAndReadLines(
       std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) {
     assert(_commandHandler);
+    if(_pipeline) {
+      std::vector<std::string> lines;
+      _pipeline->transfer([&] { _commandHandler->sendCommand(cmd, writeDelimiter); },
+          [&](std::chrono::milliseconds remaining) {
+            _commandHandler->readLinesInto(nLinesToRead, readDelimiter, lines, remaining);
+          });
+      return lines;
+    }
     std::lock_guard<std::mutex> lock(_mux);
     return _commandHandler->sendCommandAndReadLines(std::move(cmd), nLinesToRead, writeDelimiter, readDelimiter);
   }
@@ -132,6 +390,12 @@ namespace ChimeraTK {
   std::string CommandBasedBackend::sendCommandAndReadBytes(
       std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) {
     assert(_commandHandler);
+    if(_pipeline) {
+      std::string bytes;
+      _pipeline->transfer([&] { _commandHandler->sendCommand(cmd, writeDelimiter); },
+          [&](std::chrono::milliseconds remaining) { _commandHandler->readBytesInto(nBytesToRead, bytes, remaining); });
+      return bytes;
+    }
     std::lock_guard<std::mutex> lock(_mux);
     return _commandHandler->sendCommandAndReadBytes(std::move(cmd), nBytesToRead, writeDelimiter);
   }
@@ -139,7 +403,17 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   std::string CommandBasedBackend::readDeviceInfo() {
-    return "Device: " + _instance + " timeout: " + std::to_string(_timeoutInMilliseconds);
+    std::string info = "Device: " + _instance + " timeout: " + std::to_string(_timeoutInMilliseconds);
+    if(_commandBasedBackendType == CommandBasedBackendType::SERIAL) {
+      info += " settings: " + _serialPortSettings.toString();
+    }
+    if(_pipelineDepth > 1) {
+      info += " pipelineDepth: " + std::to_string(_pipelineDepth);
+    }
+    if(_defaultPollInterval) {
+      info += " pollInterval: " + std::to_string(_defaultPollInterval->count());
+    }
+    return info;
   }
 
   /********************************************************************************************************************/
@@ -220,6 +494,16 @@ namespace ChimeraTK {
     _defaultRecoveryRegister = RegisterPath(
         caseInsensitiveGetValueOr(metaDataJson, toStr(mapFileMetadataKeys::DEFAULT_RECOVERY_REGISTER), ""));
     _serialDelimiter = caseInsensitiveGetValueOr(metaDataJson, toStr(mapFileMetadataKeys::DELIMITER), "\r\n");
+    auto pipelineDepth =
+        caseInsensitiveGetValueOr(metaDataJson, toStr(mapFileMetadataKeys::PIPELINE_DEPTH), static_cast<int64_t>(1));
+    if(pipelineDepth < 1) {
+      throw ChimeraTK::logic_error("Map file metadata " + toStr(mapFileMetadataKeys::PIPELINE_DEPTH) +
+          " must be at least 1, but is " + std::to_string(pipelineDepth));
+    }
+    _pipelineDepth = static_cast<size_t>(pipelineDepth);
+    if(auto compoundJson = caseInsensitiveGetValueOption(metaDataJson, toStr(mapFileMetadataKeys::COMPOUND_COMMAND))) {
+      _compoundCommandSettings = parseCompoundCommandSettings(*compoundJson);
+    }
     throwIfHasInvalidJsonKeyCaseInsensitive(
         metaDataJson, getMapForEnum<mapFileMetadataKeys>(), "Map file metadata has unknown key");
     /*----------------------------------------------------------------------------------------------------------------*/
@@ -230,10 +514,34 @@ namespace ChimeraTK {
     }
 
     for(const auto& [key, value] : registerOpt.value().items()) {
-      _backendCatalogue.addRegister(CommandBasedBackendRegisterInfo(RegisterPath{key}, value, _serialDelimiter));
+      CommandBasedBackendRegisterInfo info(RegisterPath{key}, value, _serialDelimiter, _defaultPollInterval);
+      if(not info.unsolicitedPattern.empty()) {
+        _unsolicitedRegisters.push_back(info.registerPath);
+      }
+      _backendCatalogue.addRegister(std::move(info));
     }
   } // end parseJsonAndPopulateCatalogue
 
   /********************************************************************************************************************/
 
+  CompoundCommandSettings CommandBasedBackend::parseCompoundCommandSettings(const json& j) {
+    const std::string key = toStr(mapFileMetadataKeys::COMPOUND_COMMAND);
+    throwIfHasInvalidJsonKeyCaseInsensitive(
+        j, getMapForEnum<mapFileCompoundCommandKeys>(), "Map file metadata " + key + " has unknown key");
+
+    CompoundCommandSettings settings;
+    settings.separator =
+        caseInsensitiveGetValueOr(j, toStr(mapFileCompoundCommandKeys::SEPARATOR), settings.separator);
+    settings.responseSeparator =
+        caseInsensitiveGetValueOr(j, toStr(mapFileCompoundCommandKeys::RESPONSE_SEPARATOR), settings.separator);
+    settings.maxCommands = caseInsensitiveGetValueOr(j, toStr(mapFileCompoundCommandKeys::MAX_COMMANDS), size_t(0));
+    settings.maxLength = caseInsensitiveGetValueOr(j, toStr(mapFileCompoundCommandKeys::MAX_LENGTH), size_t(0));
+    if(settings.separator.empty() or settings.responseSeparator.empty()) {
+      throw ChimeraTK::logic_error("Map file metadata " + key + " has an empty separator");
+    }
+    return settings;
+  }
+
+  /********************************************************************************************************************/
+
 } // end namespace ChimeraTK
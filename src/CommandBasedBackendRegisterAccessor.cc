@@ -6,35 +6,28 @@
 #include "Checksum.h"
 #include "CommandBasedBackend.h"
 #include "CommandBasedBackendRegisterInfo.h"
-#include "injaUtils.h"
 #include "stringUtils.h"
 
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <variant>
 
 namespace ChimeraTK {
 
-  /** Return the functional for the given TransportLayerType for converting data from the transport layer format to
-   * UserType representation*/
-  template<typename UserType>
-  static ToUserTypeFunc<UserType> getToUserTypeFunction(TransportLayerType transportLayerType);
-
-  /** Return the functional for the given TransportLayerType for converting data from the to UserType representation to
-   * the transport layer format*/
-  template<typename UserType>
-  static ToTransportLayerFunc<UserType> getToTransportLayerFunction(TransportLayerType transportLayerType);
-
   /********************************************************************************************************************/
 
   template<typename UserType>
   CommandBasedBackendRegisterAccessor<UserType>::CommandBasedBackendRegisterAccessor(
-      const boost::shared_ptr<ChimeraTK::DeviceBackend>& dev, CommandBasedBackendRegisterInfo& registerInfo,
+      const boost::shared_ptr<ChimeraTK::DeviceBackend>& dev, std::shared_ptr<const CompiledRegisterPlan> plan,
       const RegisterPath& registerPathName, size_t numberOfElements, size_t elementOffsetInRegister,
       AccessModeFlags flags, bool isRecoveryTestAccessor)
   : NDRegisterAccessor<UserType>(registerPathName, flags), _numberOfElements(numberOfElements),
-    _elementOffsetInRegister(elementOffsetInRegister), _registerInfo(registerInfo),
+    _elementOffsetInRegister(elementOffsetInRegister), _plan(std::move(plan)), _registerInfo(_plan->registerInfo),
     _isRecoveryTestAccessor(isRecoveryTestAccessor), _backend(boost::dynamic_pointer_cast<CommandBasedBackend>(dev)) {
     assert(_registerInfo.getNumberOfChannels() != 0);
     assert(_registerInfo.getNumberOfElements() != 0);
@@ -59,40 +52,34 @@ namespace ChimeraTK {
     // Allocate the buffers
     NDRegisterAccessor<UserType>::buffer_2D.resize(_registerInfo.getNumberOfChannels());
     NDRegisterAccessor<UserType>::buffer_2D[0].resize(_numberOfElements);
-    _readTransferBuffer.resize(1);
 
     this->_exceptionBackend = dev;
 
     if(isWriteableImpl()) {
-      _transportLayerTypeFromUserType =
-          getToTransportLayerFunction<UserType>(_registerInfo.writeInfo.getTransportLayerType());
-
-      _writeResponseDataRegex = _registerInfo.getWriteResponseDataRegex();
-      _writeResponseChecksumRegex = _registerInfo.getWriteResponseChecksumRegex();
-      _writeResponseChecksumPayloadRegex = _registerInfo.getWriteResponseChecksumPayloadRegex();
-
-      _writeCommandChecksumers = makeChecksumers(interactionType::CMD, _registerInfo.writeInfo);
-      _writeResponseChecksumers = makeChecksumers(interactionType::RESP, _registerInfo.writeInfo);
+      _writeConverter = makeWriteConverter<UserType>(_registerInfo.writeInfo);
     }
 
     if(isReadableImpl()) {
-      _userTypeFromTransportLayerType = getToUserTypeFunction<UserType>(_registerInfo.readInfo.getTransportLayerType());
-
-      // We seek registerInfo.getNumberOfElements() matches in the response regex,
-      // which may be more than the number of elements in the the register (_numberOfElements), due to a non-zero
-      // _elementOffsetInRegister.
-      _readResponseDataRegex = _registerInfo.getReadResponseDataRegex();
-      _readResponseChecksumRegex = _registerInfo.getReadResponseChecksumRegex();
-      _readResponseChecksumPayloadRegex = _registerInfo.getReadResponseChecksumPayloadRegex();
-
-      _readCommandChecksumers = makeChecksumers(interactionType::CMD, _registerInfo.readInfo);
-      _readResponseChecksumers = makeChecksumers(interactionType::RESP, _registerInfo.readInfo);
+      _readConverter = makeReadConverter<UserType>(_registerInfo.readInfo);
+      if(_plan->readBinaryLayout) {
+        _binaryReadConverter = makeBinaryReadConverter<UserType>(_registerInfo.readInfo);
+      }
+      _registerRead = boost::make_shared<RegisterReadTransferElement>(_backend, _plan, _isRecoveryTestAccessor);
+    }
+    const auto& compoundCommandSettings = _backend->_compoundCommandSettings;
+    if(compoundCommandSettings and isReadOnlyImpl() and not _isRecoveryTestAccessor and
+        CompoundReadTransferElement::isMergeable(_registerInfo.readInfo)) {
+      _compoundRead = boost::make_shared<CompoundReadTransferElement>(*compoundCommandSettings, _registerRead);
     }
+
+    // The response matchers and checksumers are already in the shared _plan.
+    // The read response matcher seeks registerInfo.getNumberOfElements() values in the response, which may be more
+    // than the number of elements in the the register (_numberOfElements), due to a non-zero _elementOffsetInRegister.
   } // end constructor CommandBasedBackendRegisterAccessor
 
   /********************************************************************************************************************/
   template<typename UserType>
-  void CommandBasedBackendRegisterAccessor<UserType>::doPreRead([[maybe_unused]] TransferType) {
+  void CommandBasedBackendRegisterAccessor<UserType>::doPreRead(TransferType type) {
     if(!_backend->isOpen() && !_isRecoveryTestAccessor) {
       throw ChimeraTK::logic_error("Device not opened.");
     }
@@ -101,151 +88,202 @@ namespace ChimeraTK {
           "CommandBasedBackend: Commanding read to a non-readable register is not allowed (Register name: " +
           _registerInfo.getRegisterName() + ").");
     }
-    _backend->_lastWrittenRegister = _registerInfo.registerPath;
+    setLastWrittenRegister(_registerInfo.registerPath);
+    getReadElement().preRead(type);
   }
 
   /********************************************************************************************************************/
   template<typename UserType>
-  void CommandBasedBackendRegisterAccessor<UserType>::doReadTransferSynchronously() {
-    if(!_backend->isFunctional() && !_isRecoveryTestAccessor) {
-      throw ChimeraTK::runtime_error("Device not functional when reading " + this->getName());
-    }
-
-    // Compute the checksums of the read command.
-    inja::json replacePatterns;
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = {};
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = {};
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = {};
-    for(size_t i = 0; i < _registerInfo.readInfo.commandChecksumEnums.size(); ++i) {
-      /* Skip the potential step of
-       * renderedChecksumPayload = injaRender(_registerInfo.readInfo.commandChecksumPayloadStrs[i], replacePatterns, ...)
-       */
-      auto renderedChecksumPayload = std::string(_registerInfo.readInfo.commandChecksumPayloadStrs[i]);
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)].push_back("");
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)].push_back("");
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)].push_back(
-          _readCommandChecksumers[i](renderedChecksumPayload));
+  void CommandBasedBackendRegisterAccessor<UserType>::setLastWrittenRegister(const RegisterPath& registerPath) {
+    // Usually it is the same register as last time. Skip assigning then, which might allocate memory.
+    std::lock_guard<std::mutex> lock(_backend->_lastWrittenRegisterMutex);
+    if(_backend->_lastWrittenRegister != registerPath) {
+      _backend->_lastWrittenRegister = registerPath;
     }
+  }
 
-    std::string renderedReadCommand = injaRender(_registerInfo.readInfo.commandPattern, replacePatterns,
-        "in read command pattern of " + _registerInfo.registerPath);
+  /********************************************************************************************************************/
+  template<typename UserType>
+  void CommandBasedBackendRegisterAccessor<UserType>::doReadTransferSynchronously() {
+    getReadElement().readTransfer();
+  }
 
-    std::string readCommand;
-    if(_registerInfo.readInfo.isBinary()) {
-      readCommand = binaryStrFromHexStr(renderedReadCommand, /*isSigned*/ false);
-    }
-    else {
-      readCommand = renderedReadCommand;
-    }
+  /********************************************************************************************************************/
 
-    _readTransferBuffer = _backend->sendCommandAndRead(readCommand, _registerInfo.readInfo);
+  template<typename UserType>
+  bool CommandBasedBackendRegisterAccessor<UserType>::mayReplaceOther(
+      const boost::shared_ptr<TransferElement const>& other) const {
+    auto rhs = boost::dynamic_pointer_cast<const CommandBasedBackendRegisterAccessor<UserType>>(other);
+    if(not rhs or rhs.get() == this) {
+      return false;
+    }
+    return rhs->_backend == _backend and rhs->_plan == _plan and rhs->_numberOfElements == _numberOfElements and
+        rhs->_elementOffsetInRegister == _elementOffsetInRegister and
+        rhs->_isRecoveryTestAccessor == _isRecoveryTestAccessor;
   }
 
   /********************************************************************************************************************/
 
-  /*
-   * For technical reasons the response has been read line by line.
-   * Combine them here back into a single response string.
-   */
-  std::string makeCombinedReadString(const std::vector<std::string>& transferBuffer, const InteractionInfo& iInfo) {
-    std::string combinedReadString{};
-    if(iInfo.usesReadLines()) {
-      std::string delim = *iInfo.getResponseLinesDelimiter();
-      if(iInfo.isBinary()) {
-        for(const auto& line : transferBuffer) {
-          combinedReadString += hexStrFromBinaryStr(line) + delim;
-        }
-      }
-      else {
-        for(const auto& line : transferBuffer) {
-          combinedReadString += line + delim;
-        }
-      }
+  template<typename UserType>
+  void CommandBasedBackendRegisterAccessor<UserType>::replaceTransferElement(
+      boost::shared_ptr<TransferElement> newElement) {
+    if(not _registerRead or not isReadOnly()) {
+      return;
     }
-    else if(iInfo.usesReadBytes()) {
-      if(iInfo.isBinary()) {
-        combinedReadString = hexStrFromBinaryStr(transferBuffer[0]);
+
+    if(auto compoundRead = boost::dynamic_pointer_cast<CompoundReadTransferElement>(newElement)) {
+      if(not _compoundRead or compoundRead == _compoundRead) {
+        return;
       }
-      else {
-        combinedReadString = transferBuffer[0];
+      if(auto registerRead = compoundRead->find(*_plan)) {
+        // The register is already part of that compound command.
+        _compoundRead->remove(_registerRead);
+        _registerRead = registerRead;
+        _compoundRead = compoundRead;
       }
+      else if(compoundRead->mayAdopt(*_compoundRead, *_registerRead)) {
+        _compoundRead->remove(_registerRead);
+        compoundRead->add(_registerRead);
+        _compoundRead = compoundRead;
+      }
+      return;
+    }
+
+    // Without compound commands, the accessors to a register gather on the element with the lowest address, whatever
+    // the order in which the TransferGroup offers the elements.
+    auto registerRead = boost::dynamic_pointer_cast<RegisterReadTransferElement>(newElement);
+    if(registerRead and not _compoundRead and registerRead->getPlan() == _plan and
+        registerRead->getBackend() == _backend and registerRead.get() < _registerRead.get()) {
+      _registerRead = registerRead;
     }
-    return combinedReadString;
   }
 
   /********************************************************************************************************************/
 
-  /**
-   * @brief This extracts the checksum and checksum payload from combinedReadString via regexs, computes the checksum on
-   * the payload, and compares to the extracted payload
-   * @param[in] iInfo The InteractionInfo correspondign to read/write
-   * @param[in] responseChecksumPayloadRegex The regex to extract the checksum payload from combinedReadString.
-   * @param[in] responseChecksumRegex The regex to extract the checksum from combinedReadString.
-   * @param[in] responseChecksumers The functional to compute the checksum from the payload.
-   * @param[in] errorMessageDetail Will be replaced by iInfo.errorMessageDetail after ticket 14877
-   * @throws ChimeraTK::runtime_error if the
-   */
-  void inspectChecksum(const std::string& combinedReadString, const InteractionInfo& iInfo,
-      const std::regex& responseChecksumPayloadRegex, const std::regex& responseChecksumRegex,
-      const std::vector<Checksumer>& responseChecksumers, const std::string& errorMessageDetail) {
-    // Second regex match: extract the checksum payloads.
-    std::smatch checksumPayloadMatch;
-    if(!std::regex_match(combinedReadString, checksumPayloadMatch, responseChecksumPayloadRegex)) {
-      throw ChimeraTK::runtime_error(
-          "Could not extract checksum payloads with the response checksum payload regex in \"" +
-          replaceNewLines(combinedReadString) + "\" for " + errorMessageDetail);
+  template<typename UserType>
+  void CommandBasedBackendRegisterAccessor<UserType>::doPostRead(TransferType t, bool updateDataBuffer) {
+    // Transfer type enum options: {read, readNonBlocking, readLatest, write, writeDestructively }
+    if(not _registerRead) {
+      return; // doPreRead has thrown already
+    }
+    getReadElement().postRead(t, updateDataBuffer);
+    if(not updateDataBuffer) {
+      return;
     }
 
-    std::vector<std::string> checksumResults;
-    for(size_t i = 0; i < iInfo.responseChecksumEnums.size(); ++i) {
-      checksumResults.push_back(responseChecksumers[i](checksumPayloadMatch.str(i + 1)));
+    // The response has been parsed by the _registerRead already. Only this accessor's elements are converted.
+    if(_registerInfo.readInfo.usesReadBlock()) {
+      decodeBlockResponse();
     }
-    /*----------------------------------------------------------------------------------------------------------------*/
-    // Third regex match: extract the checksums received and compare.
-    std::smatch checksumMatch;
-    if(!std::regex_match(combinedReadString, checksumMatch, responseChecksumRegex)) {
-      throw ChimeraTK::runtime_error("Could not extract checksum values with the response checksum regex in \"" +
-          replaceNewLines(combinedReadString) + "\" for " + errorMessageDetail);
+    else if(_binaryReadConverter) {
+      convertMatchedData(*_binaryReadConverter);
     }
-    for(size_t i = 0; i < iInfo.responseChecksumEnums.size(); ++i) {
-      if(checksumMatch.str(i + 1) != checksumResults[i]) {
-        throw ChimeraTK::runtime_error("Response checksum " + toStr(iInfo.responseChecksumEnums[i]) + " failed for " +
-            errorMessageDetail + ". Received \"" + std::string(checksumMatch.str(i + 1)) + "\" but calculated \"" +
-            checksumResults[i] + "\"");
-      }
+    else {
+      convertMatchedData(_readConverter);
     }
-  } // end inspectChecksum
+    this->_versionNumber = {};
+    this->_dataValidity = DataValidity::ok;
+  } // end doPostRead
 
   /********************************************************************************************************************/
 
   template<typename UserType>
-  void CommandBasedBackendRegisterAccessor<UserType>::doPostRead(
-      [[maybe_unused]] TransferType t, bool updateDataBuffer) {
-    // Transfer type enum options: {read, readNonBlocking, readLatest, write, writeDestructively }
+  template<typename Converter>
+  void CommandBasedBackendRegisterAccessor<UserType>::convertMatchedData(const Converter& converter) {
+    const auto& data = _registerRead->getMatch().data;
+    size_t nMatched = 0;
+    if(data.size() > _elementOffsetInRegister) {
+      nMatched = std::min(_numberOfElements, data.size() - _elementOffsetInRegister);
+    }
+    std::visit(
+        [&](const auto& convert) {
+          for(size_t i = 0; i < nMatched; ++i) {
+            buffer_2D[0][i] = convert(data[i + _elementOffsetInRegister]);
+          }
+        },
+        converter);
+
+    // As with unmatched regex groups, values missing in the pattern are empty.
+    if(nMatched < _numberOfElements) {
+      UserType missing = std::visit([](const auto& convert) { return convert(std::string_view()); }, _readConverter);
+      std::fill(buffer_2D[0].begin() + static_cast<std::ptrdiff_t>(nMatched), buffer_2D[0].end(), missing);
+    }
+  }
 
-    if(updateDataBuffer) {
-      std::string combinedReadString = makeCombinedReadString(_readTransferBuffer, _registerInfo.readInfo);
+  /********************************************************************************************************************/
 
-      /*--------------------------------------------------------------------------------------------------------------*/
-      // First regex match: extract the data.
-      std::smatch dataMatch;
-      if(!std::regex_match(combinedReadString, dataMatch, _readResponseDataRegex)) {
-        throw ChimeraTK::runtime_error("Could not extract data values with the read response data regex for \"" +
-            replaceNewLines(combinedReadString) + "\" in " + _registerInfo.registerPath);
+  /**
+   * @brief Decode block data elements of RawType into the user buffer. Kept as a tight loop without per element
+   * dispatch, since blocks can hold millions of elements.
+   * @param[in] payload The raw block data.
+   * @param[in] firstElement Index of the first element to decode.
+   * @param[in] swapBytes Whether the byte order of the block differs from the host's.
+   * @param[out] buffer The user buffer, which is filled completely.
+   */
+  template<typename RawType, typename UserType>
+  static void decodeBlock(
+      const std::string& payload, size_t firstElement, bool swapBytes, std::vector<UserType>& buffer) {
+    const char* element = payload.data() + firstElement * sizeof(RawType);
+    std::array<char, sizeof(RawType)> bytes{};
+    for(auto& value : buffer) {
+      if(swapBytes) {
+        std::reverse_copy(element, element + sizeof(RawType), bytes.begin());
       }
-
-      for(size_t i = 0; i < _numberOfElements; ++i) {
-        buffer_2D[0][i] =
-            _userTypeFromTransportLayerType(dataMatch.str(i + _elementOffsetInRegister + 1), _registerInfo.readInfo);
+      else {
+        std::copy(element, element + sizeof(RawType), bytes.begin());
       }
-      /*--------------------------------------------------------------------------------------------------------------*/
-      inspectChecksum(combinedReadString, _registerInfo.readInfo, _readResponseChecksumPayloadRegex,
-          _readResponseChecksumRegex, _readResponseChecksumers, "read for " + _registerInfo.registerPath);
-      /*--------------------------------------------------------------------------------------------------------------*/
-      this->_versionNumber = {};
-      this->_dataValidity = DataValidity::ok;
+      RawType raw;
+      std::memcpy(&raw, bytes.data(), sizeof(RawType));
+      value = userTypeToUserType<UserType, RawType>(raw);
+      element += sizeof(RawType);
     }
-  } // end doPostRead
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void CommandBasedBackendRegisterAccessor<UserType>::decodeBlockResponse() {
+    // The size of the payload has been checked by CommandHandler::readBlock().
+    const auto& iInfo = _registerInfo.readInfo;
+    const std::string& payload = _registerRead->getBlockPayload();
+    BlockDataType elementType = *iInfo.getResponseBlockElementType();
+
+    bool swapBytes =
+        (*iInfo.getResponseBlockByteOrder() == ByteOrder::BIG) != (std::endian::native == std::endian::big);
+    auto& buffer = buffer_2D[0];
+    switch(elementType) {
+      case BlockDataType::INT8:
+        decodeBlock<int8_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::UINT8:
+        decodeBlock<uint8_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::INT16:
+        decodeBlock<int16_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::UINT16:
+        decodeBlock<uint16_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::INT32:
+        decodeBlock<int32_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::UINT32:
+        decodeBlock<uint32_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::INT64:
+        decodeBlock<int64_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::UINT64:
+        decodeBlock<uint64_t>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::FLOAT32:
+        decodeBlock<float>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+      case BlockDataType::FLOAT64:
+        decodeBlock<double>(payload, _elementOffsetInRegister, swapBytes, buffer);
+        break;
+    }
+  } // end decodeBlockResponse
 
   /********************************************************************************************************************/
   /********************************************************************************************************************/
@@ -263,40 +301,41 @@ namespace ChimeraTK {
           _registerInfo.getRegisterName() + ").");
     }
 
-    inja::json replacePatterns;
-    replacePatterns[toStr(injaTemplatePatternKeys::DATA)] = {};
-    for(size_t i = 0; i < _numberOfElements; ++i) {
-      replacePatterns[toStr(injaTemplatePatternKeys::DATA)].push_back(
-          _transportLayerTypeFromUserType(buffer_2D[0][i], _registerInfo.writeInfo));
-    }
+    _commandData.resize(_numberOfElements);
+    std::visit(
+        [&](const auto& convert) {
+          for(size_t i = 0; i < _numberOfElements; ++i) {
+            _commandData[i] = convert(buffer_2D[0][i]);
+          }
+        },
+        _writeConverter);
 
-    // Compute the checksums
-    std::string errorMessageDetail = "in write command checksum pattern for " + _registerInfo.registerPath;
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = {};
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = {};
-    replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = {};
+    // Compute the checksums. A payload may only refer to the checksums before it, so they are appended one by one.
+    _commandChecksums.clear();
     for(size_t i = 0; i < _registerInfo.writeInfo.commandChecksumEnums.size(); ++i) {
-      std::string renderedChecksumPayload = injaRender(_registerInfo.writeInfo.commandChecksumPayloadStrs[i],
-          replacePatterns, errorMessageDetail + " on the " + std::to_string(i) + "th checksum payload.");
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)].push_back("");
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)].push_back("");
-      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)].push_back(
-          _writeCommandChecksumers[i](renderedChecksumPayload));
+      _checksumPayloadBuffer.clear();
+      _registerInfo.writeInfo.commandChecksumPayloadTemplates[i].renderInto(
+          _checksumPayloadBuffer, _commandData, _commandChecksums);
+      _plan->writeCommandChecksumers[i](_checksumPayloadBuffer, _commandChecksums.emplace_back());
     }
 
     // Form the write command with data and checksums.
-    _writeTransferBuffer = injaRender(_registerInfo.writeInfo.commandPattern, replacePatterns, errorMessageDetail);
-
     if(_registerInfo.writeInfo.isBinary()) {
-      _writeTransferBuffer = binaryStrFromHexStr(_writeTransferBuffer, /*isSigned*/ false);
+      _hexCommandBuffer.clear();
+      _registerInfo.writeInfo.commandTemplate.renderInto(_hexCommandBuffer, _commandData, _commandChecksums);
+      binaryStrFromHexStr(_hexCommandBuffer, _writeTransferBuffer, /*isSigned*/ false);
+    }
+    else {
+      _writeTransferBuffer.clear();
+      _registerInfo.writeInfo.commandTemplate.renderInto(_writeTransferBuffer, _commandData, _commandChecksums);
     }
 
     // remember this register as the last used one if the register is readable
     if(isReadable()) {
-      _backend->_lastWrittenRegister = _registerInfo.registerPath;
+      setLastWrittenRegister(_registerInfo.registerPath);
     }
     else { // if not readable use the default read register
-      _backend->_lastWrittenRegister = _backend->_defaultRecoveryRegister;
+      setLastWrittenRegister(_backend->_defaultRecoveryRegister);
     }
   } // end doPreWrite
 
@@ -309,138 +348,22 @@ namespace ChimeraTK {
       throw ChimeraTK::runtime_error("Device not functional when reading " + this->getName());
     }
 
-    std::vector<std::string> writeResponseBuffer =
-        _backend->sendCommandAndRead(_writeTransferBuffer, _registerInfo.writeInfo);
+    _backend->sendCommandAndRead(_writeTransferBuffer, _registerInfo.writeInfo, _writeResponseBuffer);
 
-    std::string combinedReadString = makeCombinedReadString(writeResponseBuffer, _registerInfo.writeInfo);
+    makeCombinedReadString(_writeResponseBuffer, _registerInfo.writeInfo, _combinedResponseBuffer);
     /*----------------------------------------------------------------------------------------------------------------*/
-    // Regex compare: Make sure the write response matches the expected pattern.
-    std::smatch payloadMatch;
-    if(!std::regex_match(combinedReadString, payloadMatch, _writeResponseDataRegex)) {
-      throw ChimeraTK::runtime_error("Write response \"" + replaceNewLines(combinedReadString) +
+    // Make sure the write response matches the expected pattern.
+    if(not _plan->writeResponseMatcher.match(_combinedResponseBuffer, _responseMatch)) {
+      throw ChimeraTK::runtime_error("Write response \"" + replaceNewLines(_combinedResponseBuffer) +
           "\" does not match the required template regex for " + _registerInfo.registerPath);
     }
     /*----------------------------------------------------------------------------------------------------------------*/
-    inspectChecksum(combinedReadString, _registerInfo.writeInfo, _writeResponseChecksumPayloadRegex,
-        _writeResponseChecksumRegex, _writeResponseChecksumers, "write for " + _registerInfo.registerPath);
+    inspectChecksum(_responseMatch, _registerInfo.writeInfo, _plan->writeResponseChecksumers, "write",
+        _registerInfo.registerPath, _checksumResultBuffer);
 
     return false; // no data was lost
   }
 
-  /********************************************************************************************************************/
-  /********************************************************************************************************************/
-
-  // For use in preWrite
-  template<typename T>
-  using enableIfIntegral = std::enable_if_t<std::is_integral<T>::value || std::is_same_v<T, ChimeraTK::Boolean>>;
-
-  // FIXME: does not know about formating. TODO ticket 13534.
-  // May need leading zeros or other formatting to satisfy the hardware interface.
-  // Do this using _registerInfo.writeInfo.fixedRegexCharacterWidthOpt in the function pointer implementation.
-
-  template<typename UserType>
-  static std::string toTransportLayerDefault(const UserType& val, [[maybe_unused]] const InteractionInfo& iInfo) {
-    return ChimeraTK::userTypeToUserType<std::string, UserType>(val);
-  }
-
-  /********************************************************************************************************************/
-
-  // This will not try to compile this if UserType is not an integer type.
-  template<typename UserType, typename = enableIfIntegral<UserType>>
-  static std::string toTransportLayerHexInt(const UserType& val, [[maybe_unused]] const InteractionInfo& iInfo) {
-    std::optional<std::string> maybeStr;
-    if(iInfo.fixedRegexCharacterWidthOpt) {
-      maybeStr = hexStrFromInt(val, *(iInfo.fixedRegexCharacterWidthOpt), iInfo.isSigned, OverflowBehavior::NULLOPT);
-    }
-    else {
-      maybeStr = hexStrFromInt(val, WidthOption::COMPACT, iInfo.isSigned);
-    }
-
-    if(not maybeStr) {
-      throw ChimeraTK::runtime_error("Unable to fit value into the fixed_width write slot");
-    }
-    return *maybeStr;
-  }
-
-  /********************************************************************************************************************/
-
-  // This will not try to compile this if UserType is not an integer type.
-  template<typename UserType, typename = enableIfFloat<UserType>>
-  static std::string toTransportLayerHexFloat(const UserType& val, [[maybe_unused]] const InteractionInfo& iInfo) {
-    return hexStrFromFloat(val);
-  }
-
-  /********************************************************************************************************************/
-  /********************************************************************************************************************/
-  // For use in postRead
-
-  template<typename UserType>
-  UserType toUserTypeDefault(const std::string& str, [[maybe_unused]] const InteractionInfo& iInfo) {
-    return ChimeraTK::userTypeToUserType<UserType, std::string>(str);
-  }
-
-  /********************************************************************************************************************/
-
-  // This will not try to compile this if UserType is not an integer type.
-  template<typename UserType, typename = enableIfIntegral<UserType>>
-  static UserType toUserTypeHexInt(const std::string& str, [[maybe_unused]] const InteractionInfo& iInfo) {
-    if(iInfo.isSigned) {
-      auto maybeInt = intFromBinaryStr<UserType>(binaryStrFromHexStr(str, iInfo.isSigned));
-      if(not maybeInt) {
-        throw ChimeraTK::runtime_error("Unable to fit the value " + str + " into the UserType for writint");
-      }
-      return *maybeInt;
-    }
-    return ChimeraTK::userTypeToUserType<UserType, std::string>("0x" + str); // only supports unsigned conversion
-  }
-  /********************************************************************************************************************/
-
-  template<typename UserType, typename = enableIfFloat<UserType>>
-  static UserType toUserTypeHexFloat(const std::string& str, [[maybe_unused]] const InteractionInfo& iInfo) {
-    auto maybeFloat = floatFromBinaryStr<UserType>(binaryStrFromHexStr(str, false));
-    if(not maybeFloat) {
-      throw ChimeraTK::runtime_error("Unable to fit the value " + str + " into the UserType for writing");
-    }
-    return *maybeFloat;
-  }
-
-  /********************************************************************************************************************/
-
-  template<typename UserType>
-  static ToUserTypeFunc<UserType> getToUserTypeFunction(TransportLayerType transportLayerType) {
-    if constexpr(std::is_integral_v<UserType>) { // toUserTypeHexInt is only defined when UserType is an integer type.
-      if((transportLayerType == TransportLayerType::BIN_INT) or (transportLayerType == TransportLayerType::HEX_INT)) {
-        return &toUserTypeHexInt<UserType>;
-      }
-    }
-    else if constexpr(std::is_floating_point_v<UserType>) {
-      if(transportLayerType == TransportLayerType::BIN_FLOAT) {
-        return &toUserTypeHexFloat<UserType>;
-      }
-    }
-    // DEC_INT, DEC_FLOAT, STRING
-    return &toUserTypeDefault<UserType>;
-  }
-
-  /********************************************************************************************************************/
-
-  template<typename UserType>
-  static ToTransportLayerFunc<UserType> getToTransportLayerFunction(TransportLayerType transportLayerType) {
-    if constexpr(std::is_integral_v<UserType>) {
-      // toTransportLayerHexInt is only defined if UserType is an integer type.
-      if((transportLayerType == TransportLayerType::HEX_INT) or (transportLayerType == TransportLayerType::BIN_INT)) {
-        return &toTransportLayerHexInt<UserType>;
-      }
-    }
-    else if constexpr(std::is_floating_point_v<UserType>) {
-      if(transportLayerType == TransportLayerType::BIN_FLOAT) {
-        return &toTransportLayerHexFloat<UserType>;
-      }
-    }
-    // DEC_INT, DEC_FLOAT, STRING
-    return &toTransportLayerDefault<UserType>;
-  }
-
   /********************************************************************************************************************/
   // Magic from SupportedUserTypes.h
   INSTANTIATE_TEMPLATE_FOR_CHIMERATK_USER_TYPES(CommandBasedBackendRegisterAccessor);
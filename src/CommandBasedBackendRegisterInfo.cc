@@ -103,6 +103,15 @@ namespace ChimeraTK {
   static void throwIfBadChecksums(
       const CommandBasedBackendRegisterInfo& regInfo, const std::string& errorMessageDetail);
 
+  /**
+   * @brief Validates that block data is only used for reading, and without a response pattern or response checksums.
+   * @param[in] regInfo The CommandBasedBackendRegisterInfo to validate.
+   * @param[in] errorMessageDetail Specifies the registerPath, and maybe other details to orient error messages.
+   * @throws ChimeraTK::logic_error
+   */
+  static void throwIfBadBlockData(
+      const CommandBasedBackendRegisterInfo& regInfo, const std::string& errorMessageDetail);
+
   /*
    * Get the DataType best suited to the InteractionInfo info.
    * This considers iInfo.isSigned, and the fixedRegexCharacterWidthOpt
@@ -136,6 +145,13 @@ namespace ChimeraTK {
   static void setNElementsFromJson(
       CommandBasedBackendRegisterInfo& rInfo, const json& j, const std::string& errorMessageDetail);
 
+  /**
+   * @brief Sets the pollInterval from JSON, if present.
+   * @throws ChimeraTK::logic_error if the interval is not a positive number of milliseconds.
+   */
+  static void setPollIntervalFromJson(
+      CommandBasedBackendRegisterInfo& rInfo, const json& j, const std::string& errorMessageDetail);
+
   /**
    * @brief Sets the iInfo.TransportLayerType from JSON, if present, with type checking.
    * This must be a template to accomdate keys at the register level and the interaction level.
@@ -204,6 +220,20 @@ namespace ChimeraTK {
   template<typename EnumType>
   static void setChecksumsFromJson(InteractionInfo& iInfo, const json& j, const std::string& errorMessageDetail);
 
+  /**
+   * @brief Switch the response to block data if BLOCK_DATA is set, taking over the response delimiter as terminator.
+   * Must come after setEndingsFromJson.
+   * @param[in] j nlohmann::json of the interaction from the map file
+   * @param[in] errorMessageDetail Specifies the registerPath, and maybe other details to orient error messages.
+   * @throws ChimeraTK::logic_error for unknown element types or byte orders, or if mixed with read-lines or read-bytes.
+   */
+  static void setBlockDataFromJson(InteractionInfo& iInfo, const json& j, const std::string& errorMessageDetail);
+
+  /**
+   * @brief The read settings with the unsolicited pattern as response pattern. Unsolicited lines have no checksums.
+   */
+  static InteractionInfo makeUnsolicitedInfo(const InteractionInfo& readInfo, const std::string& unsolicitedPattern);
+
   /********************************************************************************************************************/
   /********************************************************************************************************************/
 
@@ -225,6 +255,30 @@ namespace ChimeraTK {
     throwIfBadSigned(writeInfo, errorMessageDetailWrite);
     throwIfBadSigned(readInfo, errorMessageDetailRead);
     throwIfBadChecksums(*this, errorMessageDetail);
+    throwIfBadBlockData(*this, errorMessageDetail);
+    if(pollInterval and not readInfo.isActive()) {
+      throw ChimeraTK::logic_error(
+          toStr(mapFileRegisterKeys::POLL_INTERVAL) + " is set for the non-readable " + errorMessageDetail);
+    }
+    if(not unsolicitedPattern.empty()) {
+      // The read command provides the initial value upon activation, and synchronous reads.
+      if(not readInfo.isActive()) {
+        throw ChimeraTK::logic_error(toStr(mapFileRegisterKeys::UNSOLICITED) + " requires a read " +
+            toStr(mapFileInteractionInfoKeys::COMMAND) + " for " + errorMessageDetail);
+      }
+      // Unsolicited lines are read as text lines with the default delimiter.
+      if(readInfo.isBinary() or readInfo.usesReadBlock()) {
+        throw ChimeraTK::logic_error(toStr(mapFileRegisterKeys::UNSOLICITED) +
+            " is not supported for binary or block data types in " + errorMessageDetail);
+      }
+      auto unsolicitedInfo = makeUnsolicitedInfo(readInfo, unsolicitedPattern);
+      size_t nMarks = getResponseDataRegex(unsolicitedInfo, "unsolicited lines for " + registerPath).mark_count();
+      if(nMarks != getNumberOfElementsImpl()) {
+        throw ChimeraTK::logic_error("Wrong number of capture groups " + std::to_string(nMarks) + " (" +
+            std::to_string(getNumberOfElementsImpl()) + " required) in " + toStr(mapFileRegisterKeys::UNSOLICITED) +
+            " \"" + unsolicitedPattern + "\" for " + errorMessageDetail);
+      }
+    }
   }
 
   /********************************************************************************************************************/
@@ -236,6 +290,17 @@ namespace ChimeraTK {
 
     // Check that the data types are compatible and set dataDescriptor
     dataDescriptor = DataDescriptor(getDataType(writeInfo, readInfo, errorMessageDetail));
+
+    // The block header must announce exactly the elements of the register.
+    if(readInfo.usesReadBlock()) {
+      readInfo.setResponseBlockBytes(getNumberOfElementsImpl() * getByteWidth(*readInfo.getResponseBlockElementType()));
+    }
+
+    // Parse the command patterns once here, instead of on every transfer.
+    readInfo.compileCommandTemplates("read command pattern of " + errorMessageDetail);
+    writeInfo.compileCommandTemplates("write command pattern of " + errorMessageDetail);
+    // Most read commands are constant. Then even the checksums and the binary conversion can be done here.
+    readInfo.foldConstantCommand();
   } // end init
 
   /********************************************************************************************************************/
@@ -254,8 +319,8 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
-  CommandBasedBackendRegisterInfo::CommandBasedBackendRegisterInfo(
-      const RegisterPath& registerPath_, const json& j, const std::string& defaultSerialDelimiter)
+  CommandBasedBackendRegisterInfo::CommandBasedBackendRegisterInfo(const RegisterPath& registerPath_, const json& j,
+      const std::string& defaultSerialDelimiter, std::optional<std::chrono::milliseconds> defaultPollInterval)
   : registerPath(registerPath_) {
     /*
      * Here we extract data from the json,
@@ -276,6 +341,12 @@ namespace ChimeraTK {
     // N_ELEM,
     setNElementsFromJson(*this, j, errorMessageDetail);
 
+    // POLL_INTERVAL
+    setPollIntervalFromJson(*this, j, errorMessageDetail);
+
+    // UNSOLICITED
+    unsolicitedPattern = caseInsensitiveGetValueOr(j, toStr(mapFileRegisterKeys::UNSOLICITED), "");
+
     // TYPE
     setTypeFromJson<mapFileRegisterKeys>(readInfo, j, errorMessageDetail);
     setTypeFromJson<mapFileRegisterKeys>(writeInfo, j, errorMessageDetail);
@@ -320,6 +391,9 @@ namespace ChimeraTK {
     if(writeOpt) {
       writeInfo.populateFromJson(writeOpt->get<json>(), errorMessageDetailWrite, true);
     }
+    if(not pollInterval and readInfo.isActive()) {
+      pollInterval = defaultPollInterval;
+    }
     /*----------------------------------------------------------------------------------------------------------------*/
     // FIXME: extract the number of lines in write response from pattern; Ticket 13531
 
@@ -373,10 +447,46 @@ namespace ChimeraTK {
 
     // CMD_CHECKSUM, RESP_CHECKSUM
     setChecksumsFromJson<mapFileInteractionInfoKeys>(*this, j, errorMessageDetail);
+
+    // BLOCK_DATA, BLOCK_BYTE_ORDER
+    setBlockDataFromJson(*this, j, errorMessageDetail);
   } // populateFromJson
 
   /********************************************************************************************************************/
 
+  void InteractionInfo::compileCommandTemplates(const std::string& errorMessageDetail) {
+    commandTemplate = CommandTemplate(commandPattern, errorMessageDetail);
+    commandChecksumPayloadTemplates.clear();
+    for(size_t i = 0; i < commandChecksumPayloadStrs.size(); ++i) {
+      commandChecksumPayloadTemplates.emplace_back(
+          commandChecksumPayloadStrs[i], errorMessageDetail + " on the " + std::to_string(i) + "th checksum payload");
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void InteractionInfo::foldConstantCommand() {
+    constantCommand = std::nullopt;
+    if(not isActive() or not commandTemplate.isDataIndependent()) {
+      return;
+    }
+    try {
+      auto checksumers = makeChecksumers(interactionType::CMD, *this);
+      std::vector<std::string> checksums;
+      for(size_t i = 0; i < commandChecksumEnums.size(); ++i) {
+        // The raw payload, like RegisterReadTransferElement, so the folded command is the same as the unfolded one.
+        checksums.push_back(checksumers[i](commandChecksumPayloadStrs[i]));
+      }
+      std::string command = commandTemplate.render({}, checksums);
+      constantCommand = isBinary() ? binaryStrFromHexStr(command, /*isSigned*/ false) : std::move(command);
+    }
+    catch(const ChimeraTK::runtime_error&) {
+      // Leave it to the transfer to report the error, as for commands which are not constant.
+    }
+  }
+
+  /********************************************************************************************************************/
+
   std::optional<size_t> InteractionInfo::getResponseNLines() const noexcept {
     if(usesReadLines()) {
       return std::get<ResponseLinesInfo>(_responseInfo).nLines;
@@ -404,6 +514,48 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  std::optional<BlockDataType> InteractionInfo::getResponseBlockElementType() const noexcept {
+    if(usesReadBlock()) {
+      return std::get<ResponseBlockInfo>(_responseInfo).elementType;
+    }
+    return std::nullopt;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<ByteOrder> InteractionInfo::getResponseBlockByteOrder() const noexcept {
+    if(usesReadBlock()) {
+      return std::get<ResponseBlockInfo>(_responseInfo).byteOrder;
+    }
+    return std::nullopt;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<std::string> InteractionInfo::getResponseBlockTerminator() const noexcept {
+    if(usesReadBlock()) {
+      return std::get<ResponseBlockInfo>(_responseInfo).terminator;
+    }
+    return std::nullopt;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<size_t> InteractionInfo::getResponseBlockBytes() const noexcept {
+    if(usesReadBlock()) {
+      return std::get<ResponseBlockInfo>(_responseInfo).nBytes;
+    }
+    return std::nullopt;
+  }
+
+  /********************************************************************************************************************/
+
+  void InteractionInfo::setResponseBlockBytes(size_t nBytes) {
+    std::get<ResponseBlockInfo>(_responseInfo).nBytes = nBytes;
+  }
+
+  /********************************************************************************************************************/
+
   std::string InteractionInfo::getRegexString() const {
     // Note, these regex's must be parentheses-bound capture groups
     TransportLayerType type = getTransportLayerType();
@@ -527,12 +679,14 @@ namespace ChimeraTK {
     // Alignment between the mark_count and nElements can be enforced by using non-capture groups: (?:   )
     size_t nReadResponseMarks = regInfo.getReadResponseDataRegex().mark_count();
     size_t nExpectedMarks;
-    if(readInfo.isActive() and (regInfo.readInfo.getTransportLayerType() != TransportLayerType::VOID)) {
+    if(readInfo.isActive() and (regInfo.readInfo.getTransportLayerType() != TransportLayerType::VOID) and
+        not readInfo.usesReadBlock()) {
       nExpectedMarks = regInfo.getNumberOfElementsImpl();
     }
     else {
       /* nElements = 1 when the type is void, even though no return marks are expected.
-       * Also, if it's a write-only register, expect 0 reading marks
+       * Also, if it's a write-only register, expect 0 reading marks.
+       * Block data has no response pattern at all, which is checked in throwIfBadBlockData.
        */
       nExpectedMarks = 0;
     }
@@ -773,6 +927,29 @@ namespace ChimeraTK {
         regInfo.getReadResponseChecksumPayloadRegex().mark_count(), errorMessageDetail + " for read");
   }
 
+  /********************************************************************************************************************/
+
+  static void throwIfBadBlockData(
+      const CommandBasedBackendRegisterInfo& regInfo, const std::string& errorMessageDetail) {
+    if(regInfo.writeInfo.usesReadBlock()) {
+      throw ChimeraTK::logic_error(FUNC_NAME + toStr(mapFileInteractionInfoKeys::BLOCK_DATA) +
+          " is only supported for read, but is set for write for " + errorMessageDetail);
+    }
+    const InteractionInfo& readInfo = regInfo.readInfo;
+    if(not readInfo.usesReadBlock()) {
+      return;
+    }
+    if(not readInfo.responsePattern.empty() or not readInfo.responseChecksumEnums.empty()) {
+      throw ChimeraTK::logic_error(FUNC_NAME + "The read response is " + toStr(mapFileInteractionInfoKeys::BLOCK_DATA) +
+          ", so there must be no read " + toStr(mapFileInteractionInfoKeys::RESPESPONSE) + " or " +
+          toStr(mapFileInteractionInfoKeys::RESP_CHECKSUM) + " for " + errorMessageDetail);
+    }
+    if(readInfo.getTransportLayerType() == TransportLayerType::VOID) {
+      throw ChimeraTK::logic_error(FUNC_NAME + "Void type cannot have " +
+          toStr(mapFileInteractionInfoKeys::BLOCK_DATA) + " for " + errorMessageDetail);
+    }
+  } // end throwIfBadBlockData
+
   /********************************************************************************************************************/
   /********************************************************************************************************************/
 
@@ -825,6 +1002,23 @@ namespace ChimeraTK {
    * returns the smallest datatype that meets those needs.
    */
   static DataType getDataType(const InteractionInfo& iInfo) {
+    // Block data elements have their own type, the transport layer type only applies to the command.
+    if(auto blockType = iInfo.getResponseBlockElementType()) {
+      static const std::map<BlockDataType, DataType> blockDataTypeMap = {
+          {BlockDataType::INT8, DataType::int8},
+          {BlockDataType::UINT8, DataType::uint8},
+          {BlockDataType::INT16, DataType::int16},
+          {BlockDataType::UINT16, DataType::uint16},
+          {BlockDataType::INT32, DataType::int32},
+          {BlockDataType::UINT32, DataType::uint32},
+          {BlockDataType::INT64, DataType::int64},
+          {BlockDataType::UINT64, DataType::uint64},
+          {BlockDataType::FLOAT32, DataType::float32},
+          {BlockDataType::FLOAT64, DataType::float64},
+      };
+      return blockDataTypeMap.at(*blockType);
+    }
+
     const TransportLayerType type = iInfo.getTransportLayerType();
     const bool isSigned = iInfo.isSigned;
     const auto& map = (isSigned ? signedTransportLayerTypeToDataTypeMap : unsignedTransportLayerTypeToDataTypeMap);
@@ -967,6 +1161,22 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  static void setPollIntervalFromJson(
+      CommandBasedBackendRegisterInfo& rInfo, const json& j, const std::string& errorMessageDetail) {
+    std::string keyStr = toStr(mapFileRegisterKeys::POLL_INTERVAL);
+    auto intervalOpt = caseInsensitiveGetValueOption(j, keyStr);
+    if(not intervalOpt) {
+      return;
+    }
+    if(not intervalOpt->is_number_integer() or intervalOpt->get<int64_t>() < 1) {
+      throw ChimeraTK::logic_error(FUNC_NAME + "Invalid " + keyStr + " " + intervalOpt->dump() + " for " +
+          errorMessageDetail + ", expected a positive number of milliseconds");
+    }
+    rInfo.pollInterval = std::chrono::milliseconds(intervalOpt->get<int64_t>());
+  } // end setPollIntervalFromJson
+
+  /********************************************************************************************************************/
+
   template<typename EnumType>
   static void setTypeFromJson(InteractionInfo& iInfo, const json& j, const std::string& errorMessageDetail) {
     std::string keyStr = toStr(EnumType::TYPE);
@@ -1218,6 +1428,50 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  static void setBlockDataFromJson(InteractionInfo& iInfo, const json& j, const std::string& errorMessageDetail) {
+    const std::string blockKeyStr = toStr(mapFileInteractionInfoKeys::BLOCK_DATA);
+    const std::string byteOrderKeyStr = toStr(mapFileInteractionInfoKeys::BLOCK_BYTE_ORDER);
+    auto blockOpt = caseInsensitiveGetValueOption(j, blockKeyStr);
+    auto byteOrderOpt = caseInsensitiveGetValueOption(j, byteOrderKeyStr);
+    if(not blockOpt) {
+      if(byteOrderOpt) {
+        throw ChimeraTK::logic_error(
+            FUNC_NAME + byteOrderKeyStr + " requires " + blockKeyStr + " to be set for " + errorMessageDetail);
+      }
+      return;
+    }
+
+    for(auto key : {mapFileInteractionInfoKeys::N_RESPONSE_LINES, mapFileInteractionInfoKeys::N_RESPONSE_BYTES}) {
+      if(caseInsensitiveGetValueOption(j, toStr(key))) {
+        throw ChimeraTK::logic_error(
+            FUNC_NAME + "Invalid mixture of " + blockKeyStr + " and " + toStr(key) + " for " + errorMessageDetail);
+      }
+    }
+
+    std::string typeStr = blockOpt->get<std::string>();
+    auto elementType = getEnumOptFromStrMapCaseInsensitive(typeStr, getMapForEnum<BlockDataType>());
+    if(not elementType) {
+      throw ChimeraTK::logic_error(
+          FUNC_NAME + "Unknown value " + typeStr + " for " + blockKeyStr + " - " + errorMessageDetail);
+    }
+
+    ByteOrder byteOrder = ByteOrder::BIG;
+    if(byteOrderOpt) {
+      std::string byteOrderStr = byteOrderOpt->get<std::string>();
+      auto byteOrderEnumOpt = getEnumOptFromStrMapCaseInsensitive(byteOrderStr, getMapForEnum<ByteOrder>());
+      if(not byteOrderEnumOpt) {
+        throw ChimeraTK::logic_error(
+            FUNC_NAME + "Unknown value " + byteOrderStr + " for " + byteOrderKeyStr + " - " + errorMessageDetail);
+      }
+      byteOrder = *byteOrderEnumOpt;
+    }
+
+    // Devices end the response message after the block, typically with a newline.
+    iInfo.setResponseBlock(*elementType, byteOrder, iInfo.getResponseLinesDelimiter().value_or(""));
+  } // end setBlockDataFromJson
+
+  /********************************************************************************************************************/
+
   // Operators for cout << InteractionInfo
   std::ostream& operator<<(std::ostream& os, const InteractionInfo& iInfo) {
     return os << "isActive: " << iInfo.isActive() << ", isBinary: " << iInfo.isBinary() << ", transportLayerType: "
@@ -1236,6 +1490,8 @@ namespace ChimeraTK {
               << " getResponseLinesDelimiter: \""
               << (iInfo.usesReadLines() ? replaceNewLines(iInfo.getResponseLinesDelimiter().value()) : "nullopt")
               << "\", getResponseBytes: " << (iInfo.usesReadBytes() ? (int)iInfo.getResponseBytes().value() : -1)
+              << ", getResponseBlockElementType: "
+              << (iInfo.usesReadBlock() ? toStr(iInfo.getResponseBlockElementType().value()) : "nullopt")
               << ", fixedRegexCharacterWidthOpt: "
               << (iInfo.fixedRegexCharacterWidthOpt ? (int)iInfo.fixedRegexCharacterWidthOpt.value() : -1)
               << ", fractionalBitsOpt: " << (iInfo.fractionalBitsOpt ? (int)iInfo.fractionalBitsOpt.value() : -1);
@@ -1256,11 +1512,11 @@ namespace ChimeraTK {
     }
 
     // Fill checksum components
-    if(not info.commandChecksumEnums.empty()) {
+    if(not info.responseChecksumEnums.empty()) {
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = {};
-      for(const auto& cs : info.commandChecksumEnums) {
+      for(const auto& cs : info.responseChecksumEnums) {
         // render the checksum start and end tags as empty.
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)].push_back("");
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)].push_back("");
@@ -1289,12 +1545,12 @@ namespace ChimeraTK {
     }
 
     // Fill checksum components
-    size_t nCS = info.commandChecksumEnums.size();
+    size_t nCS = info.responseChecksumEnums.size();
     if(nCS > 0) {
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = {};
-      for(const auto& cs : info.commandChecksumEnums) {
+      for(const auto& cs : info.responseChecksumEnums) {
         // render the checksum start and end tags as empty.
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)].push_back("");
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)].push_back("");
@@ -1322,12 +1578,12 @@ namespace ChimeraTK {
     }
 
     // Fill checksum components
-    size_t nCS = info.commandChecksumEnums.size();
+    size_t nCS = info.responseChecksumEnums.size();
     if(nCS > 0) {
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = {};
       replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = {};
-      for(const auto& cs : info.commandChecksumEnums) {
+      for(const auto& cs : info.responseChecksumEnums) {
         // render the checksum start and end tags as the beginning and end of regex capture groups
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)].push_back("(");
         replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)].push_back(")");
@@ -1344,4 +1600,33 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  static InteractionInfo makeUnsolicitedInfo(const InteractionInfo& readInfo, const std::string& unsolicitedPattern) {
+    InteractionInfo unsolicitedInfo = readInfo;
+    unsolicitedInfo.responsePattern = unsolicitedPattern;
+    unsolicitedInfo.responseChecksumEnums.clear();
+    return unsolicitedInfo;
+  }
+
+  /********************************************************************************************************************/
+
+  ResponseMatcher CommandBasedBackendRegisterInfo::getUnsolicitedResponseMatcher() const {
+    return getResponseMatcher(
+        makeUnsolicitedInfo(readInfo, unsolicitedPattern), "unsolicited lines for " + registerPath);
+  }
+
+  /********************************************************************************************************************/
+
+  ResponseMatcher CommandBasedBackendRegisterInfo::getResponseMatcher(
+      const InteractionInfo& info, const std::string& errorMessageDetail) const {
+    ResponseMatcher matcher(info.responsePattern, info.getTransportLayerType(), info.fixedRegexCharacterWidthOpt,
+        info.responseChecksumEnums, getNumberOfElementsImpl());
+    if(not matcher.isCompiled()) {
+      matcher.setFallbackRegexes(getResponseDataRegex(info, errorMessageDetail),
+          getResponseChecksumPayloadRegex(info, errorMessageDetail), getResponseChecksumRegex(info, errorMessageDetail));
+    }
+    return matcher;
+  }
+
+  /********************************************************************************************************************/
+
 } // namespace ChimeraTK
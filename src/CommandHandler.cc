@@ -2,7 +2,11 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CommandHandler.h"
 
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <string>
 #include <variant>
 
@@ -27,3 +31,61 @@ std::string CommandHandler::toStringGuarded(const Delimiter& delimOption) const
   assert(not s.empty());
   return s;
 }
+
+/**********************************************************************************************************************/
+
+const std::string& CommandHandler::appendWriteDelimiter(std::string_view cmd, const Delimiter& writeDelimiter) {
+  _sendBuffer.assign(cmd);
+  if(std::holds_alternative<CommandHandlerDefaultDelimiter>(writeDelimiter)) {
+    _sendBuffer += delimiter;
+  }
+  else {
+    _sendBuffer += std::get<std::string>(writeDelimiter);
+  }
+  return _sendBuffer;
+}
+
+/**********************************************************************************************************************/
+
+std::string CommandHandler::readBlock(
+    const std::function<std::string(size_t)>& readBytes, size_t nBytesExpected, const std::string& terminator) {
+  auto isDigit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+
+  std::string header = readBytes(2);
+  if(header[0] != '#' or not isDigit(header[1])) {
+    throw ChimeraTK::runtime_error("Invalid block data header \"" + header + "\", expected '#' and a digit.");
+  }
+  auto nDigits = static_cast<size_t>(header[1] - '0');
+  if(nDigits == 0) {
+    throw ChimeraTK::runtime_error("Indefinite length block data (#0) is not supported.");
+  }
+
+  std::string lengthStr = readBytes(nDigits);
+  size_t length = 0;
+  for(char c : lengthStr) {
+    if(not isDigit(c)) {
+      throw ChimeraTK::runtime_error("Invalid block data length \"" + lengthStr + "\".");
+    }
+    length = 10 * length + static_cast<size_t>(c - '0');
+  }
+  // Do not trust the header with the size of the read, a corrupted length could make it wait for gigabytes.
+  if(length != nBytesExpected) {
+    throw ChimeraTK::runtime_error("Block data header announces " + std::to_string(length) + " bytes, but " +
+        std::to_string(nBytesExpected) + " are expected.");
+  }
+
+  std::string payload = (length > 0) ? readBytes(length) : std::string();
+
+  if(not terminator.empty() and readBytes(terminator.size()) != terminator) {
+    throw ChimeraTK::runtime_error(
+        "Block data of " + std::to_string(length) + " bytes is not followed by the terminator.");
+  }
+  return payload;
+}
+
+/**********************************************************************************************************************/
+
+std::chrono::milliseconds CommandHandler::getRemainingTime(Clock::time_point deadline) {
+  auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+  return std::max(remaining, std::chrono::milliseconds(0));
+}
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "CommandPipeline.h"
+
+#include <cassert>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  CommandPipeline::CommandPipeline(size_t depth, std::chrono::milliseconds timeout)
+  : _depth(depth), _timeout(timeout) {
+    assert(_depth > 0);
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandPipeline::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    assert(_nowServing == _nextTicket);
+    _hasFailed = false;
+    _failure.clear();
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandPipeline::finishTurn(const char* failure) {
+    if(failure and not _hasFailed) {
+      _hasFailed = true;
+      _failure = failure;
+    }
+    ++_nowServing;
+    _changed.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandPipeline::throwAfterFailure() const {
+    throw ChimeraTK::runtime_error(
+        "Command not transferred, since an earlier pipelined command has failed: " + _failure);
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
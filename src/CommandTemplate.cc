@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "CommandTemplate.h"
+
+#include "injaUtils.h"
+#include "mapFileKeys.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace ChimeraTK {
+  /********************************************************************************************************************/
+
+  CommandTemplate::CommandTemplate(std::string injaTemplate, std::string errorMessageDetail)
+  : _injaTemplate(std::move(injaTemplate)), _errorMessageDetail(std::move(errorMessageDetail)) {
+    static const std::string dataKey = toStr(injaTemplatePatternKeys::DATA);
+    static const std::string csStartKey = toStr(injaTemplatePatternKeys::CHECKSUM_START);
+    static const std::string csEndKey = toStr(injaTemplatePatternKeys::CHECKSUM_END);
+    static const std::string csPointKey = toStr(injaTemplatePatternKeys::CHECKSUM_POINT);
+
+    if(usesInjaStatements(_injaTemplate)) {
+      _useInja = true;
+      return;
+    }
+
+    std::string literal;
+    auto flushLiteral = [&]() {
+      if(not literal.empty()) {
+        _segments.push_back({SegmentType::LITERAL, std::move(literal), 0});
+        literal.clear();
+      }
+    };
+    auto updateMax = [](size_t& max, size_t index) { max = (max == noIndex) ? index : std::max(max, index); };
+
+    size_t pos = 0;
+    while(pos < _injaTemplate.size()) {
+      size_t tagPos = _injaTemplate.find("{{", pos);
+      literal.append(_injaTemplate, pos, tagPos - pos); // npos - pos appends the rest
+      if(tagPos == std::string::npos) {
+        break;
+      }
+      auto tag = parseSimpleInjaTag(_injaTemplate, tagPos);
+      if(not tag) {
+        _useInja = true;
+        _segments.clear();
+        return;
+      }
+      if(tag->key == dataKey) {
+        flushLiteral();
+        _segments.push_back({SegmentType::DATA, {}, tag->index});
+        updateMax(_maxDataIndex, tag->index);
+      }
+      else if(tag->key == csPointKey) {
+        flushLiteral();
+        _segments.push_back({SegmentType::CHECKSUM_POINT, {}, tag->index});
+        updateMax(_maxChecksumIndex, tag->index);
+      }
+      else if(tag->key != csStartKey and tag->key != csEndKey) {
+        // Unknown variable: let inja produce the usual error message.
+        _useInja = true;
+        _segments.clear();
+        return;
+      }
+      pos = tagPos + tag->length;
+    }
+    flushLiteral();
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandTemplate::renderInto(
+      std::string& output, const std::vector<std::string>& data, const std::vector<std::string>& checksums) const {
+    if(_useInja) {
+      inja::json replacePatterns;
+      replacePatterns[toStr(injaTemplatePatternKeys::DATA)] = data;
+      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_START)] = std::vector<std::string>(checksums.size());
+      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_END)] = std::vector<std::string>(checksums.size());
+      replacePatterns[toStr(injaTemplatePatternKeys::CHECKSUM_POINT)] = checksums;
+      output += injaRender(_injaTemplate, replacePatterns, _errorMessageDetail);
+      return;
+    }
+
+    // Check once up front, so the loop below does not need to.
+    if(_maxDataIndex != noIndex and _maxDataIndex >= data.size()) {
+      throwMissingValue(toStr(injaTemplatePatternKeys::DATA), _maxDataIndex);
+    }
+    if(_maxChecksumIndex != noIndex and _maxChecksumIndex >= checksums.size()) {
+      throwMissingValue(toStr(injaTemplatePatternKeys::CHECKSUM_POINT), _maxChecksumIndex);
+    }
+
+    for(const auto& segment : _segments) {
+      switch(segment.type) {
+        case SegmentType::LITERAL:
+          output += segment.literal;
+          break;
+        case SegmentType::DATA:
+          output += data[segment.index];
+          break;
+        case SegmentType::CHECKSUM_POINT:
+          output += checksums[segment.index];
+          break;
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::string CommandTemplate::render(
+      const std::vector<std::string>& data, const std::vector<std::string>& checksums) const {
+    std::string output;
+    renderInto(output, data, checksums);
+    return output;
+  }
+
+  /********************************************************************************************************************/
+
+  void CommandTemplate::throwMissingValue(const std::string& key, size_t index) const {
+    throw ChimeraTK::runtime_error("CommandTemplate: variable '" + key + "." + std::to_string(index) +
+        "' not found for " + _errorMessageDetail + " with inja template " + _injaTemplate);
+  }
+
+  /********************************************************************************************************************/
+} // namespace ChimeraTK
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "CompiledRegisterPlan.h"
+
+#include <utility>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  CompiledRegisterPlan::CompiledRegisterPlan(CommandBasedBackendRegisterInfo info)
+  : registerInfo(std::move(info)),
+    readResponseMatcher(
+        registerInfo.readInfo.isActive() ? registerInfo.getReadResponseMatcher() : ResponseMatcher{}),
+    readCommandChecksumers(registerInfo.readInfo.isActive() ?
+            makeChecksumers(interactionType::CMD, registerInfo.readInfo) :
+            std::vector<Checksumer>{}),
+    readResponseChecksumers(registerInfo.readInfo.isActive() ?
+            makeChecksumers(interactionType::RESP, registerInfo.readInfo) :
+            std::vector<Checksumer>{}),
+    readBinaryLayout(makeReadBinaryLayout(registerInfo, readResponseMatcher)),
+    writeResponseMatcher(registerInfo.isWriteable() ? registerInfo.getWriteResponseMatcher() : ResponseMatcher{}),
+    writeCommandChecksumers(registerInfo.isWriteable() ?
+            makeChecksumers(interactionType::CMD, registerInfo.writeInfo) :
+            std::vector<Checksumer>{}),
+    writeResponseChecksumers(registerInfo.isWriteable() ?
+            makeChecksumers(interactionType::RESP, registerInfo.writeInfo) :
+            std::vector<Checksumer>{}),
+    unsolicitedResponseMatcher(registerInfo.unsolicitedPattern.empty() ?
+            std::nullopt :
+            std::make_optional(registerInfo.getUnsolicitedResponseMatcher())) {}
+
+  /********************************************************************************************************************/
+
+  std::optional<ResponseMatcher::BinaryLayout> CompiledRegisterPlan::makeReadBinaryLayout(
+      const CommandBasedBackendRegisterInfo& info, const ResponseMatcher& matcher) {
+    // Binary responses read line by line have the delimiter in their hex text, so only byte reads qualify.
+    if(not info.readInfo.isActive() or not info.readInfo.isBinary() or not info.readInfo.usesReadBytes()) {
+      return std::nullopt;
+    }
+    auto layout = matcher.getBinaryLayout();
+    // With a different length, the response can never match; leave the error to the regular path.
+    if(not layout or layout->nBytes != info.readInfo.getResponseBytes()) {
+      return std::nullopt;
+    }
+    return layout;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "CompoundReadTransferElement.h"
+
+#include "CommandBasedBackend.h"
+#include "stringUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string_view>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  CompoundReadTransferElement::CompoundReadTransferElement(
+      const CompoundCommandSettings& settings, RegisterRead registerRead)
+  : TransferElement("compound read of " + registerRead->getName(), AccessModeFlags{}),
+    _backend(registerRead->getBackend()), _settings(settings) {
+    assert(isMergeable(getReadInfo(*registerRead)));
+    this->_exceptionBackend = _backend;
+    _response.resize(1);
+    add(std::move(registerRead));
+  }
+
+  /********************************************************************************************************************/
+
+  bool CompoundReadTransferElement::isMergeable(const InteractionInfo& readInfo) {
+    return readInfo.isActive() and not readInfo.isBinary() and readInfo.constantCommand.has_value() and
+        readInfo.usesReadLines() and readInfo.getResponseNLines() == 1;
+  }
+
+  /********************************************************************************************************************/
+
+  bool CompoundReadTransferElement::mayAdopt(
+      const CompoundReadTransferElement& owner, const RegisterReadTransferElement& registerRead) const {
+    if(&owner == this or _backend != owner._backend or _registers.empty() or
+        _registers.size() < owner._registers.size()) {
+      return false;
+    }
+    if(_settings.maxCommands != 0 and _registers.size() >= _settings.maxCommands) {
+      return false;
+    }
+    const auto& readInfo = getReadInfo(registerRead);
+    if(_settings.maxLength != 0 and
+        _command.size() + _settings.separator.size() + readInfo.constantCommand->size() > _settings.maxLength) {
+      return false;
+    }
+    // Only the last response may contain the separator.
+    if(mayContainSeparator(registerRead) and mayContainSeparator(*_registers.back())) {
+      return false;
+    }
+    // All commands go into one line, and all responses come in one line.
+    const auto& firstReadInfo = getReadInfo(*_registers.front());
+    return readInfo.cmdLineDelimiter == firstReadInfo.cmdLineDelimiter and
+        readInfo.getResponseLinesDelimiter() == firstReadInfo.getResponseLinesDelimiter();
+  }
+
+  /********************************************************************************************************************/
+
+  CompoundReadTransferElement::RegisterRead CompoundReadTransferElement::find(const CompiledRegisterPlan& plan) const {
+    for(const auto& registerRead : _registers) {
+      if(registerRead->getPlan().get() == &plan) {
+        return registerRead;
+      }
+    }
+    return {};
+  }
+
+  /********************************************************************************************************************/
+
+  void CompoundReadTransferElement::add(RegisterRead registerRead) {
+    auto position = _registers.end();
+    if(not _registers.empty() and mayContainSeparator(*_registers.back()) and not mayContainSeparator(*registerRead)) {
+      --position; // keep the response which may contain the separator last
+    }
+    _registers.insert(position, std::move(registerRead));
+    updateCommand();
+  }
+
+  /********************************************************************************************************************/
+
+  void CompoundReadTransferElement::remove(const RegisterRead& registerRead) {
+    _registers.erase(std::remove(_registers.begin(), _registers.end(), registerRead), _registers.end());
+    updateCommand();
+  }
+
+  /********************************************************************************************************************/
+
+  void CompoundReadTransferElement::updateCommand() {
+    _command.clear();
+    for(const auto& registerRead : _registers) {
+      if(not _command.empty()) {
+        _command += _settings.separator;
+      }
+      _command += *getReadInfo(*registerRead).constantCommand;
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  bool CompoundReadTransferElement::mayContainSeparator(const RegisterReadTransferElement& registerRead) const {
+    const auto& readInfo = getReadInfo(registerRead);
+    return readInfo.getTransportLayerType() == TransportLayerType::STRING or
+        readInfo.responsePattern.find(_settings.responseSeparator) != std::string::npos;
+  }
+
+  /********************************************************************************************************************/
+
+  void CompoundReadTransferElement::doReadTransferSynchronously() {
+    if(not _backend->isFunctional()) {
+      throw ChimeraTK::runtime_error("Device not functional when reading " + this->getName());
+    }
+    assert(not _registers.empty());
+
+    _backend->sendCommandAndRead(_command, getReadInfo(*_registers.front()), _response);
+
+    // The last response takes the rest of the line, so only the others must not contain the separator, see add().
+    std::string_view line = _response[0];
+    for(size_t i = 0; i < _registers.size(); ++i) {
+      size_t end = line.size();
+      if(i + 1 < _registers.size()) {
+        end = line.find(_settings.responseSeparator);
+        if(end == std::string_view::npos) {
+          throw ChimeraTK::runtime_error("Response \"" + replaceNewLines(_response[0]) +
+              "\" to the compound command \"" + _command + "\" has " + std::to_string(i + 1) + " parts instead of " +
+              std::to_string(_registers.size()));
+        }
+      }
+      _registers[i]->parseResponseLine(line.substr(0, end));
+      line.remove_prefix(std::min(line.size(), end + _settings.responseSeparator.size()));
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "Crc.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define COMMAND_BASED_BACKEND_CRC_HARDWARE
+#  include <immintrin.h>
+#endif
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  namespace {
+
+    template<typename CrcType>
+    using SlicingTables = std::array<std::array<CrcType, 256>, 8>;
+
+    /*
+     * Table k holds the CRC contribution of a byte followed by k zero bytes, so 8 bytes are processed with 8 independent
+     * lookups. Reflected CRCs shift towards the least significant bit.
+     */
+    template<typename CrcType, CrcType polynomial, bool reflected>
+    constexpr SlicingTables<CrcType> makeSlicingTables() {
+      constexpr unsigned shiftToTopByte = 8 * sizeof(CrcType) - 8;
+      constexpr CrcType topBit = CrcType(1) << (8 * sizeof(CrcType) - 1);
+      SlicingTables<CrcType> tables{};
+      for(unsigned byte = 0; byte < 256; ++byte) {
+        CrcType crc = reflected ? CrcType(byte) : CrcType(byte << shiftToTopByte);
+        for(int bit = 0; bit < 8; ++bit) {
+          if constexpr(reflected) {
+            crc = (crc & 1U) ? CrcType((crc >> 1U) ^ polynomial) : CrcType(crc >> 1U);
+          }
+          else {
+            crc = (crc & topBit) ? CrcType((crc << 1U) ^ polynomial) : CrcType(crc << 1U);
+          }
+        }
+        tables[0][byte] = crc;
+      }
+      for(size_t k = 1; k < 8; ++k) {
+        for(unsigned byte = 0; byte < 256; ++byte) {
+          CrcType previous = tables[k - 1][byte];
+          if constexpr(reflected) {
+            tables[k][byte] = CrcType((previous >> 8U) ^ tables[0][previous & 0xFFU]);
+          }
+          else {
+            tables[k][byte] = CrcType((previous << 8U) ^ tables[0][(previous >> shiftToTopByte) & 0xFFU]);
+          }
+        }
+      }
+      return tables;
+    }
+
+    constexpr auto crcCcitt16Tables = makeSlicingTables<uint16_t, 0x1021, false>();
+    constexpr auto crc32Tables = makeSlicingTables<uint32_t, 0xEDB88320, true>();
+    constexpr auto crc32cTables = makeSlicingTables<uint32_t, 0x82F63B78, true>();
+
+    /******************************************************************************************************************/
+
+    inline uint32_t loadLittleEndian32(const unsigned char* p) {
+      return uint32_t(p[0]) | (uint32_t(p[1]) << 8U) | (uint32_t(p[2]) << 16U) | (uint32_t(p[3]) << 24U);
+    }
+
+    /*
+     * Continues the (already inverted) register of a reflected 32 bit CRC.
+     */
+    uint32_t reflected32SlicingBy8(
+        const SlicingTables<uint32_t>& t, uint32_t crc, const unsigned char* p, size_t n) noexcept {
+      for(; n >= 8; p += 8, n -= 8) {
+        uint32_t one = loadLittleEndian32(p) ^ crc;
+        uint32_t two = loadLittleEndian32(p + 4);
+        crc = t[7][one & 0xFFU] ^ t[6][(one >> 8U) & 0xFFU] ^ t[5][(one >> 16U) & 0xFFU] ^ t[4][one >> 24U] ^
+            t[3][two & 0xFFU] ^ t[2][(two >> 8U) & 0xFFU] ^ t[1][(two >> 16U) & 0xFFU] ^ t[0][two >> 24U];
+      }
+      for(; n > 0; ++p, --n) {
+        crc = (crc >> 8U) ^ t[0][(crc ^ *p) & 0xFFU];
+      }
+      return crc;
+    }
+
+    /******************************************************************************************************************/
+
+#ifdef COMMAND_BASED_BACKEND_CRC_HARDWARE
+
+    bool cpuHasCrc32Instruction() {
+      static const bool hasIt = __builtin_cpu_supports("sse4.2");
+      return hasIt;
+    }
+
+    bool cpuHasCarryLessMultiplication() {
+      static const bool hasIt = __builtin_cpu_supports("pclmul") and __builtin_cpu_supports("sse4.1");
+      return hasIt;
+    }
+
+    /*
+     * CRC32C with the SSE4.2 crc32 instruction, which implements exactly this polynomial.
+     */
+    __attribute__((target("sse4.2"))) uint32_t crc32cHardware(uint32_t crc, const unsigned char* p, size_t n) {
+      uint64_t crc64 = crc;
+      for(; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+      }
+      crc = static_cast<uint32_t>(crc64);
+      for(; n > 0; ++p, --n) {
+        crc = _mm_crc32_u8(crc, *p);
+      }
+      return crc;
+    }
+
+    /*
+     * CRC32 by folding 4 x 128 bit with carry-less multiplication, followed by a Barrett reduction. This is the
+     * algorithm of Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" white paper, with
+     * the constants of the reflected polynomial 0xEDB88320. Requires n >= 64 and a multiple of 16.
+     */
+    __attribute__((target("pclmul,sse4.1"))) uint32_t crc32Folding(uint32_t crc, const unsigned char* p, size_t n) {
+      const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+      const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+      const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+      const __m128i polynomial = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+      const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+      auto load = [](const unsigned char* q) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)); };
+      auto fold = [](__m128i x, __m128i k, __m128i next) __attribute__((target("pclmul,sse4.1"))) {
+        __m128i low = _mm_clmulepi64_si128(x, k, 0x00);
+        __m128i high = _mm_clmulepi64_si128(x, k, 0x11);
+        return _mm_xor_si128(_mm_xor_si128(high, low), next);
+      };
+
+      __m128i x1 = _mm_xor_si128(load(p), _mm_cvtsi32_si128(static_cast<int>(crc)));
+      __m128i x2 = load(p + 16);
+      __m128i x3 = load(p + 32);
+      __m128i x4 = load(p + 48);
+      p += 64;
+      n -= 64;
+
+      for(; n >= 64; p += 64, n -= 64) {
+        x1 = fold(x1, k1k2, load(p));
+        x2 = fold(x2, k1k2, load(p + 16));
+        x3 = fold(x3, k1k2, load(p + 32));
+        x4 = fold(x4, k1k2, load(p + 48));
+      }
+
+      // Fold the 4 registers into one, then the remaining 16 byte blocks
+      x1 = fold(x1, k3k4, x2);
+      x1 = fold(x1, k3k4, x3);
+      x1 = fold(x1, k3k4, x4);
+      for(; n >= 16; p += 16, n -= 16) {
+        x1 = fold(x1, k3k4, load(p));
+      }
+
+      // Fold 128 to 64 bits
+      x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+      x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+      x2 = _mm_srli_si128(x1, 4);
+      x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5, 0x00);
+      x1 = _mm_xor_si128(x1, x2);
+
+      // Barrett reduction to 32 bits
+      x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), polynomial, 0x10);
+      x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), polynomial, 0x00);
+      x1 = _mm_xor_si128(x1, x2);
+      return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+    }
+
+#endif // COMMAND_BASED_BACKEND_CRC_HARDWARE
+
+  } // namespace
+
+  /********************************************************************************************************************/
+
+  uint16_t crcCcitt16(std::string_view bytes, uint16_t crc) noexcept {
+    const auto& t = crcCcitt16Tables;
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+    size_t n = bytes.size();
+    // The register is the next two bytes' worth of bits, most significant first.
+    for(; n >= 8; p += 8, n -= 8) {
+      crc = t[7][p[0] ^ (crc >> 8U)] ^ t[6][p[1] ^ (crc & 0xFFU)] ^ t[5][p[2]] ^ t[4][p[3]] ^ t[3][p[4]] ^
+          t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+    for(; n > 0; ++p, --n) {
+      crc = static_cast<uint16_t>((crc << 8U) ^ t[0][((crc >> 8U) ^ *p) & 0xFFU]);
+    }
+    return crc;
+  }
+
+  /********************************************************************************************************************/
+
+  uint32_t crc32(std::string_view bytes, uint32_t crc, [[maybe_unused]] CrcKernel kernel) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+    size_t n = bytes.size();
+    crc = ~crc;
+#ifdef COMMAND_BASED_BACKEND_CRC_HARDWARE
+    if(kernel == CrcKernel::HARDWARE and n >= 64 and cpuHasCarryLessMultiplication()) {
+      size_t nFolded = n & ~size_t(15);
+      crc = crc32Folding(crc, p, nFolded);
+      p += nFolded;
+      n -= nFolded;
+    }
+#endif
+    return ~reflected32SlicingBy8(crc32Tables, crc, p, n);
+  }
+
+  /********************************************************************************************************************/
+
+  uint32_t crc32c(std::string_view bytes, uint32_t crc, [[maybe_unused]] CrcKernel kernel) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+#ifdef COMMAND_BASED_BACKEND_CRC_HARDWARE
+    if(kernel == CrcKernel::HARDWARE and cpuHasCrc32Instruction()) {
+      return ~crc32cHardware(~crc, p, bytes.size());
+    }
+#endif
+    return ~reflected32SlicingBy8(crc32cTables, ~crc, p, bytes.size());
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
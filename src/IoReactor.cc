@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "IoReactor.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  std::shared_ptr<IoReactor> IoReactor::getInstance(size_t minNumberOfThreads) {
+    static std::mutex instanceMutex;
+    static std::weak_ptr<IoReactor> instance;
+
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    auto reactor = instance.lock();
+    if(not reactor) {
+      // The constructor is protected, so make_shared cannot be used.
+      reactor = std::shared_ptr<IoReactor>(new IoReactor());
+      instance = reactor;
+    }
+    reactor->growThreadPool(std::clamp<size_t>(minNumberOfThreads, 1, maxNumberOfThreads));
+    return reactor;
+  }
+
+  /********************************************************************************************************************/
+
+  void IoReactor::growThreadPool(size_t numberOfThreads) {
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    while(_threads.size() < numberOfThreads) {
+      _threads.emplace_back([this] { _ioContext.run(); });
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  size_t IoReactor::getNumberOfThreads() const {
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    return _threads.size();
+  }
+
+  /********************************************************************************************************************/
+
+  bool IoReactor::isReactorThread() const {
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    return std::any_of(
+        _threads.begin(), _threads.end(), [](const auto& thread) { return thread.get_id() == std::this_thread::get_id(); });
+  }
+
+  /********************************************************************************************************************/
+
+  IoReactor::~IoReactor() {
+    // Users hold the reactor outside of its handlers, so the last reference is never released on a reactor thread.
+    assert(not isReactorThread());
+    _workGuard.reset();
+    _ioContext.stop();
+    for(auto& thread : _threads) {
+      thread.join();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "PollScheduler.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  PollScheduler::~PollScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wakeUp.notify_all();
+    if(_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::subscribe(
+      std::shared_ptr<Subscription> subscription, std::optional<std::chrono::milliseconds> interval) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _entries.push_back({std::move(subscription), interval, Clock::now()});
+      if(not _thread.joinable()) {
+        _thread = std::thread([this] { run(); });
+      }
+    }
+    _wakeUp.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::unsubscribe(const Subscription* subscription) {
+    std::vector<Entry> removed;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _pollDone.wait(lock, [&] { return _polled != subscription; });
+      auto it = std::stable_partition(_entries.begin(), _entries.end(),
+          [&](const Entry& entry) { return entry.subscription.get() != subscription; });
+      std::move(it, _entries.end(), std::back_inserter(removed));
+      _entries.erase(it, _entries.end());
+    }
+    // The subscription is destroyed without the lock held, as it releases its accessors.
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::activate() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _isActive = true;
+      ++_activation;
+      auto now = Clock::now();
+      for(auto& entry : _entries) {
+        entry.due = now;
+      }
+    }
+    _wakeUp.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::deactivate() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _isActive = false;
+    if(_thread.get_id() != std::this_thread::get_id()) {
+      _pollDone.wait(lock, [&] { return _polled == nullptr; });
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::sendException(const std::exception_ptr& e) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(not _isActive) {
+      return;
+    }
+    _isActive = false;
+    for(auto& entry : _entries) {
+      entry.subscription->sendException(e);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  bool PollScheduler::isActive() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _isActive;
+  }
+
+  /********************************************************************************************************************/
+
+  void PollScheduler::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(not _stop) {
+      if(not _isActive or _entries.empty()) {
+        _wakeUp.wait(lock);
+        continue;
+      }
+      auto next = std::min_element(
+          _entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) { return a.due < b.due; });
+      if(next->due == Clock::time_point::max()) {
+        // Only subscriptions without interval are left, and they have had their initial poll.
+        _wakeUp.wait(lock);
+        continue;
+      }
+      auto now = Clock::now();
+      if(next->due > now) {
+        _wakeUp.wait_until(lock, next->due);
+        continue;
+      }
+      if(next->interval) {
+        // Keep the rate, unless the poll is late by more than one interval. Then do not try to catch up.
+        next->due = std::max(next->due + *next->interval, now);
+      }
+      else {
+        next->due = Clock::time_point::max();
+      }
+      auto activation = _activation;
+      Subscription* polled = next->subscription.get();
+      _polled = polled;
+      lock.unlock();
+      bool hasSucceeded = false;
+      try {
+        polled->poll();
+        hasSucceeded = true;
+      }
+      catch(const ChimeraTK::runtime_error&) {
+        // Already reported to the backend by the accessor, which has called sendException().
+      }
+      catch(const ChimeraTK::logic_error&) {
+        // Only possible if the device has been closed during the poll. The scheduler is inactive then.
+      }
+      lock.lock();
+      // unsubscribe() waits for the poll to finish, so the subscription is still there.
+      if(hasSucceeded and _isActive and _activation == activation) {
+        polled->push();
+      }
+      _polled = nullptr;
+      _pollDone.notify_all();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
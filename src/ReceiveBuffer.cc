@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ReceiveBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ChimeraTK {
+  /********************************************************************************************************************/
+
+  ReceiveBuffer::ReceiveBuffer(size_t initialCapacity) : _storage(std::max<size_t>(initialCapacity, 1)) {}
+
+  /********************************************************************************************************************/
+
+  std::span<char> ReceiveBuffer::prepare(size_t minFree) {
+    if(_storage.size() - _end < minFree) {
+      // First reclaim the consumed space at the front, only grow if that is not enough.
+      if(_begin > 0) {
+        size_t nBuffered = size();
+        std::memmove(_storage.data(), _storage.data() + _begin, nBuffered);
+        _searchPosition -= std::min(_searchPosition, _begin);
+        _begin = 0;
+        _end = nBuffered;
+      }
+      if(_storage.size() - _end < minFree) {
+        _storage.resize(std::max(2 * _storage.size(), _end + minFree));
+      }
+    }
+    return {_storage.data() + _end, _storage.size() - _end};
+  }
+
+  /********************************************************************************************************************/
+
+  void ReceiveBuffer::commit(size_t nBytes) noexcept {
+    _end = std::min(_end + nBytes, _storage.size());
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<size_t> ReceiveBuffer::findDelimiter(const std::string& delimiter) {
+    if(delimiter != _searchDelimiter) {
+      // Bytes searched for another delimiter have to be searched again.
+      _searchDelimiter = delimiter;
+      _searchPosition = _begin;
+    }
+    size_t searchStart = std::max(_searchPosition, _begin);
+
+    std::string_view unsearched(_storage.data() + searchStart, _end - searchStart);
+    size_t pos = unsearched.find(delimiter);
+    if(pos != std::string_view::npos) {
+      _searchPosition = searchStart + pos;
+      return searchStart + pos - _begin;
+    }
+
+    // Keep the tail which could be the beginning of a delimiter straddling this and the next read.
+    size_t keep = std::min(delimiter.empty() ? 0 : delimiter.size() - 1, _end - searchStart);
+    _searchPosition = _end - keep;
+    return std::nullopt;
+  }
+
+  /********************************************************************************************************************/
+
+  std::string ReceiveBuffer::consume(size_t nBytes) {
+    std::string output;
+    consume(nBytes, output);
+    return output;
+  }
+
+  /********************************************************************************************************************/
+
+  void ReceiveBuffer::consume(size_t nBytes, std::string& output) {
+    nBytes = std::min(nBytes, size());
+    output.assign(_storage.data() + _begin, nBytes);
+    discard(nBytes);
+  }
+
+  /********************************************************************************************************************/
+
+  void ReceiveBuffer::discard(size_t nBytes) noexcept {
+    _begin += std::min(nBytes, size());
+    if(_begin == _end) {
+      // Everything has been consumed. Start at the front again, which makes compacting unnecessary.
+      _begin = 0;
+      _end = 0;
+      _searchPosition = 0;
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "RegisterReadTransferElement.h"
+
+#include "CommandBasedBackend.h"
+#include "stringUtils.h"
+
+#include <cassert>
+#include <string>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  RegisterReadTransferElement::RegisterReadTransferElement(boost::shared_ptr<CommandBasedBackend> backend,
+      std::shared_ptr<const CompiledRegisterPlan> plan, bool isRecoveryTestAccessor)
+  : TransferElement(plan->registerInfo.registerPath, AccessModeFlags{}), _backend(std::move(backend)),
+    _plan(std::move(plan)), _readInfo(_plan->registerInfo.readInfo), _isRecoveryTestAccessor(isRecoveryTestAccessor) {
+    assert(_plan->registerInfo.readInfo.isActive());
+    this->_exceptionBackend = _backend;
+    _readTransferBuffer.resize(1);
+
+    if(_plan->readBinaryLayout) {
+      const auto& checksums = _readInfo.responseChecksumEnums;
+      const auto& payloadSpans = _plan->readBinaryLayout->checksumPayloads;
+      if(not checksums.empty() and payloadSpans.size() == checksums.size()) {
+        std::vector<std::pair<size_t, size_t>> payloads;
+        for(const auto& span : payloadSpans) {
+          payloads.emplace_back(span.offset, span.length);
+        }
+        _readResponseChecksums.emplace(checksums, payloads);
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void RegisterReadTransferElement::doReadTransferSynchronously() {
+    if(!_backend->isFunctional() && !_isRecoveryTestAccessor) {
+      throw ChimeraTK::runtime_error("Device not functional when reading " + this->getName());
+    }
+
+    // Checksums of binary responses are computed while the bytes arrive, see parseBinaryResponse().
+    ReceiveObserver onReceive;
+    if(_readResponseChecksums) {
+      _readResponseChecksums->reset();
+      onReceive = [this](std::string_view bytes) { _readResponseChecksums->update(bytes); };
+    }
+
+    // Constant read commands are rendered completely when the register info is finalised.
+    if(const auto& constantCommand = _readInfo.constantCommand) {
+      _backend->sendCommandAndRead(*constantCommand, _readInfo, _readTransferBuffer, onReceive);
+      parseResponse();
+      return;
+    }
+
+    // Compute the checksums of the read command.
+    _commandChecksums.resize(_readInfo.commandChecksumEnums.size());
+    for(size_t i = 0; i < _commandChecksums.size(); ++i) {
+      // Skip the potential step of rendering the checksum payload: read commands carry no data.
+      const auto& payload = _readInfo.commandChecksumPayloadStrs[i];
+      _plan->readCommandChecksumers[i](payload, _commandChecksums[i]);
+    }
+
+    if(_readInfo.isBinary()) {
+      _hexCommandBuffer.clear();
+      _readInfo.commandTemplate.renderInto(_hexCommandBuffer, /*data*/ {}, _commandChecksums);
+      binaryStrFromHexStr(_hexCommandBuffer, _readCommandBuffer, /*isSigned*/ false);
+    }
+    else {
+      _readCommandBuffer.clear();
+      _readInfo.commandTemplate.renderInto(_readCommandBuffer, /*data*/ {}, _commandChecksums);
+    }
+
+    _backend->sendCommandAndRead(_readCommandBuffer, _readInfo, _readTransferBuffer, onReceive);
+    parseResponse();
+  }
+
+  /********************************************************************************************************************/
+
+  void RegisterReadTransferElement::parseResponseLine(std::string_view line) {
+    _readTransferBuffer.resize(1);
+    _readTransferBuffer[0].assign(line);
+    parseResponse();
+  }
+
+  /********************************************************************************************************************/
+
+  void RegisterReadTransferElement::parseResponse() {
+    if(_readInfo.usesReadBlock()) {
+      // The size of the payload has been checked against the block header by CommandHandler::readBlock().
+      return;
+    }
+
+    if(_plan->readBinaryLayout) {
+      parseBinaryResponse();
+      return;
+    }
+
+    const auto& registerPath = _plan->registerInfo.registerPath;
+
+    makeCombinedReadString(_readTransferBuffer, _readInfo, _combinedResponseBuffer);
+
+    // Extract the data, checksum payloads and checksums in one go.
+    if(not _plan->readResponseMatcher.match(_combinedResponseBuffer, _responseMatch)) {
+      throw ChimeraTK::runtime_error("Could not extract data values with the read response pattern for \"" +
+          replaceNewLines(_combinedResponseBuffer) + "\" in " + registerPath);
+    }
+
+    inspectChecksum(
+        _responseMatch, _readInfo, _plan->readResponseChecksumers, "read", registerPath, _checksumResultBuffer);
+  }
+
+  /********************************************************************************************************************/
+
+  void RegisterReadTransferElement::parseBinaryResponse() {
+    // Same as the regular path, just without converting the response to hex and each value back to binary.
+    const auto& registerPath = _plan->registerInfo.registerPath;
+    const std::string& response = _readTransferBuffer[0];
+    if(not _plan->readBinaryLayout->match(response, _responseMatch)) {
+      throw ChimeraTK::runtime_error("Could not extract data values with the read response pattern for \"" +
+          hexStrFromBinaryStr(response) + "\" in " + registerPath);
+    }
+
+    // The checksums are compared as bytes, hex is only needed for the error message. Normally they have been computed
+    // while the response was received, unless the transport layer did not pass on the bytes.
+    bool isComputed = _readResponseChecksums and _readResponseChecksums->getNBytesReceived() == response.size();
+    ChecksumBytes computed;
+    for(size_t i = 0; i < _readInfo.responseChecksumEnums.size(); ++i) {
+      if(i >= _responseMatch.checksumPayloads.size() or i >= _responseMatch.checksums.size()) {
+        throw ChimeraTK::runtime_error(
+            "Could not extract checksum payloads and values from the response for read for " + registerPath);
+      }
+      std::string_view checksumResult = isComputed ?
+          _readResponseChecksums->finish(i, computed) :
+          computeChecksum(_readInfo.responseChecksumEnums[i], _responseMatch.checksumPayloads[i], computed);
+      if(_responseMatch.checksums[i] != checksumResult) {
+        throw ChimeraTK::runtime_error("Response checksum " + toStr(_readInfo.responseChecksumEnums[i]) +
+            " failed for read for " + registerPath + ". Received \"" +
+            hexStrFromBinaryStr(std::string(_responseMatch.checksums[i])) + "\" but calculated \"" +
+            hexStrFromBinaryStr(std::string(checksumResult)) + "\"");
+      }
+    }
+  } // end parseBinaryResponse
+
+  /********************************************************************************************************************/
+
+  void makeCombinedReadString(
+      const std::vector<std::string>& transferBuffer, const InteractionInfo& iInfo, std::string& combinedReadString) {
+    auto appendHex = [&](const std::string& bytes) {
+      size_t offset = combinedReadString.size();
+      combinedReadString.resize(offset + 2 * bytes.size());
+      encodeHex(bytes.data(), bytes.size(), combinedReadString.data() + offset, getHexKernel());
+    };
+
+    combinedReadString.clear();
+    if(iInfo.usesReadLines()) {
+      std::string delim = *iInfo.getResponseLinesDelimiter();
+      for(const auto& line : transferBuffer) {
+        if(iInfo.isBinary()) {
+          appendHex(line);
+        }
+        else {
+          combinedReadString += line;
+        }
+        combinedReadString += delim;
+      }
+    }
+    else if(iInfo.usesReadBytes()) {
+      if(iInfo.isBinary()) {
+        appendHex(transferBuffer[0]);
+      }
+      else {
+        combinedReadString = transferBuffer[0];
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void inspectChecksum(const ResponseMatcher::Result& match, const InteractionInfo& iInfo,
+      const std::vector<Checksumer>& responseChecksumers, const char* interaction, const RegisterPath& registerPath,
+      std::string& checksumResult) {
+    size_t nChecksums = iInfo.responseChecksumEnums.size();
+    if(match.checksumPayloads.size() < nChecksums or match.checksums.size() < nChecksums) {
+      throw ChimeraTK::runtime_error("Could not extract checksum payloads and values from the response for " +
+          std::string(interaction) + " for " + registerPath);
+    }
+    for(size_t i = 0; i < nChecksums; ++i) {
+      responseChecksumers[i](match.checksumPayloads[i], checksumResult);
+      if(match.checksums[i] != checksumResult) {
+        throw ChimeraTK::runtime_error("Response checksum " + toStr(iInfo.responseChecksumEnums[i]) + " failed for " +
+            std::string(interaction) + " for " + registerPath + ". Received \"" + std::string(match.checksums[i]) +
+            "\" but calculated \"" + checksumResult + "\"");
+      }
+    }
+  } // end inspectChecksum
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,470 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "ResponseMatcher.h"
+
+#include "Checksum.h"
+#include "injaUtils.h"
+#include "stringUtils.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <cctype>
+#include <map>
+#include <utility>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  ResponseMatcher::ResponseMatcher(const std::string& responsePattern, TransportLayerType type,
+      std::optional<size_t> fixedCharacterWidth, const std::vector<checksum>& responseChecksums, size_t nElements) {
+    _isCompiled = compile(responsePattern, type, fixedCharacterWidth, responseChecksums, nElements) and isUnambiguous();
+    if(not _isCompiled) {
+      _elements.clear();
+      return;
+    }
+    _delimitedList = findDelimitedList();
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::compile(const std::string& responsePattern, TransportLayerType type,
+      std::optional<size_t> fixedCharacterWidth, const std::vector<checksum>& responseChecksums, size_t nElements) {
+    static const std::string dataKey = toStr(injaTemplatePatternKeys::DATA);
+    static const std::string csStartKey = toStr(injaTemplatePatternKeys::CHECKSUM_START);
+    static const std::string csEndKey = toStr(injaTemplatePatternKeys::CHECKSUM_END);
+    static const std::string csPointKey = toStr(injaTemplatePatternKeys::CHECKSUM_POINT);
+    static const std::string regexSyntax = R"(\^$.|?*+()[]{})";
+
+    if(usesInjaStatements(responsePattern)) {
+      // Render the statements with every tag rendering to itself, then compile the result if it is plain.
+      auto tags = [](const std::string& key, size_t n) {
+        inja::json j = inja::json::array();
+        for(size_t i = 0; i < n; ++i) {
+          j.push_back("{{" + key + "." + std::to_string(i) + "}}");
+        }
+        return j;
+      };
+      inja::json replacePatterns;
+      replacePatterns[dataKey] = tags(dataKey, nElements);
+      if(not responseChecksums.empty()) {
+        replacePatterns[csStartKey] = tags(csStartKey, responseChecksums.size());
+        replacePatterns[csEndKey] = tags(csEndKey, responseChecksums.size());
+        replacePatterns[csPointKey] = tags(csPointKey, responseChecksums.size());
+      }
+      std::string rendered;
+      try {
+        rendered = injaRender(responsePattern, replacePatterns, "response pattern");
+      }
+      catch(const ChimeraTK::runtime_error&) {
+        return false; // Let the regex fallback report it.
+      }
+      if(usesInjaStatements(rendered)) {
+        return false;
+      }
+      return compile(rendered, type, fixedCharacterWidth, responseChecksums, nElements);
+    }
+
+    CharacterClass valueClass = CharacterClass::STRING;
+    size_t valueWidth = fixedCharacterWidth.value_or(0);
+    switch(type) {
+      case TransportLayerType::DEC_INT:
+        valueClass = CharacterClass::DECIMAL_INT;
+        break;
+      case TransportLayerType::HEX_INT:
+      case TransportLayerType::BIN_INT:
+      case TransportLayerType::BIN_FLOAT:
+        valueClass = CharacterClass::HEX;
+        break;
+      case TransportLayerType::DEC_FLOAT:
+        valueClass = CharacterClass::DECIMAL_FLOAT;
+        valueWidth = 0; // The regex does not limit the width of floats either.
+        break;
+      case TransportLayerType::STRING:
+      case TransportLayerType::VOID:
+        break;
+    }
+
+    std::string literal;
+    auto pushElement = [&](Element element) {
+      if(not literal.empty()) {
+        _elements.push_back({ElementType::LITERAL, std::move(literal), {}, 0, 0});
+        literal.clear();
+      }
+      _elements.push_back(std::move(element));
+    };
+    std::map<size_t, size_t> payloadSlots; // csStart index -> slot
+
+    size_t pos = 0;
+    while(pos < responsePattern.size()) {
+      size_t tagPos = responsePattern.find("{{", pos);
+      std::string_view text = std::string_view(responsePattern).substr(pos, tagPos - pos);
+      if(text.find_first_of(regexSyntax) != std::string_view::npos) {
+        return false;
+      }
+      literal += text;
+      if(tagPos == std::string::npos) {
+        break;
+      }
+      auto tag = parseSimpleInjaTag(responsePattern, tagPos);
+      if(not tag) {
+        return false;
+      }
+      if(tag->key == dataKey) {
+        if(tag->index >= nElements) {
+          return false;
+        }
+        if(type != TransportLayerType::VOID) { // VOID values render empty
+          pushElement({ElementType::VALUE, {}, valueClass, valueWidth, _nData++});
+        }
+      }
+      else if(tag->key == csPointKey) {
+        if(tag->index >= responseChecksums.size()) {
+          return false;
+        }
+        size_t width = getHexCharacterWidth(responseChecksums[tag->index]);
+        pushElement({ElementType::CHECKSUM, {}, CharacterClass::HEX, width, _nChecksums++});
+      }
+      else if(tag->key == csStartKey) {
+        if(tag->index >= responseChecksums.size() or payloadSlots.count(tag->index)) {
+          return false;
+        }
+        payloadSlots[tag->index] = _nChecksumPayloads;
+        pushElement({ElementType::CHECKSUM_START, {}, CharacterClass::HEX, 0, _nChecksumPayloads++});
+      }
+      else if(tag->key == csEndKey) {
+        auto slot = payloadSlots.find(tag->index);
+        if(slot == payloadSlots.end()) {
+          return false;
+        }
+        pushElement({ElementType::CHECKSUM_END, {}, CharacterClass::HEX, 0, slot->second});
+      }
+      else {
+        return false;
+      }
+      pos = tagPos + tag->length;
+    }
+    if(not literal.empty()) {
+      _elements.push_back({ElementType::LITERAL, std::move(literal), {}, 0, 0});
+    }
+    return payloadSlots.size() == _nChecksumPayloads;
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::isUnambiguous() const {
+    auto canContinue = [](CharacterClass characterClass, char c) {
+      auto u = static_cast<unsigned char>(c);
+      switch(characterClass) {
+        case CharacterClass::DECIMAL_INT:
+          return std::isdigit(u) != 0;
+        case CharacterClass::HEX:
+          return std::isxdigit(u) != 0;
+        case CharacterClass::DECIMAL_FLOAT:
+          return std::isdigit(u) != 0 or c == '.';
+        case CharacterClass::STRING:
+          return c != '\n' and c != '\r'; // '.' in a regex does not match line terminators
+      }
+      return true;
+    };
+
+    for(size_t i = 0; i < _elements.size(); ++i) {
+      const auto& field = _elements[i];
+      if(field.type != ElementType::VALUE or field.width != 0) {
+        continue; // Fixed width fields never depend on what follows.
+      }
+      // Checksum start and end tags are zero-width, look past them.
+      size_t next = i + 1;
+      while(next < _elements.size() and (_elements[next].type == ElementType::CHECKSUM_START or
+                                            _elements[next].type == ElementType::CHECKSUM_END)) {
+        ++next;
+      }
+      if(next == _elements.size()) {
+        continue;
+      }
+      const auto& following = _elements[next];
+      if(following.type != ElementType::LITERAL or canContinue(field.characterClass, following.literal[0])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<ResponseMatcher::DelimitedList> ResponseMatcher::findDelimitedList() const {
+    if(_nData < 2 or _nChecksums != 0 or _nChecksumPayloads != 0) {
+      return std::nullopt;
+    }
+    DelimitedList list;
+    size_t i = 0;
+    if(_elements[i].type == ElementType::LITERAL) {
+      list.prefix = _elements[i++].literal;
+    }
+    for(size_t n = 0; n < _nData; ++n) {
+      if(i == _elements.size() or _elements[i].type != ElementType::VALUE or _elements[i].width != 0 or
+          _elements[i].characterClass == CharacterClass::STRING) {
+        return std::nullopt;
+      }
+      list.field = _elements[i++];
+      if(n + 1 == _nData) {
+        break;
+      }
+      if(i == _elements.size() or _elements[i].type != ElementType::LITERAL or
+          (n != 0 and _elements[i].literal != list.separator)) {
+        return std::nullopt;
+      }
+      list.separator = _elements[i++].literal;
+    }
+    if(i < _elements.size() and _elements[i].type == ElementType::LITERAL) {
+      list.suffix = _elements[i++].literal;
+    }
+    if(i != _elements.size()) {
+      return std::nullopt;
+    }
+    return list;
+  }
+
+  /********************************************************************************************************************/
+
+  void ResponseMatcher::setFallbackRegexes(
+      std::regex dataRegex, std::regex checksumPayloadRegex, std::regex checksumRegex) {
+    _dataRegex = std::move(dataRegex);
+    _checksumPayloadRegex = std::move(checksumPayloadRegex);
+    _checksumRegex = std::move(checksumRegex);
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::match(std::string_view input, Result& result) const {
+    return _isCompiled ? matchCompiled(input, result) : matchRegex(input, result);
+  }
+
+  /********************************************************************************************************************/
+
+  size_t ResponseMatcher::matchField(std::string_view input, size_t pos, const Element& field) {
+    auto isIn = [&](size_t p, int (*isClass)(int)) {
+      return p < input.size() and isClass(static_cast<unsigned char>(input[p])) != 0;
+    };
+    auto countWhile = [&](size_t p, int (*isClass)(int)) {
+      size_t begin = p;
+      while(isIn(p, isClass)) {
+        ++p;
+      }
+      return p - begin;
+    };
+    auto isNotLineTerminator = [](int c) -> int { return c != '\n' and c != '\r'; };
+
+    size_t p = pos;
+    int (*isClass)(int) = nullptr;
+    switch(field.characterClass) {
+      case CharacterClass::DECIMAL_INT:
+        if(p < input.size() and (input[p] == '+' or input[p] == '-')) {
+          ++p;
+        }
+        isClass = [](int c) -> int { return std::isdigit(c); };
+        break;
+      case CharacterClass::HEX:
+        isClass = [](int c) -> int { return std::isxdigit(c); };
+        break;
+      case CharacterClass::STRING:
+        isClass = isNotLineTerminator;
+        break;
+      case CharacterClass::DECIMAL_FLOAT: {
+        if(p < input.size() and (input[p] == '+' or input[p] == '-')) {
+          ++p;
+        }
+        auto isDigit = [](int c) -> int { return std::isdigit(c); };
+        size_t nDigits = countWhile(p, isDigit);
+        if(nDigits == 0) {
+          return std::string_view::npos;
+        }
+        p += nDigits;
+        if(p < input.size() and input[p] == '.') {
+          ++p;
+          p += countWhile(p, isDigit);
+        }
+        return p;
+      }
+    }
+
+    size_t available = countWhile(p, isClass);
+    if(field.width != 0) {
+      return (available >= field.width) ? p + field.width : std::string_view::npos;
+    }
+    if(available == 0 and field.characterClass != CharacterClass::STRING) { // only ".*" may be empty
+      return std::string_view::npos;
+    }
+    return p + available;
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::matchCompiled(std::string_view input, Result& result) const {
+    if(_delimitedList) {
+      return matchDelimitedList(input, result);
+    }
+    result.data.resize(_nData);
+    result.checksums.resize(_nChecksums);
+    result.checksumPayloads.resize(_nChecksumPayloads);
+
+    size_t pos = 0;
+    for(const auto& element : _elements) {
+      switch(element.type) {
+        case ElementType::LITERAL:
+          if(input.substr(pos, element.literal.size()) != element.literal) {
+            return false;
+          }
+          pos += element.literal.size();
+          break;
+        case ElementType::VALUE:
+        case ElementType::CHECKSUM: {
+          size_t end = matchField(input, pos, element);
+          if(end == std::string_view::npos) {
+            return false;
+          }
+          auto& target = (element.type == ElementType::VALUE) ? result.data : result.checksums;
+          target[element.slot] = input.substr(pos, end - pos);
+          pos = end;
+          break;
+        }
+        case ElementType::CHECKSUM_START:
+          result.checksumPayloads[element.slot] = input.substr(pos, 0);
+          break;
+        case ElementType::CHECKSUM_END: {
+          auto begin = static_cast<size_t>(result.checksumPayloads[element.slot].data() - input.data());
+          result.checksumPayloads[element.slot] = input.substr(begin, pos - begin);
+          break;
+        }
+      }
+    }
+    return pos == input.size();
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::matchDelimitedList(std::string_view input, Result& result) const {
+    const auto& list = *_delimitedList;
+    result.data.resize(_nData);
+    result.checksums.clear();
+    result.checksumPayloads.clear();
+
+    if(input.size() < list.prefix.size() + list.suffix.size() or input.substr(0, list.prefix.size()) != list.prefix or
+        input.substr(input.size() - list.suffix.size()) != list.suffix) {
+      return false;
+    }
+    std::string_view values = input.substr(list.prefix.size(), input.size() - list.prefix.size() - list.suffix.size());
+
+    // Values cannot contain the first character of the separator (see isUnambiguous()), so each value ends exactly at
+    // the next separator. string_view::find() looks for it with memchr, which is vectorised in the C library.
+    size_t pos = 0;
+    for(size_t i = 0; i < _nData; ++i) {
+      size_t end = (i + 1 < _nData) ? values.find(list.separator, pos) : values.size();
+      if(end == std::string_view::npos or matchField(values, pos, list.field) != end) {
+        return false;
+      }
+      result.data[i] = values.substr(pos, end - pos);
+      pos = end + list.separator.size();
+    }
+    return true;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<ResponseMatcher::BinaryLayout> ResponseMatcher::getBinaryLayout() const {
+    if(not _isCompiled) {
+      return std::nullopt;
+    }
+    BinaryLayout layout;
+    layout.data.resize(_nData);
+    layout.checksums.resize(_nChecksums);
+    layout.checksumPayloads.resize(_nChecksumPayloads);
+
+    // All widths are checked to be even, so every element starts on a byte boundary.
+    size_t nHexChars = 0;
+    for(const auto& element : _elements) {
+      switch(element.type) {
+        case ElementType::LITERAL:
+          // hexStrFromBinaryStr only produces upper case digits, so anything else never matches a binary response.
+          if(element.literal.size() % 2 != 0 or
+              element.literal.find_first_not_of("0123456789ABCDEF") != std::string::npos) {
+            return std::nullopt;
+          }
+          layout.literals.emplace_back(nHexChars / 2, binaryStrFromHexStr(element.literal));
+          nHexChars += element.literal.size();
+          break;
+        case ElementType::VALUE:
+        case ElementType::CHECKSUM: {
+          if(element.width == 0 or element.width % 2 != 0) {
+            return std::nullopt;
+          }
+          auto& target = (element.type == ElementType::VALUE) ? layout.data : layout.checksums;
+          target[element.slot] = {nHexChars / 2, element.width / 2};
+          nHexChars += element.width;
+          break;
+        }
+        case ElementType::CHECKSUM_START:
+          layout.checksumPayloads[element.slot].offset = nHexChars / 2;
+          break;
+        case ElementType::CHECKSUM_END:
+          layout.checksumPayloads[element.slot].length = nHexChars / 2 - layout.checksumPayloads[element.slot].offset;
+          break;
+      }
+    }
+    layout.nBytes = nHexChars / 2;
+    return layout;
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::BinaryLayout::match(std::string_view bytes, Result& result) const {
+    if(bytes.size() != nBytes) {
+      return false;
+    }
+    for(const auto& [offset, literal] : literals) {
+      if(bytes.substr(offset, literal.size()) != literal) {
+        return false;
+      }
+    }
+    auto extract = [&](const std::vector<Span>& spans, std::vector<std::string_view>& target) {
+      target.resize(spans.size());
+      for(size_t i = 0; i < spans.size(); ++i) {
+        target[i] = bytes.substr(spans[i].offset, spans[i].length);
+      }
+    };
+    extract(data, result.data);
+    extract(checksumPayloads, result.checksumPayloads);
+    extract(checksums, result.checksums);
+    return true;
+  }
+
+  /********************************************************************************************************************/
+
+  bool ResponseMatcher::matchRegex(std::string_view input, Result& result) const {
+    auto runRegex = [&](const std::regex& regex, std::vector<std::string_view>& target) {
+      target.clear();
+      std::cmatch match;
+      if(not std::regex_match(input.data(), input.data() + input.size(), match, regex)) {
+        return false;
+      }
+      for(size_t i = 1; i < match.size(); ++i) {
+        target.emplace_back(match[i].first, static_cast<size_t>(match[i].length()));
+      }
+      return true;
+    };
+
+    if(not runRegex(_dataRegex, result.data)) {
+      return false;
+    }
+    // Without checksums, the checksum regexes describe the same language as the data regex, which has matched already.
+    if(_checksumRegex.mark_count() == 0) {
+      result.checksumPayloads.clear();
+      result.checksums.clear();
+      return true;
+    }
+    return runRegex(_checksumPayloadRegex, result.checksumPayloads) and runRegex(_checksumRegex, result.checksums);
+  }
+
+  /********************************************************************************************************************/
+} // namespace ChimeraTK
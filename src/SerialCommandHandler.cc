@@ -15,50 +15,94 @@
 
 /**********************************************************************************************************************/
 
-SerialCommandHandler::SerialCommandHandler(
-    const std::string& device, const std::string& _delimiter, ulong timeoutInMilliseconds)
+SerialCommandHandler::SerialCommandHandler(const std::string& device, const std::string& _delimiter,
+    ulong timeoutInMilliseconds, const ChimeraTK::SerialPortSettings& settings)
 : CommandHandler(_delimiter, timeoutInMilliseconds) {
-  _serialPort = std::make_unique<ChimeraTK::SerialPort>(device);
+  _serialPort = std::make_unique<ChimeraTK::SerialPort>(device, settings);
 }
 
 /**********************************************************************************************************************/
 
-std::vector<std::string> SerialCommandHandler::sendCommandAndReadLinesImpl(
-    std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) {
-  std::vector<std::string> outputStrVec;
-  outputStrVec.reserve(nLinesToRead);
+void SerialCommandHandler::sendCommandAndReadLinesImpl(std::string_view cmd, size_t nLinesToRead,
+    const Delimiter& writeDelimiter, const Delimiter& readDelimiter, std::vector<std::string>& lines) {
+  sendCommandImpl(cmd, writeDelimiter);
+  readLinesImpl(nLinesToRead, readDelimiter, lines, timeout);
+}
+
+/**********************************************************************************************************************/
 
-  _serialPort->send(cmd + toString(writeDelimiter));
+void SerialCommandHandler::sendCommandAndReadBytesImpl(std::string_view cmd, size_t nBytesToRead,
+    const Delimiter& writeDelimiter, const ChimeraTK::ReceiveObserver& onReceive, std::string& bytes) {
+  sendCommandImpl(cmd, writeDelimiter);
+  readBytesImpl(nBytesToRead, bytes, timeout, onReceive);
+}
 
+/**********************************************************************************************************************/
+
+std::string SerialCommandHandler::sendCommandAndReadBlockImpl(
+    std::string_view cmd, size_t nBytesExpected, const Delimiter& writeDelimiter, const std::string& terminator) {
+  sendCommandImpl(cmd, writeDelimiter);
+  return readBlockImpl(nBytesExpected, terminator, timeout);
+}
+
+/**********************************************************************************************************************/
+
+void SerialCommandHandler::sendCommandImpl(std::string_view cmd, const Delimiter& writeDelimiter) {
+  _serialPort->send(appendWriteDelimiter(cmd, writeDelimiter));
+}
+
+/**********************************************************************************************************************/
+
+void SerialCommandHandler::readLinesImpl(size_t nLinesToRead, const Delimiter& readDelimiter,
+    std::vector<std::string>& lines, std::chrono::milliseconds readTimeout) {
+  lines.resize(nLinesToRead);
   if(nLinesToRead == 0) {
-    return outputStrVec;
+    return;
   }
 
   std::string delim = toStringGuarded(readDelimiter);
-  std::string readStr;
+  auto deadline = Clock::now() + readTimeout;
   for(size_t nLinesFound = 0; nLinesFound < nLinesToRead; ++nLinesFound) {
     try {
-      readStr = _serialPort->readlineWithTimeout(timeout, delim);
+      do {
+        _serialPort->readlineWithTimeout(getRemainingTime(deadline), delim, lines[nLinesFound]);
+      } while(isUnsolicited(lines[nLinesFound]));
     }
     catch(const ChimeraTK::runtime_error& e) {
       std::string err = std::string(e.what()) + " Retrieved:";
-      for(auto& s : outputStrVec) {
-        err += "\n" + s;
+      for(size_t i = 0; i < nLinesFound; ++i) {
+        err += "\n" + lines[i];
       }
       throw ChimeraTK::runtime_error(err);
     }
-    outputStrVec.push_back(readStr);
   }
+}
+
+/**********************************************************************************************************************/
+
+void SerialCommandHandler::readBytesImpl(size_t nBytesToRead, std::string& bytes,
+    std::chrono::milliseconds readTimeout, const ChimeraTK::ReceiveObserver& onReceive) {
+  _serialPort->readBytesWithTimeout(nBytesToRead, readTimeout, bytes, onReceive);
+}
+
+/**********************************************************************************************************************/
+
+std::string SerialCommandHandler::readBlockImpl(
+    size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) {
+  return readBlock([&](size_t nBytes) { return _serialPort->readBytesWithTimeout(nBytes, readTimeout); },
+      nBytesExpected, terminator);
+}
+
+/**********************************************************************************************************************/
 
-  return outputStrVec;
+bool SerialCommandHandler::readLineImpl(std::string& line, std::chrono::milliseconds readTimeout) {
+  return _serialPort->tryReadlineWithTimeout(readTimeout, delimiter, line);
 }
 
 /**********************************************************************************************************************/
 
-std::string SerialCommandHandler::sendCommandAndReadBytesImpl(
-    std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) {
-  _serialPort->send(cmd + toString(writeDelimiter));
-  return _serialPort->readBytesWithTimeout(nBytesToRead, timeout);
+bool SerialCommandHandler::waitForInputImpl(std::chrono::milliseconds timeout) {
+  return _serialPort->waitForPendingInput(timeout);
 }
 
 /**********************************************************************************************************************/
@@ -3,26 +3,83 @@
 #include "SerialPort.h"
 
 #include "stringUtils.h"
+#include "termiosUtils.h"
 
 #include <ChimeraTK/Exception.h>
 
 #include <fcntl.h>
-#include <termios.h> //For termain IO interface
-#include <unistd.h>  //POSIX OS API
+#include <poll.h>        //For waiting on the port without polling it in a sleep loop
+#include <sys/eventfd.h> //For waking up a blocked read from terminateRead()
+#include <termios.h>     //For termain IO interface
+#include <unistd.h>      //POSIX OS API
 
+#include <algorithm>
 #include <cerrno>  //for errno
+#include <array>
 #include <chrono>  //Needed for timeout
 #include <cstring> //Used for memset, strerrorname_np, strerrordesc_np
-#include <future>  //Needed for timeout
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 
 namespace ChimeraTK {
   /********************************************************************************************************************/
 
-  SerialPort::SerialPort(const std::string& device) {
+  static std::optional<speed_t> getStandardBaudRate(unsigned int baudRate) {
+    static const std::map<unsigned int, speed_t> standardBaudRates{{50, B50}, {75, B75}, {110, B110}, {134, B134},
+        {150, B150}, {200, B200}, {300, B300}, {600, B600}, {1200, B1200}, {1800, B1800}, {2400, B2400},
+        {4800, B4800}, {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600}, {115200, B115200},
+        {230400, B230400}, {460800, B460800}, {500000, B500000}, {576000, B576000}, {921600, B921600},
+        {1000000, B1000000}, {1152000, B1152000}, {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000},
+        {3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000}};
+    auto it = standardBaudRates.find(baudRate);
+    if(it == standardBaudRates.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  /********************************************************************************************************************/
+
+  void SerialPortSettings::validate() const {
+    if(baudRate == 0) {
+      throw ChimeraTK::logic_error("Invalid serial port settings: baud rate must be positive.");
+    }
+    if(dataBits < 5 or dataBits > 8) {
+      throw ChimeraTK::logic_error(
+          "Invalid serial port settings: " + std::to_string(dataBits) + " data bits, supported are 5 to 8.");
+    }
+    if(stopBits != 1 and stopBits != 2) {
+      throw ChimeraTK::logic_error(
+          "Invalid serial port settings: " + std::to_string(stopBits) + " stop bits, supported are 1 and 2.");
+    }
+    if(flowControl == FlowControl::XON_XOFF and dataBits < 7) {
+      // XON/XOFF are ASCII control characters 0x11 and 0x13, which need at least 7 bit characters.
+      throw ChimeraTK::logic_error("Invalid serial port settings: XON/XOFF flow control needs at least 7 data bits.");
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::string SerialPortSettings::toString() const {
+    std::string parityChar = (parity == Parity::NONE ? "N" : (parity == Parity::EVEN ? "E" : "O"));
+    std::string str = std::to_string(baudRate) + " " + std::to_string(dataBits) + parityChar + std::to_string(stopBits);
+    if(flowControl == FlowControl::RTS_CTS) {
+      str += " RTS/CTS";
+    }
+    else if(flowControl == FlowControl::XON_XOFF) {
+      str += " XON/XOFF";
+    }
+    return str;
+  }
+
+  /********************************************************************************************************************/
+
+  SerialPort::SerialPort(const std::string& device, const SerialPortSettings& settings) {
+    settings.validate();
+
     _fileDescriptor = open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK); // from fcntl
                                                                             // O_RDWR = open for read + write
                                                                             // O_RDONLY = open read only
@@ -33,39 +90,86 @@ namespace ChimeraTK {
       throw ChimeraTK::runtime_error(err);
     }
 
+    // Close the port if any of the settings fail, the destructor will not run.
+    auto throwAndClose = [&](const std::string& err) {
+      close(_fileDescriptor);
+      throw ChimeraTK::runtime_error(err);
+    };
+
     // Make an instance tty of the termios structure.
     // termios::tcgetattr reads the current terminal settings into the tty structure.
     // throw if this fails
     termios tty{};
     if(tcgetattr(_fileDescriptor, &tty) != 0) {
-      std::string err = "Error from tcgetattr\n";
-      throw ChimeraTK::runtime_error(err);
+      throwAndClose("Error from tcgetattr for device \"" + device + "\"");
     }
 
-    // Set baud rate using termios.
-    int iCfsetospeed = cfsetospeed(&tty, (speed_t)B9600);
-    int iCfsetispeed = cfsetispeed(&tty, (speed_t)B9600);
+    // Set baud rate using termios. Non-standard rates are set via termios2 after tcsetattr.
+    auto standardBaudRate = getStandardBaudRate(settings.baudRate);
+    speed_t speed = standardBaudRate.value_or(B38400); // placeholder, overwritten for non-standard rates
+    int iCfsetospeed = cfsetospeed(&tty, speed);
+    int iCfsetispeed = cfsetispeed(&tty, speed);
     if(iCfsetospeed < 0 or iCfsetispeed < 0) {
-      std::string err = "Error setting IO speed\n";
-      throw ChimeraTK::runtime_error(err);
+      throwAndClose("Error setting IO speed for device \"" + device + "\"");
     }
     // see https://www.man7.org/linux/man-pages/man3/termios.3.html
     // NOLINTBEGIN(hicpp-signed-bitwise)
-    tty.c_cflag &= ~PARENB; // disables parity generation and detection.
-    tty.c_cflag &= ~CSTOPB; // Use 1 stop bit, not 2
+    static const std::map<unsigned int, tcflag_t> characterSizes{{5, CS5}, {6, CS6}, {7, CS7}, {8, CS8}};
     tty.c_cflag &= ~CSIZE;
-    tty.c_cflag |= CS8;            // Use 8 bit chars.
-    tty.c_cflag &= ~CRTSCTS;       // no flow control
+    tty.c_cflag |= characterSizes.at(settings.dataBits);
+
+    if(settings.stopBits == 2) {
+      tty.c_cflag |= CSTOPB; // Use 2 stop bits
+    }
+    else {
+      tty.c_cflag &= ~CSTOPB; // Use 1 stop bit, not 2
+    }
+
+    if(settings.parity == SerialPortSettings::Parity::NONE) {
+      tty.c_cflag &= ~PARENB; // disables parity generation and detection.
+      tty.c_iflag &= ~INPCK;
+    }
+    else {
+      tty.c_cflag |= PARENB;
+      tty.c_iflag |= INPCK; // drop bytes with parity errors
+      if(settings.parity == SerialPortSettings::Parity::ODD) {
+        tty.c_cflag |= PARODD;
+      }
+      else {
+        tty.c_cflag &= ~PARODD;
+      }
+    }
+
+    tty.c_cflag &= ~CRTSCTS;
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+    if(settings.flowControl == SerialPortSettings::FlowControl::RTS_CTS) {
+      tty.c_cflag |= CRTSCTS;
+    }
+    else if(settings.flowControl == SerialPortSettings::FlowControl::XON_XOFF) {
+      tty.c_iflag |= IXON | IXOFF;
+    }
+
     tty.c_lflag &= ~ICANON;        // Set non-canonical mode so VMIN and VTIME are effective
     tty.c_cc[VMIN] = 0;            // VMIN defines the minimum number of characters to read
-    tty.c_cc[VTIME] = 0;           // 0.5 seconds read timeout //FIXME hacked to be 0 for polling read test
+    tty.c_cc[VTIME] = 0;           // no read timeout, waiting is done with poll()
     tty.c_cflag |= CREAD | CLOCAL; // turn on READ & ignore ctrl lines
                                    // NOLINTEND(hicpp-signed-bitwise)
 
     // Flush Port, then applies attributes.
     tcflush(_fileDescriptor, TCIFLUSH);
     if(tcsetattr(_fileDescriptor, TCSANOW, &tty) != 0) { // from termios
-      std::string err = "Error from tcsetattr\n";
+      throwAndClose("Error from tcsetattr for device \"" + device + "\" with settings " + settings.toString());
+    }
+    if(not standardBaudRate.has_value() and not setCustomBaudRate(_fileDescriptor, settings.baudRate)) {
+      throwAndClose("Device \"" + device + "\" does not support the non-standard baud rate " +
+          std::to_string(settings.baudRate) + " (" + strerrordesc_np(errno) + ")");
+    }
+
+    // The wakeup file descriptor is watched alongside the port, so terminateRead() can interrupt a blocked wait.
+    _wakeupFileDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_wakeupFileDescriptor == -1) {
+      close(_fileDescriptor);
+      std::string err = "Unable to create the wakeup eventfd for device \"" + device + "\"";
       throw ChimeraTK::runtime_error(err);
     }
   } // end SerialPort constructor
@@ -73,6 +177,7 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   SerialPort::~SerialPort() {
+    close(_wakeupFileDescriptor);
     close(_fileDescriptor);
   }
 
@@ -90,125 +195,244 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   std::optional<std::string> SerialPort::readline(const std::string& delimiter) noexcept {
-    size_t delimPos;
-    static constexpr int readBufferLen = 256;
-    std::vector<char> readBuffer(readBufferLen);
-
-    _terminateRead = false;
-    // Search for delimiter in persistentBufferStr. While it's not there, read into persistentBufferStr and try again.
-    for(delimPos = _persistentBufferStr.find(delimiter); delimPos == std::string::npos;
-        delimPos = _persistentBufferStr.find(delimiter)) {
-      ssize_t __attribute__((unused)) bytesRead =
-          read(_fileDescriptor, readBuffer.data(), readBuffer.size() - 1); // unistd::read
-
-      if(_terminateRead) {
-        return std::nullopt;
-      }
-      // The -1 makes room for read to insert a '\0' null termination at the end.
-      _persistentBufferStr += std::string(readBuffer.data());
-
-      if(bytesRead == 0) {
-        usleep(1000);
-      }
+    clearTerminateRead();
+    WaitResult waitResult; // without deadline, the only possible failure is a termination
+    std::string line;
+    if(not readlineUntil(delimiter, std::nullopt, waitResult, line)) {
+      return std::nullopt;
     }
-
-    // Now the delimiter has been found at position delimPos.
-    std::string outputStr = _persistentBufferStr.substr(0, delimPos);
-    _persistentBufferStr = _persistentBufferStr.substr(delimPos + delimiter.size());
-    return outputStr;
+    return line;
   } // end readline
 
   /********************************************************************************************************************/
 
   std::optional<std::string> SerialPort::readBytes(const size_t nBytesToRead) {
-    // Read until we've read nBytesToRead, with possible interrupts through _terminateRead
-    if(nBytesToRead == 0) {
-      return "";
+    clearTerminateRead();
+    WaitResult waitResult;
+    std::string bytes;
+    if(not readBytesUntil(nBytesToRead, std::nullopt, waitResult, bytes)) {
+      return std::nullopt;
     }
-
-    std::string outputBuffer;
-    outputBuffer.reserve(nBytesToRead);
-    std::vector<char> readBuffer(nBytesToRead);
-    ssize_t bytesRead;
-
-    for(size_t totalBytesRead = 0; totalBytesRead < nBytesToRead; totalBytesRead += bytesRead) {
-      bytesRead = read(_fileDescriptor, readBuffer.data(), nBytesToRead - totalBytesRead); // unistd::read
-
-      if(_terminateRead) {
-        return std::nullopt;
-      }
-
-      if(bytesRead > 0) {
-        // Append the read bytes to outputBuffer
-        outputBuffer.append(readBuffer.data(), bytesRead);
-      }
-      else if(bytesRead == 0) { // read EOF, wait for reconnection.
-        usleep(1000);
-      }
-      else {
-        std::ostringstream errorMsg;
-        errorMsg << "Read error: " << strerrorname_np(errno) << " (" << strerrordesc_np(errno) << ")";
-        throw ChimeraTK::runtime_error(errorMsg.str());
-      }
-    }
-
-    return outputBuffer;
+    return bytes;
   }
 
   /********************************************************************************************************************/
 
   std::string SerialPort::readlineWithTimeout(const std::chrono::milliseconds& timeout, const std::string& delimiter) {
-    auto future =
-        std::async(std::launch::async, [&]() -> std::optional<std::string> { return this->readline(delimiter); });
+    std::string line;
+    readlineWithTimeout(timeout, delimiter, line);
+    return line;
+  }
 
-    if(future.wait_for(timeout) == std::future_status::timeout) {
-      // In case of a timeout we have to tell the read to stop so the
-      // async thread can complete.
-      terminateRead();
+  /********************************************************************************************************************/
+
+  void SerialPort::readlineWithTimeout(
+      const std::chrono::milliseconds& timeout, const std::string& delimiter, std::string& line) {
+    if(not tryReadlineWithTimeout(timeout, delimiter, line)) {
       std::string err = "readline operation timed out.";
       throw ChimeraTK::runtime_error(err);
     }
+  } // end readlineWithTimeout
+
+  /********************************************************************************************************************/
 
-    // No timeout occured, the readData optional should have data.
-    auto readData = future.get();
-    if(not readData.has_value()) {
+  bool SerialPort::tryReadlineWithTimeout(
+      const std::chrono::milliseconds& timeout, const std::string& delimiter, std::string& line) {
+    clearTerminateRead();
+    WaitResult waitResult;
+    if(readlineUntil(delimiter, Clock::now() + timeout, waitResult, line)) {
+      return true;
+    }
+    if(waitResult != WaitResult::TIMED_OUT) {
       // read was abandoned or failed
       throw ChimeraTK::runtime_error("readline failed to return a value.");
     }
-    return readData.value();
-  } // end readlineWithTimeout
+    if(_hasHungUp) {
+      throw ChimeraTK::runtime_error("readline failed: the serial port has hung up or reports read errors.");
+    }
+    return false;
+  }
 
   /********************************************************************************************************************/
-  std::string SerialPort::readBytesWithTimeout(const size_t nBytesToRead, const std::chrono::milliseconds& timeout) {
-    if(nBytesToRead == 0) {
-      return "";
-    }
-    auto future =
-        std::async(std::launch::async, [&]() -> std::optional<std::string> { return this->readBytes(nBytesToRead); });
 
-    if(future.wait_for(timeout) == std::future_status::timeout) {
-      // If the code has not returned, then there has been a timeout or read has been abandoned.
+  std::string SerialPort::readBytesWithTimeout(
+      const size_t nBytesToRead, const std::chrono::milliseconds& timeout, const ReceiveObserver& onReceive) {
+    std::string bytes;
+    readBytesWithTimeout(nBytesToRead, timeout, bytes, onReceive);
+    return bytes;
+  }
+
+  /********************************************************************************************************************/
 
-      // In case of a timeout we have to tell the read to stop so the
-      // async thread can complete.
-      terminateRead();
+  void SerialPort::readBytesWithTimeout(const size_t nBytesToRead, const std::chrono::milliseconds& timeout,
+      std::string& bytes, const ReceiveObserver& onReceive) {
+    if(nBytesToRead == 0) {
+      bytes.clear();
+      return;
+    }
+    clearTerminateRead();
+    WaitResult waitResult;
+    if(readBytesUntil(nBytesToRead, Clock::now() + timeout, waitResult, bytes, onReceive)) {
+      return;
+    }
+    if(waitResult == WaitResult::TIMED_OUT) {
       std::string err = "readBytes operation timed out.";
       throw ChimeraTK::runtime_error(err);
     }
+    // read was abandoned or failed
+    throw ChimeraTK::runtime_error("readBytes failed to return a value.");
+  }
 
-    // No timeout occured, the readData optional should have data.
-    auto readData = future.get();
-    if(not readData.has_value()) {
-      // read was abandoned or failed
-      throw ChimeraTK::runtime_error("readBytes failed to return a value.");
+  /********************************************************************************************************************/
+
+  bool SerialPort::readlineUntil(const std::string& delimiter, const std::optional<Clock::time_point>& deadline,
+      WaitResult& waitResult, std::string& line) noexcept {
+    // Search for the delimiter in the receive buffer. While it's not there, read more data and try again.
+    // Only the newly received bytes are searched.
+    std::optional<size_t> delimPos;
+    while(not(delimPos = _receiveBuffer.findDelimiter(delimiter))) {
+      waitResult = waitForInput(deadline);
+      if(waitResult != WaitResult::READY) {
+        // Data received so far stays in the receive buffer for the next call.
+        return false;
+      }
+      // Read errors are not fatal here: the line may still arrive after the other end has reconnected.
+      receive();
     }
-    return readData.value();
+
+    // Now the delimiter has been found at position delimPos.
+    waitResult = WaitResult::READY;
+    _receiveBuffer.consume(delimPos.value(), line);
+    _receiveBuffer.discard(delimiter.size());
+    return true;
+  } // end readlineUntil
+
+  /********************************************************************************************************************/
+
+  bool SerialPort::readBytesUntil(const size_t nBytesToRead, const std::optional<Clock::time_point>& deadline,
+      WaitResult& waitResult, std::string& bytes, const ReceiveObserver& onReceive) {
+    // Read until we've read nBytesToRead, with possible interrupts through terminateRead() or the deadline.
+    // Bytes which have been received by a previous readline are used first.
+    size_t nObserved = 0;
+    auto observe = [&] {
+      size_t nAvailable = std::min(_receiveBuffer.size(), nBytesToRead);
+      if(onReceive and nAvailable > nObserved) {
+        onReceive(_receiveBuffer.view().substr(nObserved, nAvailable - nObserved));
+        nObserved = nAvailable;
+      }
+    };
+
+    waitResult = WaitResult::READY;
+    observe();
+    while(_receiveBuffer.size() < nBytesToRead) {
+      waitResult = waitForInput(deadline);
+      if(waitResult != WaitResult::READY) {
+        return false;
+      }
+
+      if(receive() < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+        std::ostringstream errorMsg;
+        errorMsg << "Read error: " << strerrorname_np(errno) << " (" << strerrordesc_np(errno) << ")";
+        throw ChimeraTK::runtime_error(errorMsg.str());
+      }
+      observe();
+    }
+
+    _receiveBuffer.consume(nBytesToRead, bytes);
+    return true;
+  } // end readBytesUntil
+
+  /********************************************************************************************************************/
+
+  ssize_t SerialPort::receive() noexcept {
+    static constexpr size_t minReadSize = 256;
+    auto space = _receiveBuffer.prepare(minReadSize);
+    ssize_t bytesRead = read(_fileDescriptor, space.data(), space.size()); // unistd::read
+    if(bytesRead > 0) {
+      _receiveBuffer.commit(static_cast<size_t>(bytesRead));
+      _hasHungUp = false;
+    }
+    else if(bytesRead < 0 and errno != EAGAIN and errno != EWOULDBLOCK and errno != EINTR) {
+      _hasHungUp = true;
+    }
+    return bytesRead;
+  }
+
+  /********************************************************************************************************************/
+
+  bool SerialPort::waitForPendingInput(const std::chrono::milliseconds& timeout) const noexcept {
+    pollfd fd{_fileDescriptor, POLLIN, 0};
+    // An interrupted poll() counts as nothing pending, the caller will wait again.
+    return poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
   }
 
   /********************************************************************************************************************/
 
   void SerialPort::terminateRead() {
     _terminateRead = true;
+    uint64_t one = 1;
+    // If the write fails, the eventfd counter is already saturated, so a wakeup is pending anyway.
+    [[maybe_unused]] ssize_t ret = write(_wakeupFileDescriptor, &one, sizeof(one));
+  }
+
+  /********************************************************************************************************************/
+
+  void SerialPort::clearTerminateRead() noexcept {
+    _terminateRead = false;
+    uint64_t counter;
+    [[maybe_unused]] ssize_t ret = read(_wakeupFileDescriptor, &counter, sizeof(counter)); // drains the eventfd
+  }
+
+  /********************************************************************************************************************/
+
+  SerialPort::WaitResult SerialPort::waitForInput(const std::optional<Clock::time_point>& deadline) noexcept {
+    static constexpr int hangupRetryIntervalInMilliseconds = 1;
+    std::array<pollfd, 2> fds{pollfd{_fileDescriptor, POLLIN, 0}, pollfd{_wakeupFileDescriptor, POLLIN, 0}};
+
+    while(not _terminateRead) {
+      // poll() takes the timeout in milliseconds. Round up so we never return before the deadline has passed.
+      int pollTimeout = -1;
+      if(deadline.has_value()) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline.value() - Clock::now());
+        if(remaining.count() <= 0) {
+          return WaitResult::TIMED_OUT;
+        }
+        pollTimeout = static_cast<int>(remaining.count());
+      }
+
+      int ret = poll(fds.data(), fds.size(), pollTimeout);
+      if(ret < 0) {
+        if(errno == EINTR) {
+          continue;
+        }
+        return WaitResult::TERMINATED;
+      }
+      if(ret == 0) {
+        continue; // re-evaluates the deadline
+      }
+      if(fds[1].revents & POLLIN) {
+        break; // woken up by terminateRead()
+      }
+      if(fds[0].revents & POLLNVAL) {
+        return WaitResult::TERMINATED;
+      }
+      if(fds[0].revents & (POLLHUP | POLLERR)) {
+        _hasHungUp = true; // cleared again if data arrives
+      }
+      if(fds[0].revents & POLLIN) {
+        return WaitResult::READY;
+      }
+      if(fds[0].revents & (POLLHUP | POLLERR)) {
+        // The other end of the line is gone (e.g. a pty without a peer). The port will report the hangup on every
+        // poll, so wait for a reconnection on the wakeup file descriptor only, which keeps the wait interruptible.
+        ret = poll(&fds[1], 1, hangupRetryIntervalInMilliseconds);
+        if(ret > 0) {
+          break;
+        }
+        return WaitResult::READY; // let the caller retry the read
+      }
+    }
+    return WaitResult::TERMINATED;
   }
 
 } // namespace ChimeraTK
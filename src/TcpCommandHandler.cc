@@ -4,6 +4,8 @@
 
 #include "stringUtils.h"
 
+#include <ChimeraTK/Exception.h>
+
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
@@ -15,34 +17,139 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   TcpCommandHandler::TcpCommandHandler(const std::string& host, const std::string& port, const std::string& _delimiter,
-      const ulong timeoutInMilliseconds)
+      const ulong timeoutInMilliseconds, size_t nIoThreads)
   : CommandHandler(_delimiter, timeoutInMilliseconds) {
-    _tcpDevice = std::make_unique<TcpSocket>(host, port);
+    _tcpDevice = std::make_unique<TcpSocket>(host, port, nIoThreads);
     _tcpDevice->connect();
   }
 
   /********************************************************************************************************************/
 
-  std::vector<std::string> TcpCommandHandler::sendCommandAndReadLinesImpl(
-      std::string cmd, size_t nLinesToRead, const Delimiter& writeDelimiter, const Delimiter& readDelimiter) {
-    std::vector<std::string> ret;
+  void TcpCommandHandler::sendCommandAndReadLinesImpl(std::string_view cmd, size_t nLinesToRead,
+      const Delimiter& writeDelimiter, const Delimiter& readDelimiter, std::vector<std::string>& lines) {
+    postSend(cmd, writeDelimiter);
 
-    _tcpDevice->send(cmd + toString(writeDelimiter));
+    try {
+      readLinesImpl(nLinesToRead, readDelimiter, lines, timeout);
+    }
+    catch(...) {
+      // A failed send is the root cause of a failing read, so report it first.
+      throwIfSendFailed();
+      throw;
+    }
+    throwIfSendFailed();
+  }
 
-    std::string delim = toStringGuarded(readDelimiter);
-    for(size_t line = 0; line < nLinesToRead; ++line) {
-      ret.push_back(_tcpDevice->readlineWithTimeout(timeout, delim));
+  /********************************************************************************************************************/
+
+  void TcpCommandHandler::sendCommandAndReadBytesImpl(std::string_view cmd, size_t nBytesToRead,
+      const Delimiter& writeDelimiter, const ReceiveObserver& onReceive, std::string& bytes) {
+    postSend(cmd, writeDelimiter);
+
+    try {
+      bytes = _tcpDevice->readBytesWithTimeout(nBytesToRead, timeout, onReceive);
+    }
+    catch(...) {
+      throwIfSendFailed();
+      throw;
     }
+    throwIfSendFailed();
+  }
+
+  /********************************************************************************************************************/
+
+  std::string TcpCommandHandler::sendCommandAndReadBlockImpl(
+      std::string_view cmd, size_t nBytesExpected, const Delimiter& writeDelimiter, const std::string& terminator) {
+    postSend(cmd, writeDelimiter);
+
+    std::string ret;
+    try {
+      ret = readBlock([&](size_t nBytes) { return _tcpDevice->readBytesWithTimeout(nBytes, timeout); },
+          nBytesExpected, terminator);
+    }
+    catch(...) {
+      throwIfSendFailed();
+      throw;
+    }
+    throwIfSendFailed();
 
     return ret;
   }
 
   /********************************************************************************************************************/
 
-  std::string TcpCommandHandler::sendCommandAndReadBytesImpl(
-      std::string cmd, size_t nBytesToRead, const Delimiter& writeDelimiter) {
-    _tcpDevice->send(cmd + toString(writeDelimiter));
-    return _tcpDevice->readBytesWithTimeout(nBytesToRead, timeout);
+  void TcpCommandHandler::sendCommandImpl(std::string_view cmd, const Delimiter& writeDelimiter) {
+    _tcpDevice->send(appendWriteDelimiter(cmd, writeDelimiter));
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpCommandHandler::readLinesImpl(size_t nLinesToRead, const Delimiter& readDelimiter,
+      std::vector<std::string>& lines, std::chrono::milliseconds readTimeout) {
+    lines.resize(nLinesToRead);
+    std::string delim = toStringGuarded(readDelimiter);
+    auto deadline = Clock::now() + readTimeout;
+    for(auto& line : lines) {
+      do {
+        line = _tcpDevice->readlineWithTimeout(getRemainingTime(deadline), delim);
+      } while(isUnsolicited(line));
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpCommandHandler::readBytesImpl(size_t nBytesToRead, std::string& bytes, std::chrono::milliseconds readTimeout,
+      const ReceiveObserver& onReceive) {
+    bytes = _tcpDevice->readBytesWithTimeout(nBytesToRead, readTimeout, onReceive);
+  }
+
+  /********************************************************************************************************************/
+
+  std::string TcpCommandHandler::readBlockImpl(
+      size_t nBytesExpected, const std::string& terminator, std::chrono::milliseconds readTimeout) {
+    return readBlock([&](size_t nBytes) { return _tcpDevice->readBytesWithTimeout(nBytes, readTimeout); },
+        nBytesExpected, terminator);
+  }
+
+  /********************************************************************************************************************/
+
+  bool TcpCommandHandler::readLineImpl(std::string& line, std::chrono::milliseconds readTimeout) {
+    auto received = _tcpDevice->tryReadlineWithTimeout(readTimeout, delimiter);
+    if(not received) {
+      return false;
+    }
+    line = std::move(*received);
+    return true;
+  }
+
+  /********************************************************************************************************************/
+
+  bool TcpCommandHandler::waitForInputImpl(std::chrono::milliseconds timeout) {
+    return _tcpDevice->waitForPendingInput(timeout);
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpCommandHandler::postSend(std::string_view cmd, const Delimiter& writeDelimiter) {
+    {
+      std::lock_guard<std::mutex> lock(_sendResultMutex);
+      _sendResult.reset();
+    }
+    _tcpDevice->asyncSendFrom(appendWriteDelimiter(cmd, writeDelimiter), [this](const boost::system::error_code& ec) {
+      std::lock_guard<std::mutex> lock(_sendResultMutex);
+      _sendResult = ec;
+      _sendCompleted.notify_one();
+    });
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpCommandHandler::throwIfSendFailed() {
+    std::unique_lock<std::mutex> lock(_sendResultMutex);
+    _sendCompleted.wait(lock, [this] { return _sendResult.has_value(); });
+    if(auto ec = *_sendResult) {
+      throw ChimeraTK::runtime_error("Error sending: " + ec.message());
+    }
   }
 
   /********************************************************************************************************************/
@@ -5,17 +5,68 @@
 
 #include <ChimeraTK/Exception.h>
 
+#include <poll.h> //For waiting on the socket outside of the reactor
+
+#include <algorithm>
 #include <optional>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace ChimeraTK {
-  TcpSocket::TcpSocket(std::string host, std::string port)
-  : _socket(_io_context), _resolver(_io_context), _host(std::move(host)), _port(std::move(port)) {}
+
+  namespace {
+    /**
+     * The outcome of an operation on the reactor, which the calling thread waits for. Unlike a std::promise it does not
+     * allocate: it lives on the stack of the waiting thread, which only returns after complete() has released the lock.
+     */
+    template<typename ResultType>
+    class Completion {
+     public:
+      template<typename... Result>
+      void complete(const boost::system::error_code& ec, Result&&... result) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _error = ec;
+        if constexpr(not std::is_void_v<ResultType>) {
+          if(not ec) {
+            _result.emplace(std::forward<Result>(result)...);
+          }
+        }
+        _isComplete = true;
+        _completed.notify_one();
+      }
+
+      /** Wait for complete(). @returns the error code passed to it. */
+      boost::system::error_code wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _completed.wait(lock, [this] { return _isComplete; });
+        return _error;
+      }
+
+      /** The result passed to complete(), if there was no error. */
+      ResultType takeResult() {
+        if constexpr(not std::is_void_v<ResultType>) {
+          return std::move(*_result);
+        }
+      }
+
+     private:
+      std::mutex _mutex;
+      std::condition_variable _completed;
+      bool _isComplete{false};
+      boost::system::error_code _error;
+      std::optional<std::conditional_t<std::is_void_v<ResultType>, bool, ResultType>> _result;
+    };
+  } // namespace
+  TcpSocket::TcpSocket(std::string host, std::string port, size_t nIoThreads)
+  : _reactor(IoReactor::getInstance(nIoThreads)), _strand(boost::asio::make_strand(_reactor->getIoContext())),
+    _socket(_strand), _resolver(_strand), _host(std::move(host)), _port(std::move(port)) {}
 
   /********************************************************************************************************************/
 
   void TcpSocket::connect() {
     // Resolve the host and port, and connect to the server.
+    // Nothing else uses the socket before it is connected, so this can run in the calling thread.
     boost::system::error_code ec;
     try {
       auto endpoints = _resolver.resolve(_host, _port);
@@ -27,22 +78,22 @@ namespace ChimeraTK {
     if(ec) {
       throw ChimeraTK::runtime_error("Connection failed");
     }
+    _isDisconnecting = false;
     _opened = true;
   }
 
   /********************************************************************************************************************/
 
   void TcpSocket::disconnect() {
-    boost::system::error_code ec;
-    try {
-      _socket.cancel(ec);
-    }
-    catch(std::exception& e) {
-      throw ChimeraTK::runtime_error(e.what());
-    }
-    if(ec) {
-      throw ChimeraTK::runtime_error("Error when disconnecting");
-    }
+    // The socket may only be touched from the strand.
+    waitFor<void>("Disconnect", [this](auto done) {
+      boost::system::error_code ec;
+      _isDisconnecting = true;
+      if(_socket.is_open()) {
+        _socket.cancel(ec);
+      }
+      done(ec);
+    });
     _opened = false;
   }
 
@@ -57,94 +108,244 @@ namespace ChimeraTK {
       // We catch here and terminate to make the linter happy.
       std::terminate();
     }
+    // Handlers of cancelled operations still refer to this object, so wait until they have run.
+    std::unique_lock<std::mutex> lock(_pendingOperationsMutex);
+    _pendingOperationsCondition.wait(lock, [this] { return _pendingOperations == 0; });
   }
 
   /********************************************************************************************************************/
 
-  void TcpSocket::send(const std::string& command) {
-    assert(_opened);
-
-    boost::system::error_code ec;
-    try {
-      boost::asio::write(_socket, boost::asio::buffer(command));
-    }
-    catch(std::exception& e) {
-      throw ChimeraTK::runtime_error(e.what());
+  template<typename Handler>
+  auto TcpSocket::trackOperation(Handler handler) {
+    {
+      std::lock_guard<std::mutex> lock(_pendingOperationsMutex);
+      ++_pendingOperations;
     }
-    if(ec) {
-      throw ChimeraTK::runtime_error("Error sending");
+    return [this, handler = std::move(handler)](auto&&... args) {
+      handler(std::forward<decltype(args)>(args)...);
+      std::lock_guard<std::mutex> lock(_pendingOperationsMutex);
+      --_pendingOperations;
+      _pendingOperationsCondition.notify_all();
+    };
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename Handler>
+  void TcpSocket::postToStrand(Handler handler) {
+    boost::asio::post(_strand, HandlerWithMemory<Handler>(_handlerMemory, std::move(handler)));
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename ResultType, typename AsyncOperation>
+  ResultType TcpSocket::waitFor(const char* operation, AsyncOperation&& asyncOperation) {
+    assert(not _strand.running_in_this_thread()); // would dead-lock
+
+    Completion<ResultType> completion;
+    auto done = [&completion](const boost::system::error_code& ec, auto... result) {
+      completion.complete(ec, std::move(result)...);
+    };
+    postToStrand([&asyncOperation, done]() { asyncOperation(done); });
+    if(auto ec = completion.wait()) {
+      std::string message = std::string(operation) + " operation ";
+      message += (ec == boost::asio::error::timed_out) ? "timed out" : "failed: " + ec.message();
+      throw ChimeraTK::runtime_error(message);
     }
+    return completion.takeResult();
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpSocket::send(const std::string& command) {
+    assert(_opened);
+    // The command outlives the send, as this thread waits for it.
+    waitFor<void>("Send", [this, &command](auto done) { asyncSendFrom(command, done); });
   }
 
   /********************************************************************************************************************/
 
   std::string TcpSocket::readlineWithTimeout(const std::chrono::milliseconds& timeout, const std::string& delimiter) {
-    AsyncReadFn asyncReadFn = [delimiter](auto& stream, auto& buffer, auto doOnReadFinish) {
-      boost::asio::async_read_until(stream, buffer, delimiter, doOnReadFinish);
-    };
-    return readWithTimeout(timeout, asyncReadFn);
+    assert(_opened);
+    return waitFor<std::string>("Readline", [&](auto done) { asyncReadline(delimiter, timeout, done); });
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<std::string> TcpSocket::tryReadlineWithTimeout(
+      const std::chrono::milliseconds& timeout, const std::string& delimiter) {
+    assert(_opened);
+    return waitFor<std::optional<std::string>>("Readline", [&](auto done) {
+      asyncReadline(delimiter, timeout, [done](const boost::system::error_code& ec, std::string line) {
+        if(ec == boost::asio::error::timed_out) {
+          done({}, std::optional<std::string>());
+          return;
+        }
+        done(ec, std::optional<std::string>(std::move(line)));
+      });
+    });
   }
 
   /********************************************************************************************************************/
 
-  std::string TcpSocket::readBytesWithTimeout(size_t nBytesToRead, const std::chrono::milliseconds& timeout) {
+  std::string TcpSocket::readBytesWithTimeout(
+      size_t nBytesToRead, const std::chrono::milliseconds& timeout, const ReceiveObserver& onReceive) {
     if(nBytesToRead == 0) {
       return "";
     }
-    AsyncReadFn asyncReadFn = [nBytesToRead](auto& stream, auto& buffer, auto doOnReadFinish) {
-      boost::asio::async_read(stream, buffer, boost::asio::transfer_exactly(nBytesToRead), doOnReadFinish);
-    };
-    return readWithTimeout(timeout, asyncReadFn);
+    assert(_opened);
+    // The calling thread waits, so the observer is not used concurrently although it runs on a reactor thread.
+    return waitFor<std::string>(
+        "ReadBytes", [&](auto done) { asyncReadBytes(nBytesToRead, timeout, done, onReceive); });
   }
 
   /********************************************************************************************************************/
 
-  constexpr auto timeoutError = boost::asio::error::operation_aborted;
+  bool TcpSocket::waitForPendingInput(const std::chrono::milliseconds& timeout) noexcept {
+    assert(_opened);
+    // poll() does not consume anything, so it does not interfere with the reactor watching the same socket.
+    pollfd fd{_socket.native_handle(), POLLIN, 0};
+    return poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+  }
 
   /********************************************************************************************************************/
 
-  std::string TcpSocket::readWithTimeout(const std::chrono::milliseconds& timeout, const AsyncReadFn& asyncReadFn) {
-    assert(_opened);
-    /*----------------------------------------------------------------------------------------------------------------*/
-    // Set a timer, with doOnTimeout executing when it expires.
-    boost::asio::steady_timer timer(_io_context);
-    timer.expires_after(timeout);
-    bool readCompleted = false;
-    auto doOnTimeout = [&](const boost::system::error_code& error) {
-      if(not(readCompleted or error)) {
-        _socket.cancel(); // Causes error = errorCode = timeoutError
-      }
-    };
-    timer.async_wait(doOnTimeout);
-    /*----------------------------------------------------------------------------------------------------------------*/
-    // Do read
-    boost::asio::streambuf buffer;
-    boost::system::error_code errorCode;
-
-    /* doOnReadFinish is the callback handler, executing when the read operation ends, successfully or not.
-     * If there's a timeout, doOnTimeout is called before this, with _socket.cancel() causing error = timeoutError
-     */
-    auto doOnReadFinish = [&](const boost::system::error_code& error, std::size_t /*bytesTransferred*/) {
-      readCompleted = true;
-      timer.cancel();
-      errorCode = error;
+  void TcpSocket::asyncSend(std::string command, SendHandler handler) {
+    // The command must outlive the write, so it is moved into a shared buffer owned by the completion handler.
+    auto buffer = std::make_shared<std::string>(std::move(command));
+    asyncSendFrom(
+        *buffer, [buffer, handler = std::move(handler)](const boost::system::error_code& ec) { handler(ec); });
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpSocket::asyncSendFrom(const std::string& command, SendHandler handler) {
+    postToStrand([this, &command, handler = trackOperation(std::move(handler))]() mutable {
+      asyncWriteFrom(command, 0, std::move(handler));
+    });
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpSocket::asyncWriteFrom(const std::string& buffer, size_t offset, SendHandler handler) {
+    boost::asio::async_write(_socket, boost::asio::buffer(buffer.data() + offset, buffer.size() - offset),
+        [this, &buffer, offset, handler = std::move(handler)](
+            const boost::system::error_code& ec, std::size_t nBytes) mutable {
+          // A read timeout cancels all operations on the socket, including a pipelined send. Only a disconnect shall
+          // abort the send, otherwise it continues with the remaining bytes.
+          if(ec == boost::asio::error::operation_aborted and not _isDisconnecting) {
+            asyncWriteFrom(buffer, offset + nBytes, std::move(handler));
+            return;
+          }
+          handler(ec);
+        });
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpSocket::asyncReadline(std::string delimiter, std::chrono::milliseconds timeout, ReadHandler handler) {
+    AsyncReadFn asyncReadFn = [delimiter](auto& stream, auto& buffer, auto doOnReadFinish) {
+      // Completes immediately if the delimiter is already in the receive buffer.
+      boost::asio::async_read_until(stream, buffer, delimiter, doOnReadFinish);
     };
+    asyncReadWithTimeout(timeout, asyncReadFn,
+        [this, delimiterSize = delimiter.size(), handler = std::move(handler)](
+            const boost::system::error_code& ec, std::size_t lineLength) {
+          if(ec) {
+            handler(ec, {});
+            return;
+          }
+          // lineLength includes the delimiter. Bytes after it stay in the receive buffer for the next read.
+          handler(ec, extractFromReceiveBuffer(lineLength - delimiterSize, lineLength));
+        });
+  }
+
+  /********************************************************************************************************************/
 
-    asyncReadFn(_socket, buffer, doOnReadFinish);
-    _io_context.run();
-    /*----------------------------------------------------------------------------------------------------------------*/
-    // Clean-up
-    _io_context.reset();
-    /*----------------------------------------------------------------------------------------------------------------*/
-    if(errorCode) {
-      if(errorCode == timeoutError) {
-        throw ChimeraTK::runtime_error("Readline operation timed out");
+  void TcpSocket::asyncReadBytes(
+      size_t nBytesToRead, std::chrono::milliseconds timeout, ReadHandler handler, ReceiveObserver onReceive) {
+    AsyncReadFn asyncReadFn = [nBytesToRead, onReceive = std::move(onReceive)](
+                                  auto& stream, auto& buffer, auto doOnReadFinish) {
+      // Passes the bytes of the response which have not been observed yet. The streambuf data is contiguous.
+      auto observe = [&buffer, nBytesToRead, onReceive, nObserved = size_t{0}]() mutable {
+        size_t nAvailable = std::min(buffer.size(), nBytesToRead);
+        if(onReceive and nAvailable > nObserved) {
+          std::string_view received(static_cast<const char*>(buffer.data().data()), nAvailable);
+          onReceive(received.substr(nObserved));
+          nObserved = nAvailable;
+        }
+        return nAvailable;
+      };
+
+      // Use up bytes which have been received by a previous read first.
+      if(observe() >= nBytesToRead) {
+        boost::asio::post(stream.get_executor(), [doOnReadFinish] { doOnReadFinish({}, 0); });
+        return;
       }
-      throw ChimeraTK::runtime_error(errorCode.message());
-    }
-    /*----------------------------------------------------------------------------------------------------------------*/
-    // Extract the data from the streambuf
-    return std::string{std::istreambuf_iterator<char>(&buffer), {}};
+      // Like transfer_exactly, but the completion condition is evaluated after each partial read.
+      auto completionCondition = [observe, nBytesToRead](
+                                     const boost::system::error_code& ec, std::size_t) mutable -> std::size_t {
+        size_t nAvailable = observe();
+        return (ec or nAvailable >= nBytesToRead) ? 0 : nBytesToRead - nAvailable;
+      };
+      boost::asio::async_read(stream, buffer, completionCondition, doOnReadFinish);
+    };
+    asyncReadWithTimeout(timeout, asyncReadFn,
+        [this, nBytesToRead, handler = std::move(handler)](const boost::system::error_code& ec, std::size_t) {
+          if(ec) {
+            handler(ec, {});
+            return;
+          }
+          handler(ec, extractFromReceiveBuffer(nBytesToRead, nBytesToRead));
+        });
+  }
+
+  /********************************************************************************************************************/
+
+  std::string TcpSocket::extractFromReceiveBuffer(size_t nBytesToReturn, size_t nBytesToConsume) {
+    auto begin = boost::asio::buffers_begin(_receiveBuffer.data());
+    std::string output(begin, begin + static_cast<std::ptrdiff_t>(nBytesToReturn));
+    _receiveBuffer.consume(nBytesToConsume);
+    return output;
+  }
+
+  /********************************************************************************************************************/
+
+  void TcpSocket::asyncReadWithTimeout(const std::chrono::milliseconds& timeout, AsyncReadFn asyncReadFn,
+      std::function<void(const boost::system::error_code&, std::size_t)> onReadFinish) {
+    boost::asio::post(_strand, [this, timeout, asyncReadFn = std::move(asyncReadFn),
+                                   onReadFinish = trackOperation(std::move(onReadFinish))]() mutable {
+      /*--------------------------------------------------------------------------------------------------------------*/
+      // Set a timer, with doOnTimeout executing when it expires.
+      // Timer and state are shared by both handlers, and live until the last of them has run.
+      auto timer = std::make_shared<boost::asio::steady_timer>(_strand, timeout);
+      auto readCompleted = std::make_shared<bool>(false);
+      auto hasTimedOut = std::make_shared<bool>(false);
+      // Once the read has completed, this handler must not touch the socket anymore: it might be destroyed already.
+      timer->async_wait([this, timer, readCompleted, hasTimedOut](const boost::system::error_code& error) {
+        if(not(*readCompleted or error)) {
+          *hasTimedOut = true;
+          _socket.cancel(); // Causes error = operation_aborted in the read handler
+        }
+      });
+      /*--------------------------------------------------------------------------------------------------------------*/
+      // Do read into the persistent receive buffer. Data received before an error stays in the receive buffer.
+      /* doOnReadFinish is the callback handler, executing when the read operation ends, successfully or not.
+       * If there's a timeout, doOnTimeout is called before this, with _socket.cancel() causing the error
+       * operation_aborted. It is reported as timed_out, to tell it from an abort by disconnect().
+       */
+      auto doOnReadFinish = [timer, readCompleted, hasTimedOut, onReadFinish = std::move(onReadFinish)](
+                                const boost::system::error_code& error, std::size_t bytesTransferred) {
+        *readCompleted = true;
+        timer->cancel();
+        if(*hasTimedOut and error == boost::asio::error::operation_aborted) {
+          onReadFinish(boost::asio::error::timed_out, bytesTransferred);
+          return;
+        }
+        onReadFinish(error, bytesTransferred);
+      };
+      asyncReadFn(_socket, _receiveBuffer, doOnReadFinish);
+    });
   }
 
   /********************************************************************************************************************/
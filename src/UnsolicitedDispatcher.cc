@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "UnsolicitedDispatcher.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  UnsolicitedDispatcher::~UnsolicitedDispatcher() {
+    stopListening();
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::addRegister(std::shared_ptr<const CompiledRegisterPlan> plan) {
+    assert(plan->unsolicitedResponseMatcher);
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) { return entry.plan == plan; });
+    if(it == _entries.end()) {
+      _entries.push_back({std::move(plan), {}});
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::subscribe(
+      std::shared_ptr<const CompiledRegisterPlan> plan, std::shared_ptr<Subscription> subscription) {
+    addRegister(plan);
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) { return entry.plan == plan; });
+    it->subscriptions.push_back(std::move(subscription));
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::unsubscribe(const Subscription* subscription) {
+    std::vector<std::shared_ptr<Subscription>> removed;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for(auto& entry : _entries) {
+        auto& subscriptions = entry.subscriptions;
+        auto it = std::stable_partition(subscriptions.begin(), subscriptions.end(),
+            [&](const std::shared_ptr<Subscription>& s) { return s.get() != subscription; });
+        std::move(it, subscriptions.end(), std::back_inserter(removed));
+        subscriptions.erase(it, subscriptions.end());
+      }
+    }
+    // The subscription is destroyed without the lock held, as it releases its accessors.
+  }
+
+  /********************************************************************************************************************/
+
+  bool UnsolicitedDispatcher::dispatch(std::string_view line) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(const auto& entry : _entries) {
+      if(not entry.plan->unsolicitedResponseMatcher->match(line, _match)) {
+        continue;
+      }
+      if(_isActive) {
+        for(const auto& subscription : entry.subscriptions) {
+          subscription->push(_match);
+        }
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::activate() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _isActive = true;
+    }
+    _wakeUp.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::deactivate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isActive = false;
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::sendException(const std::exception_ptr& e) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(not _isActive) {
+      return;
+    }
+    _isActive = false;
+    for(const auto& entry : _entries) {
+      for(const auto& subscription : entry.subscriptions) {
+        subscription->sendException(e);
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  bool UnsolicitedDispatcher::isActive() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _isActive;
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::startListening(std::function<void()> listen) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_listener.joinable()) {
+      return;
+    }
+    _listen = std::move(listen);
+    _stopListening = false;
+    _listener = std::thread([this] { this->listen(); });
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::stopListening() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopListening = true;
+    }
+    _wakeUp.notify_all();
+    if(_listener.joinable()) {
+      _listener.join();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void UnsolicitedDispatcher::listen() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(not _stopListening) {
+      if(not _isActive) {
+        _wakeUp.wait(lock);
+        continue;
+      }
+      // Without the lock, as the line read reaches dispatch().
+      lock.unlock();
+      try {
+        _listen();
+      }
+      catch(const ChimeraTK::logic_error&) {
+        // Only possible if the device is being closed. The listener is stopped then.
+      }
+      lock.lock();
+      _wakeUp.wait_for(lock, listenPause, [&] { return _stopListening; });
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -5,6 +5,8 @@
 
 #include <ChimeraTK/Exception.h> //for ChimeraTK::logic_error
 
+#include <cctype>
+
 namespace ChimeraTK {
   /********************************************************************************************************************/
 
@@ -36,4 +38,46 @@ namespace ChimeraTK {
   }
 
   /********************************************************************************************************************/
+
+  std::optional<InjaTag> parseSimpleInjaTag(const std::string& pattern, size_t pos) {
+    size_t i = pos + 2;
+    auto skipSpaces = [&]() {
+      while(i < pattern.size() and pattern[i] == ' ') {
+        ++i;
+      }
+    };
+    skipSpaces();
+    size_t keyBegin = i;
+    while(i < pattern.size() and std::isalpha(static_cast<unsigned char>(pattern[i]))) {
+      ++i;
+    }
+    if(i == keyBegin or i >= pattern.size() or pattern[i] != '.') {
+      return std::nullopt;
+    }
+    std::string key = pattern.substr(keyBegin, i - keyBegin);
+    ++i; // skip '.'
+    size_t indexBegin = i;
+    size_t index = 0;
+    while(i < pattern.size() and std::isdigit(static_cast<unsigned char>(pattern[i]))) {
+      index = index * 10 + static_cast<size_t>(pattern[i] - '0');
+      ++i;
+    }
+    if(i == indexBegin) {
+      return std::nullopt;
+    }
+    skipSpaces();
+    if(pattern.compare(i, 2, "}}") != 0) {
+      return std::nullopt;
+    }
+    return InjaTag{std::move(key), index, i + 2 - pos};
+  }
+
+  /********************************************************************************************************************/
+
+  bool usesInjaStatements(const std::string& pattern) {
+    return pattern.find("{%") != std::string::npos or pattern.find("{#") != std::string::npos or
+        pattern.find("##") != std::string::npos;
+  }
+
+  /********************************************************************************************************************/
 } // end namespace ChimeraTK
@@ -6,13 +6,16 @@
 #include <cctype>
 #include <cstddef> //Added by ninja fix-linter, maybe for size_t. Likely not needed.
 #include <cstring>
-#include <functional>
 #include <iostream>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#endif
+
 std::vector<std::string> splitString(const std::string& stringToBeParsed, const std::string& delimiter) noexcept {
   std::vector<std::string> subStrings;
   size_t pos = 0;
@@ -110,6 +113,206 @@ std::string getLower(const std::string& str) noexcept {
 
 /**********************************************************************************************************************/
 
+/*
+ * Returns the pair of hexidecimal chars for {high nibble, low nibble"
+ */
+inline std::pair<char, char> getHexDigitsFromByte(unsigned char byte) {
+  char upper = "0123456789ABCDEF"[(static_cast<unsigned>(byte) >> 4U) & 0xFU];
+  char lower = "0123456789ABCDEF"[static_cast<unsigned>(byte) & 0xFU]; // char array isn't store 2x
+  return {upper, lower};
+}
+
+/**********************************************************************************************************************/
+
+/*
+ * Returns the value of a hex digit. Anything else is treated like a lower case digit, which the SIMD kernels reproduce.
+ */
+inline unsigned char binCharFromHexChar(unsigned char hex) noexcept {
+  if((hex >= '0') && (hex <= '9')) {
+    return hex - '0';
+  }
+  if((hex >= 'A') && (hex <= 'F')) {
+    return hex + 10 - 'A';
+  }
+  // else 'a'-'f'
+  return hex + 10 - 'a';
+}
+
+/**********************************************************************************************************************/
+// Hex kernels. Each processes as many whole blocks as it can and leaves the rest to the scalar one.
+
+static void encodeHexScalar(const char* bytes, size_t nBytes, char* hexOut) noexcept {
+  for(size_t i = 0; i < nBytes; ++i) {
+    auto [highNibble, lowNibble] = getHexDigitsFromByte(static_cast<unsigned char>(bytes[i]));
+    hexOut[2 * i] = highNibble;
+    hexOut[2 * i + 1] = lowNibble;
+  }
+}
+
+static void decodeHexScalar(const char* hex, size_t nBytes, char* bytesOut) noexcept {
+  for(size_t i = 0; i < nBytes; ++i) {
+    const unsigned char hiNibble = (binCharFromHexChar(hex[2 * i]) << 4U);
+    const unsigned char loNibble = binCharFromHexChar(hex[2 * i + 1]);
+    bytesOut[i] = static_cast<char>(hiNibble | loNibble);
+  }
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define COMMAND_BASED_BACKEND_HEX_SIMD
+
+/*
+ * For nibbles 0 to 15 in each byte, the ASCII code of the upper case hex digit: '0' + n, plus 7 above 9.
+ */
+static inline __m128i hexDigitsSse2(__m128i nibbles) {
+  __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(isLetter, _mm_set1_epi8(7)));
+}
+
+/*
+ * The value of each hex digit like binCharFromHexChar(): c - 'a' + 10, plus 32 for 'A' to 'F', plus 39 for digits.
+ */
+static inline __m128i hexValuesSse2(__m128i chars) {
+  __m128i isDigit = _mm_and_si128(
+      _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+  __m128i isUpper = _mm_and_si128(
+      _mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('F' + 1)));
+  __m128i values = _mm_sub_epi8(chars, _mm_set1_epi8('a' - 10));
+  values = _mm_add_epi8(values, _mm_and_si128(isUpper, _mm_set1_epi8(32)));
+  return _mm_add_epi8(values, _mm_and_si128(isDigit, _mm_set1_epi8(39)));
+}
+
+/*
+ * Combine the values of the digit pairs in each 16 bit lane to a byte in the low half: (high << 4) | low, in 8 bits.
+ */
+static inline __m128i combineNibblesSse2(__m128i values) {
+  __m128i high = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x000F)), 4);
+  return _mm_or_si128(high, _mm_srli_epi16(values, 8));
+}
+
+static void encodeHexSse2(const char* bytes, size_t nBytes, char* hexOut) noexcept {
+  size_t i = 0;
+  for(; i + 16 <= nBytes; i += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    __m128i high = hexDigitsSse2(_mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F)));
+    __m128i low = hexDigitsSse2(_mm_and_si128(in, _mm_set1_epi8(0x0F)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hexOut + 2 * i), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hexOut + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+  }
+  encodeHexScalar(bytes + i, nBytes - i, hexOut + 2 * i);
+}
+
+static void decodeHexSse2(const char* hex, size_t nBytes, char* bytesOut) noexcept {
+  size_t i = 0;
+  for(; i + 16 <= nBytes; i += 16) {
+    __m128i first = hexValuesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i)));
+    __m128i second = hexValuesSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i + 16)));
+    __m128i out = _mm_packus_epi16(combineNibblesSse2(first), combineNibblesSse2(second));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytesOut + i), out);
+  }
+  decodeHexScalar(hex + 2 * i, nBytes - i, bytesOut + i);
+}
+
+/**********************************************************************************************************************/
+
+/*
+ * The AVX2 versions of hexDigitsSse2() and hexValuesSse2() followed by combineNibblesSse2().
+ */
+__attribute__((target("avx2"))) static inline __m256i hexDigitsAvx2(__m256i nibbles) {
+  __m256i isLetter = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+  return _mm256_add_epi8(
+      _mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), _mm256_and_si256(isLetter, _mm256_set1_epi8(7)));
+}
+
+__attribute__((target("avx2"))) static inline __m256i bytesFromHexAvx2(__m256i chars) {
+  __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+  __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('A' - 1)),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8('F' + 1), chars));
+  __m256i values = _mm256_sub_epi8(chars, _mm256_set1_epi8('a' - 10));
+  values = _mm256_add_epi8(values, _mm256_and_si256(isUpper, _mm256_set1_epi8(32)));
+  values = _mm256_add_epi8(values, _mm256_and_si256(isDigit, _mm256_set1_epi8(39)));
+  __m256i high = _mm256_slli_epi16(_mm256_and_si256(values, _mm256_set1_epi16(0x000F)), 4);
+  return _mm256_or_si256(high, _mm256_srli_epi16(values, 8));
+}
+
+__attribute__((target("avx2"))) static void encodeHexAvx2(const char* bytes, size_t nBytes, char* hexOut) noexcept {
+  size_t i = 0;
+  for(; i + 32 <= nBytes; i += 32) {
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+    __m256i high = hexDigitsAvx2(_mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F)));
+    __m256i low = hexDigitsAvx2(_mm256_and_si256(in, _mm256_set1_epi8(0x0F)));
+    // Unpacking works within the 128 bit lanes, so the halves are in the order 0-7, 16-23 and 8-15, 24-31.
+    __m256i interleavedLow = _mm256_unpacklo_epi8(high, low);
+    __m256i interleavedHigh = _mm256_unpackhi_epi8(high, low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hexOut + 2 * i),
+        _mm256_permute2x128_si256(interleavedLow, interleavedHigh, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hexOut + 2 * i + 32),
+        _mm256_permute2x128_si256(interleavedLow, interleavedHigh, 0x31));
+  }
+  encodeHexSse2(bytes + i, nBytes - i, hexOut + 2 * i);
+}
+
+__attribute__((target("avx2"))) static void decodeHexAvx2(const char* hex, size_t nBytes, char* bytesOut) noexcept {
+  size_t i = 0;
+  for(; i + 32 <= nBytes; i += 32) {
+    __m256i first = bytesFromHexAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i)));
+    __m256i second = bytesFromHexAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i + 32)));
+    // Packing works within the 128 bit lanes as well, restore the order of the 64 bit quarters.
+    __m256i packed = _mm256_packus_epi16(first, second);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytesOut + i), _mm256_permute4x64_epi64(packed, 0xD8));
+  }
+  decodeHexSse2(hex + 2 * i, nBytes - i, bytesOut + i);
+}
+
+#endif // x86_64
+
+/**********************************************************************************************************************/
+
+HexKernel getHexKernel() noexcept {
+#ifdef COMMAND_BASED_BACKEND_HEX_SIMD
+  static const HexKernel kernel = __builtin_cpu_supports("avx2") ? HexKernel::AVX2 : HexKernel::SSE2;
+  return kernel;
+#else
+  return HexKernel::SCALAR;
+#endif
+}
+
+/**********************************************************************************************************************/
+
+void encodeHex(const char* bytes, size_t nBytes, char* hexOut, HexKernel kernel) noexcept {
+  kernel = std::min(kernel, getHexKernel());
+#ifdef COMMAND_BASED_BACKEND_HEX_SIMD
+  if(kernel == HexKernel::AVX2) {
+    encodeHexAvx2(bytes, nBytes, hexOut);
+    return;
+  }
+  if(kernel == HexKernel::SSE2) {
+    encodeHexSse2(bytes, nBytes, hexOut);
+    return;
+  }
+#endif
+  encodeHexScalar(bytes, nBytes, hexOut);
+}
+
+/**********************************************************************************************************************/
+
+void decodeHex(const char* hex, size_t nBytes, char* bytesOut, HexKernel kernel) noexcept {
+  kernel = std::min(kernel, getHexKernel());
+#ifdef COMMAND_BASED_BACKEND_HEX_SIMD
+  if(kernel == HexKernel::AVX2) {
+    decodeHexAvx2(hex, nBytes, bytesOut);
+    return;
+  }
+  if(kernel == HexKernel::SSE2) {
+    decodeHexSse2(hex, nBytes, bytesOut);
+    return;
+  }
+#endif
+  decodeHexScalar(hex, nBytes, bytesOut);
+}
+
+/**********************************************************************************************************************/
+
 std::string binaryStrFromHexStr(const std::string& hexStr, const bool isSigned) noexcept {
   /* Use case: writing to device. We fill in the hexidecimal of interest with the regex, then convert to binary for sending.
   * If h is odd, the first byte or last will be special, requiring padding
@@ -118,19 +321,15 @@ std::string binaryStrFromHexStr(const std::string& hexStr, const bool isSigned)
   * So we need isSigned to tell us whether to move the signed bit.
   */
 
-  const std::function<unsigned char(unsigned char)> binCharFromHexChar =
-      [](unsigned char hex) noexcept -> unsigned char {
-    if((hex >= '0') && (hex <= '9')) {
-      return hex - '0';
-    }
-    if((hex >= 'A') && (hex <= 'F')) {
-      return hex + 10 - 'A';
-    }
-    // else 'a'-'f'
-    return hex + 10 - 'a';
-  };
+  std::string binOut;
+  binaryStrFromHexStr(hexStr, binOut, isSigned);
+  return binOut;
+}
 
-  std::string binOut((hexStr.length() + 1) / 2, '\x00');
+/**********************************************************************************************************************/
+
+void binaryStrFromHexStr(std::string_view hexStr, std::string& binOut, const bool isSigned) noexcept {
+  binOut.assign((hexStr.length() + 1) / 2, '\x00');
   const size_t hexLengthIsOdd = hexStr.length() % 2;
 
   if(hexLengthIsOdd) {
@@ -141,40 +340,18 @@ std::string binaryStrFromHexStr(const std::string& hexStr, const bool isSigned)
   }
 
   const auto bStart = static_cast<size_t>(hexLengthIsOdd ? 1 : 0);
-
-  for(size_t b = bStart; b < binOut.length(); ++b) {
-    const unsigned char hiNibble = (binCharFromHexChar(hexStr[(2 * b) - bStart]) << 4U);
-    const unsigned char loNibble = binCharFromHexChar(hexStr[(2 * b) + 1 - bStart]);
-    binOut[b] = static_cast<char>(hiNibble | loNibble);
-  }
-  return binOut;
+  decodeHex(hexStr.data() + bStart, binOut.length() - bStart, binOut.data() + bStart, getHexKernel());
 }
 
 /**********************************************************************************************************************/
 
-/*
- * Returns the pair of hexidecimal chars for {high nibble, low nibble"
- */
-inline std::pair<char, char> getHexDigitsFromByte(unsigned char byte) {
-  char upper = "0123456789ABCDEF"[(static_cast<unsigned>(byte) >> 4U) & 0xFU];
-  char lower = "0123456789ABCDEF"[static_cast<unsigned>(byte) & 0xFU]; // char array isn't store 2x
-  return {upper, lower};
-}
-
-/**********************************************************************************************************************/
-
-std::string hexStrFromBinaryStr(const std::string& byteStr) noexcept {
+std::string hexStrFromBinaryStr(std::string_view byteStr) noexcept {
   // Requires the byteStr.length() to be accurate, despite the expected presence of null characters.
   // So something needs to ensure it is the correct length, such as with a resize() command.
 
   std::string hexOut;
   hexOut.resize(2 * byteStr.length());
-  auto hexIt = hexOut.begin();
-  for(unsigned char byte : byteStr) {
-    auto [highNibble, lowNibble] = getHexDigitsFromByte(byte);
-    *hexIt++ = highNibble;
-    *hexIt++ = lowNibble;
-  }
+  encodeHex(byteStr.data(), byteStr.length(), hexOut.data(), getHexKernel());
   return hexOut;
 }
 
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "termiosUtils.h"
+
+#include <asm/termbits.h> //For termios2 and BOTHER. Do not include <termios.h> here.
+#include <sys/ioctl.h>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  bool setCustomBaudRate(int fileDescriptor, unsigned int baudRate) noexcept {
+    termios2 tty{};
+    if(ioctl(fileDescriptor, TCGETS2, &tty) != 0) {
+      return false;
+    }
+    // NOLINTBEGIN(hicpp-signed-bitwise)
+    tty.c_cflag &= ~CBAUD;
+    tty.c_cflag |= BOTHER;
+    tty.c_cflag &= ~(CBAUD << IBSHIFT);
+    tty.c_cflag |= BOTHER << IBSHIFT;
+    // NOLINTEND(hicpp-signed-bitwise)
+    tty.c_ispeed = baudRate;
+    tty.c_ospeed = baudRate;
+    if(ioctl(fileDescriptor, TCSETS2, &tty) != 0) {
+      return false;
+    }
+
+    // Read back to detect drivers which accept the ioctl but drop the rate.
+    if(ioctl(fileDescriptor, TCGETS2, &tty) != 0) {
+      return false;
+    }
+    return tty.c_ospeed != 0;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -82,6 +82,7 @@ void DummyServer::activate() {
   // Finally start the main loop, which accesses the serial port.
   _stopMainLoop = false;
   _mainLoopThread = boost::thread([&]() { mainLoop(); });
+  _streamThread = boost::thread([&]() { streamLoop(); });
 }
 
 void DummyServer::deactivate() {
@@ -96,6 +97,9 @@ void DummyServer::deactivate() {
       _serialPort->terminateRead();
     } while(!_mainLoopThread.try_join_for(boost::chrono::milliseconds(10)));
   }
+  if(_streamThread.joinable()) {
+    _streamThread.join();
+  }
 
   // Remove the SerialPort which is accessing the virtual serial ports provided by socat.
   _serialPort.reset();
@@ -133,6 +137,20 @@ void DummyServer::waitForStop() {
   }
 }
 
+void DummyServer::streamLoop() {
+  while(not _stopMainLoop) {
+    if(streamLimitEvents) {
+      try {
+        sendDelimited("EVT:LIMIT " + std::to_string(++nLimitEvents));
+      }
+      catch(const ChimeraTK::runtime_error&) {
+        // The backend is not reading. Keep trying, it is only a stream of events.
+      }
+    }
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+  }
+}
+
 void DummyServer::mainLoop() {
   std::string delim = ChimeraTK::SERIAL_DEFAULT_DELIMITER;
   uint64_t nIter = 0;
@@ -160,11 +178,47 @@ void DummyServer::mainLoop() {
         continue;
       }
 
+      if(responseDelay != 0) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(responseDelay));
+      }
+
+      if(sendLimitEvents) {
+        sendDelimited("EVT:LIMIT " + std::to_string(++nLimitEvents));
+      }
+
       if(sendGarbage) {
         sendDelimited("gnrbBlrpnBrtz");
         continue;
       }
-      if(data == "*CLS") {
+      if(data.find("?;") != std::string::npos) {
+        // SCPI compound command of queries, answered in one line
+        nCompoundCommands++;
+        std::string response;
+        bool isFirst = true;
+        for(const auto& query : splitString(data, ";")) {
+          if(not isFirst) {
+            response += ";";
+          }
+          isFirst = false;
+          if(query == "SOUR:FREQ:CW?") {
+            response += std::to_string(cwFrequency);
+          }
+          else if(query == "*IDN?") {
+            response += "Dummy server for command based serial backend.";
+          }
+          else if(query == "ACC? AXIS1") {
+            response += "AXIS_1=" + std::to_string(acc[0]);
+          }
+          else if(query == "ACC? AXIS2") {
+            response += "AXIS_2=" + std::to_string(acc[1]);
+          }
+          else {
+            response += query;
+          }
+        }
+        sendDelimited(response);
+      }
+      else if(data == "*CLS") {
         if(_debug) {
           std::cout << "DummyServer: Received debug clear command" << std::endl;
         }
@@ -182,6 +236,14 @@ void DummyServer::mainLoop() {
         }
         sendDelimited("Dummy server for command based serial backend.");
       }
+      else if(data == "TRACE?") {
+        // IEEE 488.2 definite length block of four big endian float32
+        std::string payload;
+        for(float value : {0.5F, -1.25F, 3.F, 1024.F}) {
+          payload += binaryStrFromFloat(value);
+        }
+        sendDelimited("#2" + std::to_string(payload.size()) + payload);
+      }
       else if(data == "SAI?") {
         sendDelimited(sai[0]);
         if(!sendTooFew) {
@@ -203,6 +265,7 @@ void DummyServer::mainLoop() {
         }
       }
       else if(data == "ACC?") {
+        nAccQueries++;
         if(responseWithDataAndSyntaxError) {
           sendDelimited("AXXIS_1=" + std::to_string(acc[0]));
         }
@@ -219,6 +282,9 @@ void DummyServer::mainLoop() {
       else if(data == "ACC? AXIS2") {
         sendDelimited("AXIS_2=" + std::to_string(acc[1]));
       }
+      else if(data == "LIMIT?") {
+        sendDelimited(std::to_string(nLimitEvents));
+      }
 
       else if(data.find("HEX ") == 0) {
         auto tokens = tokenise(data);
@@ -363,7 +429,7 @@ void DummyServer::mainLoop() {
         }
         auto replyStr = stripDelim(data, ChimeraTK::SERIAL_DEFAULT_DELIMITER,
             std::size(ChimeraTK::SERIAL_DEFAULT_DELIMITER) - 1); //-1 for null terminator
-        _serialPort->send(replyStr);                             // Do not add a delimiter here.
+        send(replyStr);                                          // Do not add a delimiter here.
       }
       else if(data.find("setByteMode") == 0) {
         // Turn the system to byte mode so that the next command will read bytesToRead rather than lines.
@@ -377,7 +443,7 @@ void DummyServer::mainLoop() {
         else {
           bytesToRead = 16;
         }
-        _serialPort->send("ok");
+        send("ok");
       }
       else {
         std::vector<std::string> lines = splitString(data, ";");
@@ -436,7 +502,7 @@ void DummyServer::mainLoop() {
         if(_debug) {
           std::cout << "DummyServer: sending " << hexStrFromBinaryStr(bflt) << std::endl;
         }
-        _serialPort->send(bflt); // sends with no delimiter
+        send(bflt); // sends with no delimiter
         byteMode = false;        // go back to line mode at the end of this command
         if(_debug) {
           std::cout << "DummyServer: Now on line mode" << std::endl;
@@ -487,15 +553,14 @@ void DummyServer::mainLoop() {
           if(_debug) {
             std::cout << "DummyServer: Writing back " << hexStrFromBinaryStr(retStr) << std::endl; // DEBUG
           }
-          _serialPort->send(retStr);
+          send(retStr);
         }
         else {
           std::string requiredChecksumStr = std::string(1, requiredChecksum);
           std::cout << "DummyServer: Bad checksum (" << hexStrFromBinaryStr(data.substr(8))
                     << ") on ulog read command: " << hexStrFromBinaryStr(data) << " expected "
                     << hexStrFromBinaryStr(requiredChecksumStr) << std::endl;
-          _serialPort->send(
-              std::string("\xBA\xDC\x50", 3) + data[8] + std::string("\x0A\x50\x20\xB0", 4) + requiredChecksumStr);
+          send(std::string("\xBA\xDC\x50", 3) + data[8] + std::string("\x0A\x50\x20\xB0", 4) + requiredChecksumStr);
           // That is to say "BADCheckSum_", what it is, "_hAS_TO_Be_", what it is required to be.
         }
         byteMode = false; // go back to line mode at the end of this command
@@ -526,21 +591,20 @@ void DummyServer::mainLoop() {
           if(_debug) {
             std::cout << "DummyServer: Writing back " << hexStrFromBinaryStr(retStr) << std::endl; // DEBUG
           }
-          _serialPort->send(retStr);
+          send(retStr);
         }
         else {
           std::cout << "DummyServer: Bad checksum (" << hexStrFromBinaryStr(data.substr(8))
                     << ") on ulog write command: " << hexStrFromBinaryStr(data) << " expected "
                     << hexStrFromBinaryStr(requiredChecksumStr) << std::endl;
-          _serialPort->send(
-              std::string("\xBA\xD0\xC5", 3) + data[8] + std::string("\x0A\x50\x20\xB0", 4) + requiredChecksumStr);
+          send(std::string("\xBA\xD0\xC5", 3) + data[8] + std::string("\x0A\x50\x20\xB0", 4) + requiredChecksumStr);
           // That is to say "BAD_CheckSum", what it is, "_hAS_TO_Be_", what it is required to be.
         }
       }
 
       else {
         // echo back the input
-        _serialPort->send(data);
+        send(data);
         if(_debug) {
           std::cout << "DummyServer: Catch-all for " << data << std::endl; // DEBUG
         }
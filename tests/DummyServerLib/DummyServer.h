@@ -10,6 +10,7 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <mutex>
 
 /**
  * A stand-in server class for the CommandBasedBackend to communicate with
@@ -64,6 +65,9 @@ class DummyServer {
   std::array<LockingString, 2> sai = {LockingString("AXIS_1"), LockingString("AXIS_2")};
   std::array<std::atomic<uint64_t>, 3> hex = {0xbabef00d, 0xFEEDC0DE, 0xBADdCAFE};
   std::atomic<uint64_t> voidCounter{0};
+  std::atomic<uint64_t> nCompoundCommands{0}; // Number of SCPI compound commands like "CMD1?;CMD2?" received
+  std::atomic<uint64_t> nAccQueries{0};       // Number of "ACC?" commands received
+  std::atomic<uint64_t> nLimitEvents{0};      // Number of unsolicited "EVT:LIMIT" lines sent, see sendLimitEvents
   std::string byteData{};
   float flt{};
   uint32_t ulog{};
@@ -73,6 +77,11 @@ class DummyServer {
   std::atomic_bool responseWithDataAndSyntaxError{false};
   std::atomic_bool sendGarbage{false};
   std::atomic_bool byteMode{false};
+  // Send an unsolicited line "EVT:LIMIT <n>" upon each command, before the response (if any), counting n up.
+  std::atomic_bool sendLimitEvents{false};
+  // Like sendLimitEvents, but the lines are sent continuously every millisecond, also between and within responses.
+  std::atomic_bool streamLimitEvents{false};
+  std::atomic<unsigned> responseDelay{0}; // Milliseconds to wait before handling each command
   size_t bytesToRead{16};
 
   // Pause execution here to wait for the main thread to stop (e.g. because ^C has been pressed).
@@ -89,13 +98,24 @@ class DummyServer {
 
   void sendDelimited(std::string s) {
     s.append(ChimeraTK::SERIAL_DEFAULT_DELIMITER);
-    _serialPort->send(s);
+    send(s);
   }
 
  protected:
   void mainLoop();
   std::unique_ptr<ChimeraTK::SerialPort> _serialPort;
 
+  // Sends the limit events while streamLimitEvents is set.
+  void streamLoop();
+  boost::thread _streamThread;
+
+  // Sends are not interleaved with those of the _streamThread.
+  void send(const std::string& s) {
+    std::lock_guard<std::mutex> lock(_sendMutex);
+    _serialPort->send(s);
+  }
+  std::mutex _sendMutex;
+
   void setAcc(const std::string& axis, const std::string& value);
   void setHex(size_t i, const std::string& value);
 
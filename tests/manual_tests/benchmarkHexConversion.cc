@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/*
+ * Throughput of the hex encode and decode kernels behind hexStrFromBinaryStr() and binaryStrFromHexStr(), for
+ * payloads like the binary block data of large registers.
+ */
+#include "stringUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+  const char* kernelName(HexKernel kernel) {
+    switch(kernel) {
+      case HexKernel::SCALAR:
+        return "scalar";
+      case HexKernel::SSE2:
+        return "SSE2";
+      case HexKernel::AVX2:
+        return "AVX2";
+    }
+    return "";
+  }
+
+  template<typename Function>
+  double megabytesPerSecond(size_t nBytes, size_t nRepetitions, Function function) {
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < nRepetitions; ++i) {
+      function();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(nBytes * nRepetitions) / seconds.count() / 1e6;
+  }
+} // namespace
+
+int main() {
+  const size_t nBytes = 1 << 16;
+  const size_t nRepetitions = 2000;
+
+  std::string bytes(nBytes, '\0');
+  for(size_t i = 0; i < nBytes; ++i) {
+    bytes[i] = static_cast<char>(i * 37 + 11);
+  }
+  std::string hex(2 * nBytes, ' ');
+  std::string decoded(nBytes, ' ');
+
+  std::cout << "Payload " << nBytes << " bytes, best kernel on this CPU: " << kernelName(getHexKernel()) << std::endl;
+  for(auto kernel : {HexKernel::SCALAR, HexKernel::SSE2, HexKernel::AVX2}) {
+    if(kernel > getHexKernel()) {
+      continue;
+    }
+    double encode = megabytesPerSecond(
+        nBytes, nRepetitions, [&] { encodeHex(bytes.data(), nBytes, hex.data(), kernel); });
+    double decode = megabytesPerSecond(
+        nBytes, nRepetitions, [&] { decodeHex(hex.data(), nBytes, decoded.data(), kernel); });
+    if(decoded != bytes) {
+      std::cout << kernelName(kernel) << ": round trip failed" << std::endl;
+      return 1;
+    }
+    std::cout << kernelName(kernel) << ": encode " << encode << " MB/s, decode " << decode << " MB/s" << std::endl;
+  }
+  return 0;
+}
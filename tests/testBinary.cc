@@ -8,6 +8,7 @@
 #include <boost/test/unit_test.hpp>
 using namespace boost::unit_test_framework;
 
+#include "CommandBasedBackend.h"
 #include "DummyServer.h"
 
 #include <ChimeraTK/Device.h>
@@ -136,4 +137,45 @@ BOOST_AUTO_TEST_CASE(testULog) {
 
 /**********************************************************************************************************************/
 
+BOOST_AUTO_TEST_CASE(testBlockData) {
+  auto trace = device.getOneDRegisterAccessor<float>("/trace");
+  trace.read();
+  BOOST_CHECK_EQUAL(trace[0], 0.5F);
+  BOOST_CHECK_EQUAL(trace[1], -1.25F);
+  BOOST_CHECK_EQUAL(trace[2], 3.F);
+  BOOST_CHECK_EQUAL(trace[3], 1024.F);
+
+  // Offsets and other user types take the same path.
+  auto traceTail = device.getOneDRegisterAccessor<int32_t>("/trace", 2, 2);
+  traceTail.read();
+  BOOST_CHECK_EQUAL(traceTail[0], 3);
+  BOOST_CHECK_EQUAL(traceTail[1], 1024);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSharedRegisterPlan) {
+  auto backend = boost::dynamic_pointer_cast<ChimeraTK::CommandBasedBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+
+  // Accessors of any user type share the plan of their register, whatever their size and offset.
+  auto planBefore = backend->getRegisterPlan("/uLog");
+  auto uLogAccessor = device.getScalarRegisterAccessor<uint32_t>("/uLog");
+  auto uLogStringAccessor = device.getScalarRegisterAccessor<std::string>("/uLog");
+  BOOST_CHECK(backend->getRegisterPlan("/uLog") == planBefore);
+  BOOST_CHECK(backend->getRegisterPlan("/floatTest") != planBefore);
+
+  BOOST_CHECK_THROW(backend->getRegisterPlan("/notARegister"), ChimeraTK::logic_error);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBlockDataWrongLength) {
+  // The header announces four elements, but the register has two. The payload is not read then.
+  auto traceHead = device.getOneDRegisterAccessor<float>("/traceHead");
+  BOOST_CHECK_THROW(traceHead.read(), ChimeraTK::runtime_error);
+}
+
+/**********************************************************************************************************************/
+
 BOOST_AUTO_TEST_SUITE_END()
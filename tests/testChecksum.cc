@@ -9,12 +9,15 @@
 using namespace boost::unit_test_framework;
 
 #include "Checksum.h"
+#include "Crc.h"
 #include "DummyServer.h"
 #include "stringUtils.h"
 
 #include <ChimeraTK/Device.h>
 #include <ChimeraTK/UnifiedBackendTest.h>
 
+#include <boost/crc.hpp>
+
 namespace ChimeraTK {
 
   /********************************************************************************************************************/
@@ -66,6 +69,86 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  BOOST_AUTO_TEST_CASE(testCrc32) {
+    std::string binInput = binaryStrFromHexStr("313233343536373839"); // "123456789", the CRC check input
+    BOOST_CHECK_EQUAL(getChecksumAlgorithm(checksum::CRC32)(binInput), "CBF43926");
+    BOOST_CHECK_EQUAL(getChecksumAlgorithm(checksum::CRC32C)(binInput), "E3069283");
+  }
+
+  /********************************************************************************************************************/
+
+  BOOST_AUTO_TEST_CASE(testCrcKernels) {
+    // Lengths around the 8 byte slices and the 16/64 byte blocks of the hardware kernels
+    std::string data;
+    for(size_t i = 0; i < 300; ++i) {
+      data.push_back(static_cast<char>(i * 73 + 5));
+    }
+    for(size_t n = 0; n <= data.size(); ++n) {
+      std::string_view bytes(data.data(), n);
+      boost::crc_optimal<16, 0x1021, 0xFFFF, 0x0000, false, false> crcCcitt;
+      crcCcitt.process_bytes(bytes.data(), n);
+      BOOST_CHECK_EQUAL(crcCcitt16(bytes), crcCcitt.checksum());
+
+      boost::crc_32_type crc;
+      crc.process_bytes(bytes.data(), n);
+      BOOST_CHECK_EQUAL(crc32(bytes, 0, CrcKernel::SLICING_BY_8), crc.checksum());
+      BOOST_CHECK_EQUAL(crc32(bytes, 0, CrcKernel::HARDWARE), crc.checksum());
+      BOOST_CHECK_EQUAL(crc32c(bytes, 0, CrcKernel::HARDWARE), crc32c(bytes, 0, CrcKernel::SLICING_BY_8));
+
+      // Continuing from the result of the first part
+      BOOST_CHECK_EQUAL(crc32(bytes.substr(n / 3), crc32(bytes.substr(0, n / 3))), crc.checksum());
+      BOOST_CHECK_EQUAL(crcCcitt16(bytes.substr(n / 3), crcCcitt16(bytes.substr(0, n / 3))), crcCcitt.checksum());
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  BOOST_AUTO_TEST_CASE(testChecksumers) {
+    // Binary interactions: hex payload, hex result. Text interactions: text payload, decimal result.
+    BOOST_CHECK_EQUAL(Checksumer(checksum::CRC_CCIT16, true)("313233343536373839"), "29B1");
+    BOOST_CHECK_EQUAL(Checksumer(checksum::CRC_CCIT16, false)("123456789"), "10673");
+    BOOST_CHECK_EQUAL(Checksumer(checksum::CS8, false)("123456789"), "221");
+
+    ChecksumBytes result;
+    BOOST_CHECK(computeChecksum(checksum::CRC32, "123456789", result) == std::string_view("\xCB\xF4\x39\x26", 4));
+  }
+
+  /********************************************************************************************************************/
+
+  BOOST_AUTO_TEST_CASE(testIncrementalChecksums) {
+    // A response with the payload of checksum 0 at [2, 40) and that of checksum 1 at [40, 100)
+    std::string response;
+    for(size_t i = 0; i < 120; ++i) {
+      response.push_back(static_cast<char>(i * 31 + 7));
+    }
+    std::vector<checksum> checksums{checksum::SHA256, checksum::CS8};
+    IncrementalChecksums incremental(checksums, {{2, 38}, {40, 60}});
+
+    for(size_t chunkSize : {1, 3, 7, 64, 120}) {
+      incremental.reset();
+      for(size_t pos = 0; pos < response.size(); pos += chunkSize) {
+        incremental.update(std::string_view(response).substr(pos, chunkSize));
+      }
+      BOOST_CHECK_EQUAL(incremental.getNBytesReceived(), response.size());
+
+      ChecksumBytes result;
+      ChecksumBytes expected;
+      BOOST_CHECK(incremental.finish(0, result) == computeChecksum(checksum::SHA256, response.substr(2, 38), expected));
+      BOOST_CHECK(incremental.finish(1, result) == computeChecksum(checksum::CS8, response.substr(40, 60), expected));
+    }
+
+    for(auto cs : {checksum::CS32, checksum::CRC_CCIT16, checksum::CRC32, checksum::CRC32C}) {
+      ChecksumState state(cs);
+      state.update(std::string_view(response).substr(0, 50));
+      state.update(std::string_view(response).substr(50));
+      ChecksumBytes result;
+      ChecksumBytes expected;
+      BOOST_CHECK(state.finish(result) == computeChecksum(cs, response, expected));
+    }
+  }
+
+  /********************************************************************************************************************/
+
   BOOST_AUTO_TEST_CASE(testChecksumValidation) {
     BOOST_CHECK_NO_THROW(validateChecksumPattern("", ""));
     BOOST_CHECK_NO_THROW(validateChecksumPattern("Pattern with no checksum tags", "error message detail"));
@@ -119,4 +202,5 @@ namespace ChimeraTK {
   }
 
   /********************************************************************************************************************/
+
 } // end namespace ChimeraTK
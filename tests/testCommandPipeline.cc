@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CommandPipelineTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "CommandPipeline.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+/**
+ * Emulates a device with an input queue, which answers the commands in the order they arrive.
+ * It is used from several threads, so it only records its observations. The test checks them in the main thread, as
+ * Boost.Test is not thread safe.
+ */
+struct QueueingDevice {
+  std::mutex mutex;
+  std::deque<int> wire;
+  size_t inFlight{0};
+  size_t maxInFlight{0};
+  size_t nReadsWithoutResponse{0};
+
+  void send(int command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    wire.push_back(command);
+    maxInFlight = std::max(maxInFlight, ++inFlight);
+  }
+
+  int read() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(wire.empty()) {
+      ++nReadsWithoutResponse;
+      return -1;
+    }
+    int response = wire.front();
+    wire.pop_front();
+    --inFlight;
+    return response;
+  }
+};
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testResponsesInOrder) {
+  constexpr size_t depth = 3;
+  constexpr int nThreads = 8;
+  constexpr int nTransfers = 200;
+
+  CommandPipeline pipeline(depth, std::chrono::milliseconds(1000));
+  BOOST_TEST(pipeline.getDepth() == depth);
+  QueueingDevice device;
+  std::atomic<int> nMismatches{0};
+  std::atomic<int> nBadDeadlines{0};
+
+  std::vector<std::thread> threads;
+  for(int t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for(int i = 0; i < nTransfers; ++i) {
+        int command = t * nTransfers + i;
+        int response = -1;
+        pipeline.transfer([&] { device.send(command); },
+            [&](std::chrono::milliseconds remaining) {
+              if(remaining > std::chrono::milliseconds(1000)) {
+                ++nBadDeadlines;
+              }
+              std::this_thread::yield();
+              response = device.read();
+            });
+        if(response != command) {
+          ++nMismatches;
+        }
+      }
+    });
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+
+  BOOST_TEST(nMismatches == 0);
+  BOOST_TEST(nBadDeadlines == 0);
+  BOOST_TEST(device.nReadsWithoutResponse == 0);
+  BOOST_TEST(device.wire.empty());
+  BOOST_TEST(device.maxInFlight <= depth);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadFailurePropagates) {
+  CommandPipeline pipeline(2, std::chrono::milliseconds(100));
+
+  BOOST_CHECK_THROW(pipeline.transfer([] {}, [](auto) { throw ChimeraTK::runtime_error("Read timed out"); }),
+      ChimeraTK::runtime_error);
+
+  // Later transfers are not sent, and name the first failure.
+  bool hasSent = false;
+  try {
+    pipeline.transfer([&] { hasSent = true; }, [](auto) {});
+    BOOST_FAIL("Transfer after a failure did not throw");
+  }
+  catch(const ChimeraTK::runtime_error& e) {
+    BOOST_TEST(std::string(e.what()).find("Read timed out") != std::string::npos);
+  }
+  BOOST_TEST(not hasSent);
+
+  pipeline.reset();
+  pipeline.transfer([&] { hasSent = true; }, [](auto) {});
+  BOOST_TEST(hasSent);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testFailureOfTransferInFlight) {
+  // The second transfer is sent before the first one fails, so its response can no longer be assigned.
+  CommandPipeline pipeline(2, std::chrono::milliseconds(100));
+  std::atomic<bool> secondHasSent{false};
+  std::atomic<bool> secondHasRead{false};
+  std::atomic<bool> firstHasThrown{false};
+  std::atomic<bool> secondHasThrown{false};
+
+  std::thread first([&] {
+    try {
+      pipeline.transfer([] {}, [&](auto) {
+        while(not secondHasSent) {
+          std::this_thread::yield();
+        }
+        throw ChimeraTK::runtime_error("Garbled response");
+      });
+    }
+    catch(const ChimeraTK::runtime_error&) {
+      firstHasThrown = true;
+    }
+  });
+  std::thread second([&] {
+    // Make sure the first transfer has its ticket before the second one.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    try {
+      pipeline.transfer([&] { secondHasSent = true; }, [&](auto) { secondHasRead = true; });
+    }
+    catch(const ChimeraTK::runtime_error&) {
+      secondHasThrown = true;
+    }
+  });
+  first.join();
+  second.join();
+
+  BOOST_TEST(firstHasThrown);
+  BOOST_TEST(secondHasThrown);
+  BOOST_TEST(secondHasSent);
+  BOOST_TEST(not secondHasRead);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSendFailure) {
+  CommandPipeline pipeline(2, std::chrono::milliseconds(100));
+  bool hasRead = false;
+  BOOST_CHECK_THROW(pipeline.transfer([] { throw ChimeraTK::runtime_error("Write failed"); },
+                        [&](auto) { hasRead = true; }),
+      ChimeraTK::runtime_error);
+  BOOST_TEST(not hasRead);
+  BOOST_CHECK_THROW(pipeline.transfer([] {}, [](auto) {}), ChimeraTK::runtime_error);
+}
+
+/**********************************************************************************************************************/
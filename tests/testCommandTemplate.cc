@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CommandTemplateTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "CommandBasedBackendRegisterInfo.h"
+#include "CommandTemplate.h"
+#include "stringUtils.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLiteralOnly) {
+  CommandTemplate t("SAI?", "testLiteralOnly");
+  BOOST_TEST(t.isCompiled());
+  BOOST_TEST(t.isDataIndependent());
+  BOOST_TEST(t.render() == "SAI?");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testData) {
+  CommandTemplate t("HEX 0x{{x.0}} 0x{{ x.1 }} {{x.2}}", "testData");
+  BOOST_TEST(t.isCompiled());
+  BOOST_TEST(not t.isDataIndependent());
+  BOOST_TEST(t.render({"AB", "CD", "12"}) == "HEX 0xAB 0xCD 12");
+
+  // renderInto appends
+  std::string output = "prefix ";
+  t.renderInto(output, {"1", "2", "3"}, {});
+  BOOST_TEST(output == "prefix HEX 0x1 0x2 3");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testChecksumTags) {
+  CommandTemplate t("{{csStart.0}}F501ADD5{{x.0}}{{csEnd.0}}{{cs.0}}", "testChecksumTags");
+  BOOST_TEST(t.isCompiled());
+  BOOST_TEST(t.render({"0042"}, {"9E"}) == "F501ADD500429E");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMissingValues) {
+  CommandTemplate t("ACC AXIS_1 {{x.0}} AXIS_2 {{x.1}}", "testMissingValues");
+  BOOST_CHECK_THROW(std::ignore = t.render({"1"}), ChimeraTK::runtime_error);
+
+  CommandTemplate c("ABC{{cs.1}}", "testMissingValues");
+  BOOST_CHECK_THROW(std::ignore = c.render({}, {"00"}), ChimeraTK::runtime_error);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInjaFallback) {
+  // Anything beyond the simple tags is left to inja.
+  BOOST_TEST(not CommandTemplate("{% for v in x %}{{v}} {% endfor %}", "testInjaFallback").isCompiled());
+  BOOST_TEST(not CommandTemplate("SET {{ x.0 | upper }}", "testInjaFallback").isCompiled());
+  BOOST_TEST(not CommandTemplate("SET {{y.0}}", "testInjaFallback").isCompiled());
+
+  CommandTemplate t("{% for v in x %}{{v}};{% endfor %}", "testInjaFallback");
+  BOOST_TEST(t.render({"1", "2"}) == "1;2;");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConstantCommandFolding) {
+  // Binary read command with a checksum: folded into the final wire bytes. The write command depends on data.
+  auto j = json::parse(R"({"read":{"cmd":"{{csStart.0}}F503ADD500000000{{csEnd.0}}{{cs.0}}",
+                                   "resp":"{{csStart.0}}F504ADD5{{x.0}}{{csEnd.0}}{{cs.0}}",
+                                   "cmdChecksum":["cs8"], "respChecksum":["cs8"]},
+                           "write":{"cmd":"{{csStart.0}}F501ADD5{{x.0}}{{csEnd.0}}{{cs.0}}",
+                                    "resp":"{{csStart.0}}F502ADD5.*{{csEnd.0}}{{cs.0}}",
+                                    "cmdChecksum":["cs8"], "respChecksum":["cs8"]},
+                           "nRespBytes":9, "bitWidth":32, "type":"binInt"})");
+  CommandBasedBackendRegisterInfo binaryInfo("/uLog", j, "\r\n");
+  BOOST_REQUIRE(binaryInfo.readInfo.constantCommand.has_value());
+  // 0xF5 + 0x03 + 0xAD + 0xD5 = 0x27A
+  BOOST_CHECK(*binaryInfo.readInfo.constantCommand == binaryStrFromHexStr("F503ADD5000000007A"));
+  BOOST_CHECK(not binaryInfo.writeInfo.constantCommand.has_value());
+
+  // Text read command without checksums
+  CommandBasedBackendRegisterInfo textInfo(
+      "/SAI", json::parse(R"({"read":{"cmd":"SAI?", "resp":"{{x.0}}"}, "type":"decInt"})"), "\r\n");
+  BOOST_REQUIRE(textInfo.readInfo.constantCommand.has_value());
+  BOOST_CHECK_EQUAL(*textInfo.readInfo.constantCommand, "SAI?");
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CompoundCommandTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+
+#include <ChimeraTK/Device.h>
+#include <ChimeraTK/TransferGroup.h>
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+static DummyServer dummyServer{true, DEBUG};
+
+static ChimeraTK::Device openDevice() {
+  ChimeraTK::Device device("(CommandBasedTTY:" + dummyServer.deviceNode + "?map=testCompoundCommand.json)");
+  device.open();
+  return device;
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMergedRead) {
+  auto device = openDevice();
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyRO");
+  auto acc1 = device.getScalarRegisterAccessor<double>("/ACC1");
+  auto acc2 = device.getScalarRegisterAccessor<double>("/ACC2");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(frequency);
+  group.addAccessor(acc1);
+  group.addAccessor(acc2);
+
+  dummyServer.cwFrequency = 1234;
+  dummyServer.acc[0] = 0.5F;
+  dummyServer.acc[1] = -2.25F;
+  uint64_t nCompoundCommandsBefore = dummyServer.nCompoundCommands;
+  group.read();
+
+  // All three registers are read with a single compound command.
+  BOOST_TEST(dummyServer.nCompoundCommands == nCompoundCommandsBefore + 1);
+  BOOST_TEST(uint64_t(frequency) == 1234);
+  BOOST_TEST(double(acc1) == 0.5);
+  BOOST_TEST(double(acc2) == -2.25);
+
+  // Reading a merged accessor on its own still works.
+  dummyServer.acc[1] = 4.F;
+  acc2.read();
+  BOOST_TEST(double(acc2) == 4.);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMaxCommands) {
+  // The map file allows at most 3 commands per compound command, so the fourth register is read separately.
+  auto device = openDevice();
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyRO");
+  auto idn = device.getScalarRegisterAccessor<std::string>("/IDN");
+  auto acc1 = device.getScalarRegisterAccessor<double>("/ACC1");
+  auto acc2 = device.getScalarRegisterAccessor<double>("/ACC2");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(frequency);
+  group.addAccessor(idn);
+  group.addAccessor(acc1);
+  group.addAccessor(acc2);
+
+  dummyServer.cwFrequency = 5678;
+  dummyServer.acc[0] = 1.5F;
+  dummyServer.acc[1] = 2.5F;
+  uint64_t nCompoundCommandsBefore = dummyServer.nCompoundCommands;
+  group.read();
+
+  BOOST_TEST(dummyServer.nCompoundCommands == nCompoundCommandsBefore + 1);
+  BOOST_TEST(uint64_t(frequency) == 5678);
+  BOOST_TEST(std::string(idn) == "Dummy server for command based serial backend.");
+  BOOST_TEST(double(acc1) == 1.5);
+  BOOST_TEST(double(acc2) == 2.5);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testWriteableNotMerged) {
+  // Writeable registers are transferred on their own, the read-only ones are still merged.
+  auto device = openDevice();
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  auto acc1 = device.getScalarRegisterAccessor<double>("/ACC1");
+  auto acc2 = device.getScalarRegisterAccessor<double>("/ACC2");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(frequency);
+  group.addAccessor(acc1);
+  group.addAccessor(acc2);
+
+  dummyServer.cwFrequency = 42;
+  dummyServer.acc[0] = 3.5F;
+  dummyServer.acc[1] = -1.5F;
+  uint64_t nCompoundCommandsBefore = dummyServer.nCompoundCommands;
+  group.read();
+
+  BOOST_TEST(dummyServer.nCompoundCommands == nCompoundCommandsBefore + 1);
+  BOOST_TEST(uint64_t(frequency) == 42);
+  BOOST_TEST(double(acc1) == 3.5);
+  BOOST_TEST(double(acc2) == -1.5);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSeparatorInResponse) {
+  // Responses which may contain the separator only go into the last slot, which takes the rest of the line. So they are
+  // put last, and not merged with each other.
+  auto device = openDevice();
+  auto twice = device.getOneDRegisterAccessor<uint64_t>("/cwFrequencyTwice");
+  auto idn = device.getScalarRegisterAccessor<std::string>("/IDN");
+  auto acc1 = device.getScalarRegisterAccessor<double>("/ACC1");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(twice);
+  group.addAccessor(idn);
+  group.addAccessor(acc1);
+
+  dummyServer.cwFrequency = 4711;
+  dummyServer.acc[0] = 0.25F;
+  group.read();
+
+  BOOST_TEST(twice[0] == 4711);
+  BOOST_TEST(twice[1] == 4711);
+  BOOST_TEST(std::string(idn) == "Dummy server for command based serial backend.");
+  BOOST_TEST(double(acc1) == 0.25);
+}
+
+/**********************************************************************************************************************/
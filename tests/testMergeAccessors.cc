@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MergeAccessorsTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+
+#include <ChimeraTK/Device.h>
+#include <ChimeraTK/TransferGroup.h>
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+static DummyServer dummyServer{true, DEBUG};
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSameRegisterDifferentRanges) {
+  ChimeraTK::Device device("(CommandBasedTTY:" + dummyServer.deviceNode + "?map=test.json)");
+  device.open();
+
+  // Different element ranges and user types of the same read-only register
+  auto axis1 = device.getOneDRegisterAccessor<double>("/ACCRO", 1, 0);
+  auto axis2 = device.getOneDRegisterAccessor<float>("/ACCRO", 1, 1);
+  auto both = device.getOneDRegisterAccessor<double>("/ACCRO");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(axis1);
+  group.addAccessor(axis2);
+  group.addAccessor(both);
+
+  dummyServer.acc[0] = 0.75F;
+  dummyServer.acc[1] = -3.5F;
+  uint64_t nAccQueriesBefore = dummyServer.nAccQueries;
+  group.read();
+
+  // The register is transferred once for all three accessors.
+  BOOST_TEST(dummyServer.nAccQueries == nAccQueriesBefore + 1);
+  BOOST_TEST(axis1[0] == 0.75);
+  BOOST_TEST(axis2[0] == -3.5F);
+  BOOST_TEST(both[0] == 0.75);
+  BOOST_TEST(both[1] == -3.5);
+
+  // The accessors can still be read on their own.
+  dummyServer.acc[1] = 1.25F;
+  axis2.read();
+  BOOST_TEST(axis2[0] == 1.25F);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testIdenticalAccessors) {
+  ChimeraTK::Device device("(CommandBasedTTY:" + dummyServer.deviceNode + "?map=test.json)");
+  device.open();
+
+  // Identical accessors to a writeable register replace each other in the TransferGroup.
+  auto first = device.getOneDRegisterAccessor<double>("/ACC");
+  auto second = device.getOneDRegisterAccessor<double>("/ACC");
+
+  ChimeraTK::TransferGroup group;
+  group.addAccessor(first);
+  group.addAccessor(second);
+
+  dummyServer.acc[0] = 2.5F;
+  dummyServer.acc[1] = -0.5F;
+  uint64_t nAccQueriesBefore = dummyServer.nAccQueries;
+  group.read();
+
+  BOOST_TEST(dummyServer.nAccQueries == nAccQueriesBefore + 1);
+  BOOST_TEST(first[0] == 2.5);
+  BOOST_TEST(first[1] == -0.5);
+  BOOST_TEST(second[0] == 2.5);
+  BOOST_TEST(second[1] == -0.5);
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PipelinedBackendTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "CommandBasedBackend.h"
+#include "DummyServer.h"
+#include "SerialCommandHandler.h"
+
+#include <ChimeraTK/Device.h>
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ChimeraTK::AccessMode;
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+static DummyServer dummyServer{true, DEBUG};
+
+static const std::string idn = "Dummy server for command based serial backend.";
+
+static std::string getCdd(const std::string& mapFile = "testPipelinedBackend.json") {
+  return "(CommandBasedTTY:" + dummyServer.deviceNode + "?map=" + mapFile + ")";
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPipelineDepth) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto backend = boost::dynamic_pointer_cast<ChimeraTK::CommandBasedBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+  BOOST_TEST(backend->readDeviceInfo().find("pipelineDepth: 3") != std::string::npos);
+  device.close();
+
+  // The same map with a depth below 1 is rejected.
+  nlohmann::json j;
+  std::ifstream("testPipelinedBackend.json") >> j;
+  j["metadata"]["pipelineDepth"] = 0;
+  std::ofstream("testPipelinedBackendInvalidDepth.json") << j;
+  BOOST_CHECK_THROW(ChimeraTK::Device(getCdd("testPipelinedBackendInvalidDepth.json")).open(), ChimeraTK::logic_error);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConcurrentAccessors) {
+  constexpr int nTransfers = 100;
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto backend = boost::dynamic_pointer_cast<ChimeraTK::CommandBasedBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+
+  dummyServer.cwFrequency = 4321;
+  dummyServer.acc[0] = 0.5F;
+  dummyServer.acc[1] = -2.25F;
+
+  // Each response must reach the accessor whose command it answers, while the commands of the other threads are in
+  // flight. The threads only count, as Boost.Test is not thread safe.
+  std::atomic<int> nMismatches{0};
+  std::atomic<int> nExceptions{0};
+  auto repeat = [&](auto transferAndCheck) {
+    return std::thread([&, transferAndCheck] {
+      for(int i = 0; i < nTransfers; ++i) {
+        try {
+          if(not transferAndCheck()) {
+            ++nMismatches;
+          }
+        }
+        catch(const ChimeraTK::runtime_error&) {
+          ++nExceptions;
+        }
+      }
+    });
+  };
+
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  auto acc = device.getOneDRegisterAccessor<double>("/ACC");
+  auto identification = device.getScalarRegisterAccessor<std::string>("/IDN");
+
+  std::vector<std::thread> threads;
+  threads.push_back(repeat([&] {
+    frequency.read();
+    return uint64_t(frequency) == 4321;
+  }));
+  threads.push_back(repeat([&] {
+    acc.read();
+    return acc[0] == 0.5 and acc[1] == -2.25;
+  }));
+  threads.push_back(repeat([&] {
+    identification.read();
+    return std::string(identification) == idn;
+  }));
+  // Raw commands share the pipeline with the accessors.
+  threads.push_back(repeat([&] { return backend->sendCommandAndReadLines("*IDN?") == std::vector<std::string>{idn}; }));
+  for(auto& thread : threads) {
+    thread.join();
+  }
+
+  BOOST_TEST(nMismatches == 0);
+  BOOST_TEST(nExceptions == 0);
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSendConcurrentWithRead) {
+  // The pipeline relies on the CommandHandler sending in one thread while another one reads.
+  constexpr int nCommands = 100;
+  ChimeraTK::SerialCommandHandler handler(dummyServer.deviceNode);
+
+  std::atomic<int> nSendExceptions{0};
+  std::thread sender([&] {
+    for(int i = 0; i < nCommands; ++i) {
+      try {
+        handler.sendCommand("*IDN?");
+      }
+      catch(const ChimeraTK::runtime_error&) {
+        ++nSendExceptions;
+      }
+    }
+  });
+
+  int nMismatches = 0;
+  int nReadExceptions = 0;
+  std::vector<std::string> lines;
+  for(int i = 0; i < nCommands; ++i) {
+    try {
+      handler.readLinesInto(1, ChimeraTK::CommandHandlerDefaultDelimiter{}, lines, std::chrono::milliseconds(1000));
+      if(lines.at(0) != idn) {
+        ++nMismatches;
+      }
+    }
+    catch(const ChimeraTK::runtime_error&) {
+      ++nReadExceptions;
+    }
+  }
+  sender.join();
+
+  BOOST_TEST(nSendExceptions == 0);
+  BOOST_TEST(nReadExceptions == 0);
+  BOOST_TEST(nMismatches == 0);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testRecoveryDuringPoll) {
+  // With pipelining, a synchronous transfer can fail while a poll still waits for its response. The recovery must not
+  // replace the command handler and the pipeline under the running poll.
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto polled = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyPolled", 0, {AccessMode::wait_for_new_data});
+  auto mismatch = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyMismatch");
+  dummyServer.cwFrequency = 1234;
+  dummyServer.responseDelay = 300;
+
+  // The initial poll is sent while the mismatching read waits for its response, so it is answered 300 ms after the
+  // mismatching read has failed.
+  std::thread activator([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    device.activateAsyncRead();
+  });
+  BOOST_CHECK_THROW(mismatch.read(), ChimeraTK::runtime_error);
+  activator.join();
+  BOOST_CHECK_THROW(polled.read(), ChimeraTK::runtime_error);
+
+  // Waits for the poll in flight before replacing the command handler.
+  device.open();
+  dummyServer.responseDelay = 0;
+  device.activateAsyncRead();
+  polled.read();
+  BOOST_TEST(uint64_t(polled) == 1234);
+  BOOST_TEST(not polled.readNonBlocking());
+  device.close();
+}
+
+/**********************************************************************************************************************/
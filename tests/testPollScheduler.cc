@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PollSchedulerTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "PollScheduler.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace ChimeraTK;
+using namespace std::chrono_literals;
+
+/**********************************************************************************************************************/
+
+/**
+ * Counts the calls from the scheduler. Polls fail while shallFail is set.
+ */
+struct CountingSubscription : public PollScheduler::Subscription {
+  std::atomic<int> nPolls{0};
+  std::atomic<int> nPushes{0};
+  std::atomic<int> nExceptions{0};
+  std::atomic<bool> shallFail{false};
+
+  void poll() override {
+    ++nPolls;
+    if(shallFail) {
+      throw ChimeraTK::runtime_error("poll failed");
+    }
+  }
+  void push() override { ++nPushes; }
+  void sendException(const std::exception_ptr&) noexcept override { ++nExceptions; }
+};
+
+/**********************************************************************************************************************/
+
+template<typename Condition>
+static bool waitFor(Condition condition) {
+  for(int i = 0; i < 500; ++i) {
+    if(condition()) {
+      return true;
+    }
+    std::this_thread::sleep_for(2ms);
+  }
+  return false;
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPollsOnlyWhileActive) {
+  PollScheduler scheduler;
+  auto subscription = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(subscription, 5ms);
+
+  std::this_thread::sleep_for(30ms);
+  BOOST_TEST(subscription->nPolls == 0);
+
+  scheduler.activate();
+  BOOST_TEST(scheduler.isActive());
+  BOOST_TEST(waitFor([&] { return subscription->nPushes >= 3; }));
+
+  scheduler.deactivate();
+  int nPushes = subscription->nPushes;
+  std::this_thread::sleep_for(30ms);
+  BOOST_TEST(subscription->nPushes == nPushes);
+  BOOST_TEST(subscription->nExceptions == 0);
+
+  scheduler.unsubscribe(subscription.get());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testIntervals) {
+  PollScheduler scheduler;
+  auto fast = std::make_shared<CountingSubscription>();
+  auto slow = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(fast, 5ms);
+  scheduler.subscribe(slow, 1000ms);
+  scheduler.activate();
+
+  BOOST_TEST(waitFor([&] { return fast->nPushes >= 10; }));
+  // Only the initial value of the slow subscription
+  BOOST_TEST(slow->nPushes == 1);
+
+  scheduler.unsubscribe(fast.get());
+  scheduler.unsubscribe(slow.get());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testException) {
+  PollScheduler scheduler;
+  auto first = std::make_shared<CountingSubscription>();
+  auto second = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(first, 5ms);
+  scheduler.subscribe(second, 5ms);
+
+  // No exceptions are sent while inactive.
+  scheduler.sendException(std::make_exception_ptr(ChimeraTK::runtime_error("test")));
+  BOOST_TEST(first->nExceptions == 0);
+
+  scheduler.activate();
+  BOOST_TEST(waitFor([&] { return first->nPushes >= 1 and second->nPushes >= 1; }));
+
+  // Each subscription gets the exception once, then polling stops until the next activation.
+  scheduler.sendException(std::make_exception_ptr(ChimeraTK::runtime_error("test")));
+  scheduler.sendException(std::make_exception_ptr(ChimeraTK::runtime_error("test")));
+  BOOST_TEST(not scheduler.isActive());
+  BOOST_TEST(first->nExceptions == 1);
+  BOOST_TEST(second->nExceptions == 1);
+  scheduler.deactivate(); // wait for a running poll
+  int nPolls = first->nPolls;
+  std::this_thread::sleep_for(30ms);
+  BOOST_TEST(first->nPolls == nPolls);
+
+  // A failing poll is not pushed.
+  first->shallFail = true;
+  int nPushes = first->nPushes;
+  scheduler.activate();
+  BOOST_TEST(waitFor([&] { return first->nPolls >= nPolls + 3; }));
+  BOOST_TEST(first->nPushes == nPushes);
+  BOOST_TEST(waitFor([&] { return second->nPushes >= 3; }));
+
+  scheduler.unsubscribe(first.get());
+  scheduler.unsubscribe(second.get());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testUnsubscribe) {
+  PollScheduler scheduler;
+  auto subscription = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(subscription, 1ms);
+  scheduler.activate();
+  BOOST_TEST(waitFor([&] { return subscription->nPushes >= 1; }));
+
+  scheduler.unsubscribe(subscription.get());
+  int nPolls = subscription->nPolls;
+  std::this_thread::sleep_for(20ms);
+  BOOST_TEST(subscription->nPolls == nPolls);
+  // The scheduler has released the subscription.
+  BOOST_TEST(subscription.use_count() == 1);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInitialPollOnly) {
+  PollScheduler scheduler;
+  auto subscription = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(subscription, std::nullopt);
+
+  // Without interval, there is one poll upon each activation.
+  scheduler.activate();
+  BOOST_TEST(waitFor([&] { return subscription->nPushes == 1; }));
+  std::this_thread::sleep_for(30ms);
+  BOOST_TEST(subscription->nPolls == 1);
+
+  scheduler.deactivate();
+  scheduler.activate();
+  BOOST_TEST(waitFor([&] { return subscription->nPushes == 2; }));
+  std::this_thread::sleep_for(30ms);
+  BOOST_TEST(subscription->nPolls == 2);
+
+  // It does not hold up subscriptions with interval.
+  auto polled = std::make_shared<CountingSubscription>();
+  scheduler.subscribe(polled, 5ms);
+  BOOST_TEST(waitFor([&] { return polled->nPushes >= 3; }));
+  BOOST_TEST(subscription->nPolls == 2);
+
+  scheduler.unsubscribe(polled.get());
+  scheduler.unsubscribe(subscription.get());
+}
+
+/**********************************************************************************************************************/
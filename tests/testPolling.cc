@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PollingTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+
+#include <ChimeraTK/Device.h>
+
+using ChimeraTK::AccessMode;
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+static DummyServer dummyServer{true, DEBUG};
+
+static std::string getCdd(const std::string& parameters = "") {
+  return "(CommandBasedTTY:" + dummyServer.deviceNode + "?map=test.json" + parameters + ")";
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testCatalogue) {
+  ChimeraTK::Device withoutPolling(getCdd());
+  auto catalogue = withoutPolling.getRegisterCatalogue();
+  BOOST_TEST(not catalogue.getRegister("/cwFrequencyRO").getSupportedAccessModes().has(AccessMode::wait_for_new_data));
+  BOOST_CHECK_THROW(
+      withoutPolling.getScalarRegisterAccessor<uint64_t>("/cwFrequencyRO", 0, {AccessMode::wait_for_new_data}),
+      ChimeraTK::logic_error);
+
+  // The CDD parameter applies to all readable registers.
+  ChimeraTK::Device withPolling(getCdd("&pollInterval=20"));
+  catalogue = withPolling.getRegisterCatalogue();
+  BOOST_TEST(catalogue.getRegister("/cwFrequencyRO").getSupportedAccessModes().has(AccessMode::wait_for_new_data));
+  BOOST_TEST(catalogue.getRegister("/ACC").getSupportedAccessModes().has(AccessMode::wait_for_new_data));
+
+  BOOST_CHECK_THROW(ChimeraTK::Device(getCdd("&pollInterval=0")).open(), ChimeraTK::logic_error);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPushedValues) {
+  ChimeraTK::Device device(getCdd("&pollInterval=20"));
+  device.open();
+  dummyServer.cwFrequency = 100;
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyRO", 0, {AccessMode::wait_for_new_data});
+
+  // Nothing is pushed before the asynchronous read is activated.
+  BOOST_TEST(not frequency.readNonBlocking());
+
+  device.activateAsyncRead();
+  frequency.read(); // initial value
+  BOOST_TEST(uint64_t(frequency) == 100);
+
+  dummyServer.cwFrequency = 200;
+  for(int i = 0; i < 50 and uint64_t(frequency) != 200; ++i) {
+    frequency.read();
+  }
+  BOOST_TEST(uint64_t(frequency) == 200);
+
+  // Writeable registers can be written through the accessor.
+  auto acc = device.getOneDRegisterAccessor<double>("/ACC", 0, 0, {AccessMode::wait_for_new_data});
+  acc.read();
+  acc[0] = 1.5;
+  acc[1] = -2.5;
+  acc.write();
+  BOOST_TEST(dummyServer.acc[0] == 1.5F);
+  BOOST_TEST(dummyServer.acc[1] == -2.5F);
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testException) {
+  ChimeraTK::Device device(getCdd("&pollInterval=20"));
+  device.open();
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequencyRO", 0, {AccessMode::wait_for_new_data});
+  device.activateAsyncRead();
+  frequency.read(); // initial value
+
+  // A failing poll is pushed as exception.
+  dummyServer.sendNothing = true;
+  BOOST_CHECK_THROW(
+      {
+        for(int i = 0; i < 100; ++i) {
+          frequency.read();
+        }
+      },
+      ChimeraTK::runtime_error);
+  BOOST_TEST(not device.isFunctional());
+
+  // After recovery, the current value is pushed again.
+  dummyServer.sendNothing = false;
+  dummyServer.cwFrequency = 300;
+  device.open();
+  device.activateAsyncRead();
+  frequency.read();
+  BOOST_TEST(uint64_t(frequency) == 300);
+  device.close();
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ReceiveBufferTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "ReceiveBuffer.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+// Emulates a read() of str into the buffer.
+static void receive(ReceiveBuffer& buffer, const std::string& str) {
+  auto space = buffer.prepare(str.size());
+  BOOST_REQUIRE(space.size() >= str.size());
+  std::copy(str.begin(), str.end(), space.begin());
+  buffer.commit(str.size());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLines) {
+  ReceiveBuffer buffer;
+  receive(buffer, "first\r\nsecond\r\nthi");
+
+  auto pos = buffer.findDelimiter("\r\n");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(buffer.consume(*pos) == "first");
+  buffer.discard(2);
+
+  pos = buffer.findDelimiter("\r\n");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(buffer.consume(*pos) == "second");
+  buffer.discard(2);
+
+  BOOST_TEST(not buffer.findDelimiter("\r\n").has_value());
+  BOOST_TEST(buffer.view() == "thi");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testNullBytes) {
+  ReceiveBuffer buffer;
+  std::string data("a\0b\0\r\n", 6);
+  receive(buffer, data);
+
+  auto pos = buffer.findDelimiter("\r\n");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(buffer.consume(*pos) == std::string("a\0b\0", 4));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDelimiterStraddlesReads) {
+  ReceiveBuffer buffer;
+  receive(buffer, "abc\r");
+  BOOST_TEST(not buffer.findDelimiter("\r\n").has_value());
+  receive(buffer, "\ndef");
+
+  auto pos = buffer.findDelimiter("\r\n");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(*pos == 3);
+  BOOST_TEST(buffer.consume(*pos) == "abc");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testChangedDelimiter) {
+  // Data which has already been searched for one delimiter must be searched again for another one.
+  ReceiveBuffer buffer;
+  receive(buffer, "ab;cd");
+  BOOST_TEST(not buffer.findDelimiter("\r\n").has_value());
+
+  auto pos = buffer.findDelimiter(";");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(*pos == 2);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testGrowAndCompact) {
+  // Lines longer than the capacity must grow the buffer, consumed space must be reused.
+  ReceiveBuffer buffer(16);
+  std::string longLine(1000, 'x');
+  for(size_t i = 0; i < longLine.size(); i += 10) {
+    receive(buffer, longLine.substr(i, 10));
+    BOOST_TEST(not buffer.findDelimiter("\n").has_value());
+  }
+  receive(buffer, "\nrest");
+
+  auto pos = buffer.findDelimiter("\n");
+  BOOST_REQUIRE(pos.has_value());
+  BOOST_TEST(buffer.consume(*pos) == longLine);
+  buffer.discard(1);
+  BOOST_TEST(buffer.view() == "rest");
+
+  for(int i = 0; i < 100; ++i) {
+    receive(buffer, "0123456789\n");
+    pos = buffer.findDelimiter("\n");
+    BOOST_REQUIRE(pos.has_value());
+    BOOST_TEST(buffer.consume(*pos) == (i == 0 ? "rest0123456789" : "0123456789"));
+    buffer.discard(1);
+  }
+  BOOST_TEST(buffer.empty());
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ResponseMatcherTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "ResponseMatcher.h"
+
+#include <string>
+#include <vector>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDecimalLines) {
+  ResponseMatcher matcher("AXIS_1={{x.0}}\r\nAXIS_2={{x.1}}\r\n", TransportLayerType::DEC_INT, std::nullopt, {}, 2);
+  BOOST_REQUIRE(matcher.isCompiled());
+
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(matcher.match("AXIS_1=-12\r\nAXIS_2=345\r\n", result));
+  BOOST_REQUIRE_EQUAL(result.data.size(), 2);
+  BOOST_TEST(result.data[0] == "-12");
+  BOOST_TEST(result.data[1] == "345");
+
+  BOOST_TEST(not matcher.match("AXIS_1=12\r\nAXIS_2=3x\r\n", result));
+  BOOST_TEST(not matcher.match("AXIS_1=\r\nAXIS_2=3\r\n", result));
+  BOOST_TEST(not matcher.match("AXIS_1=1\r\nAXIS_2=3\r\ntrailing", result));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testOrderOfAppearance) {
+  // Like regex capture groups, values are returned in the order of appearance.
+  ResponseMatcher matcher("{{x.1}};{{x.0}}", TransportLayerType::HEX_INT, std::nullopt, {}, 2);
+  BOOST_REQUIRE(matcher.isCompiled());
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(matcher.match("AB;cd", result));
+  BOOST_TEST(result.data[0] == "AB");
+  BOOST_TEST(result.data[1] == "cd");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testFloatsAndStrings) {
+  ResponseMatcher floats("{{x.0}} {{x.1}}\n", TransportLayerType::DEC_FLOAT, std::nullopt, {}, 2);
+  BOOST_REQUIRE(floats.isCompiled());
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(floats.match("+1.5 42.\n", result));
+  BOOST_TEST(result.data[0] == "+1.5");
+  BOOST_TEST(result.data[1] == "42.");
+  BOOST_TEST(not floats.match(".5 1\n", result));
+
+  ResponseMatcher strings("{{x.0}}\r\n", TransportLayerType::STRING, std::nullopt, {}, 1);
+  BOOST_REQUIRE(strings.isCompiled());
+  BOOST_REQUIRE(strings.match("\r\n", result));
+  BOOST_TEST(result.data[0].empty());
+  BOOST_REQUIRE(strings.match("a b;c\r\n", result));
+  BOOST_TEST(result.data[0] == "a b;c");
+  BOOST_TEST(not strings.match("a\nb\r\n", result)); // '.' does not match line terminators
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testFixedWidth) {
+  // Fixed width fields may be followed by anything, even by another field.
+  ResponseMatcher matcher("B{{x.0}}{{x.1}}0D0A", TransportLayerType::BIN_INT, 2, {}, 2);
+  BOOST_REQUIRE(matcher.isCompiled());
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(matcher.match("B12AB0D0A", result));
+  BOOST_TEST(result.data[0] == "12");
+  BOOST_TEST(result.data[1] == "AB");
+  BOOST_TEST(not matcher.match("B12A0D0A", result));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testChecksums) {
+  ResponseMatcher matcher("{{csStart.0}}F504ADD5{{x.0}}{{csEnd.0}}{{cs.0}}", TransportLayerType::BIN_INT, 8,
+      {checksum::CS8}, 1);
+  BOOST_REQUIRE(matcher.isCompiled());
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(matcher.match("F504ADD5000000427C", result));
+  BOOST_TEST(result.data[0] == "00000042");
+  BOOST_REQUIRE_EQUAL(result.checksumPayloads.size(), 1);
+  BOOST_TEST(result.checksumPayloads[0] == "F504ADD500000042");
+  BOOST_REQUIRE_EQUAL(result.checksums.size(), 1);
+  BOOST_TEST(result.checksums[0] == "7C");
+  BOOST_TEST(not matcher.match("F504ADD5000000427", result));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testRegexFallback) {
+  // Regex syntax in the pattern
+  ResponseMatcher regexSyntax(
+      "{{csStart.0}}F502ADD5.*{{csEnd.0}}{{cs.0}}", TransportLayerType::BIN_INT, 8, {checksum::CS8}, 1);
+  BOOST_TEST(not regexSyntax.isCompiled());
+  // inja statements
+  ResponseMatcher injaStatements(
+      "{% for val in x %}{{val}}{% endfor %}", TransportLayerType::DEC_INT, std::nullopt, {}, 3);
+  BOOST_TEST(not injaStatements.isCompiled());
+  // A variable width field followed by something it could also match
+  BOOST_TEST(not ResponseMatcher("{{x.0}}1", TransportLayerType::DEC_INT, std::nullopt, {}, 1).isCompiled());
+  BOOST_TEST(not ResponseMatcher("{{x.0}}{{x.1}}", TransportLayerType::HEX_INT, std::nullopt, {}, 2).isCompiled());
+  // More values than elements
+  BOOST_TEST(not ResponseMatcher("{{x.0}} {{x.1}}", TransportLayerType::DEC_INT, std::nullopt, {}, 1).isCompiled());
+
+  ResponseMatcher matcher("{{x.0}}1", TransportLayerType::DEC_INT, std::nullopt, {}, 1);
+  matcher.setFallbackRegexes(std::regex("([+-]?[0-9]+)1"), std::regex("(?:[+-]?[0-9]+)1"),
+      std::regex("(?:[+-]?[0-9]+)1"));
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(matcher.match("1231", result));
+  BOOST_REQUIRE_EQUAL(result.data.size(), 1);
+  BOOST_TEST(result.data[0] == "123");
+  BOOST_TEST(result.checksums.empty());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBinaryLayout) {
+  ResponseMatcher matcher("{{csStart.0}}F504ADD5{{x.0}}{{csEnd.0}}{{cs.0}}", TransportLayerType::BIN_INT, 8,
+      {checksum::CS8}, 1);
+  auto layout = matcher.getBinaryLayout();
+  BOOST_REQUIRE(layout);
+  BOOST_TEST(layout->nBytes == 9);
+
+  ResponseMatcher::Result result;
+  std::string response("\xF5\x04\xAD\xD5\x00\x00\x00\x42\x7C", 9);
+  BOOST_REQUIRE(layout->match(response, result));
+  BOOST_TEST(result.data[0] == std::string_view(response).substr(4, 4));
+  BOOST_TEST(result.checksumPayloads[0] == std::string_view(response).substr(0, 8));
+  BOOST_TEST(result.checksums[0] == std::string_view(response).substr(8, 1));
+
+  BOOST_TEST(not layout->match(response.substr(0, 8), result));
+  response[1] = '\x05';
+  BOOST_TEST(not layout->match(response, result));
+
+  // Fields not on byte boundaries, lower case literals and variable widths have no fixed byte layout.
+  BOOST_TEST(not ResponseMatcher("AB{{x.0}}", TransportLayerType::BIN_INT, 3, {}, 1).getBinaryLayout());
+  BOOST_TEST(not ResponseMatcher("ab{{x.0}}", TransportLayerType::BIN_INT, 2, {}, 1).getBinaryLayout());
+  BOOST_TEST(not ResponseMatcher("AB{{x.0}}", TransportLayerType::BIN_INT, std::nullopt, {}, 1).getBinaryLayout());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDelimitedList) {
+  // A for loop over x, as used for SCPI traces, compiles to a list with its statements rendered.
+  ResponseMatcher trace("{% for val in x %}{{val}}{% if not loop.is_last %},{% endif %}{% endfor %}\r\n",
+      TransportLayerType::DEC_FLOAT, std::nullopt, {}, 4);
+  BOOST_REQUIRE(trace.isCompiled());
+  BOOST_TEST(trace.isDelimitedList());
+
+  ResponseMatcher::Result result;
+  BOOST_REQUIRE(trace.match("1.5,-2,+3.25,4.\r\n", result));
+  BOOST_REQUIRE_EQUAL(result.data.size(), 4);
+  BOOST_TEST(result.data[0] == "1.5");
+  BOOST_TEST(result.data[1] == "-2");
+  BOOST_TEST(result.data[2] == "+3.25");
+  BOOST_TEST(result.data[3] == "4.");
+  BOOST_TEST(not trace.match("1.5,-2,3\r\n", result));
+  BOOST_TEST(not trace.match("1,2,3,4,5\r\n", result));
+  BOOST_TEST(not trace.match("1,,3,4\r\n", result));
+  BOOST_TEST(not trace.match("1,2,3,4x\r\n", result));
+  BOOST_TEST(not trace.match("1,2,3,4", result));
+
+  ResponseMatcher hex("DATA:{{x.0}};{{x.1}};{{x.2}}", TransportLayerType::HEX_INT, std::nullopt, {}, 3);
+  BOOST_TEST(hex.isDelimitedList());
+  BOOST_REQUIRE(hex.match("DATA:1f;AB;0", result));
+  BOOST_TEST(result.data[0] == "1f");
+  BOOST_TEST(result.data[2] == "0");
+  BOOST_TEST(not hex.match("DATA:1f;AB;0;", result));
+
+  // Different separators, strings and fixed widths are matched element by element.
+  BOOST_TEST(not ResponseMatcher("{{x.0}},{{x.1}};{{x.2}}", TransportLayerType::DEC_INT, std::nullopt, {}, 3)
+                     .isDelimitedList());
+  BOOST_TEST(not ResponseMatcher("{{x.0}}\r\n{{x.1}}\r\n", TransportLayerType::STRING, std::nullopt, {}, 2)
+                     .isDelimitedList());
+  BOOST_TEST(not ResponseMatcher("{{x.0}},{{x.1}}", TransportLayerType::HEX_INT, 2, {}, 2).isDelimitedList());
+}
+
+/**********************************************************************************************************************/
@@ -144,7 +144,9 @@ BOOST_AUTO_TEST_CASE(testBinary) {
   if(DEBUG) {
     std::cout << "testSerial: send cmd" << std::endl;
   }
-  std::string echo = s.sendCommandAndReadBytes(packet, bytesToRead);
+  std::string observed;
+  std::string echo = s.sendCommandAndReadBytes(
+      packet, bytesToRead, "", [&](std::string_view bytes) { observed.append(bytes); });
 
   // Send bytes with a special command (so NoDelimter on write) to switch back to line mode.
   // The reply comes back line delimited.
@@ -158,6 +160,7 @@ BOOST_AUTO_TEST_CASE(testBinary) {
 
   BOOST_TEST(status1 == "ok");
   BOOST_TEST(echo == packet);
+  BOOST_TEST(observed == echo); // The observer sees each byte of the response once
   BOOST_TEST(status2 == "OK");
 
   // If we don't get OK back then we're stuck in byte mode, and the rest of the test will fail.
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE SerialPortSettingsTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+
+#include <ChimeraTK/Device.h>
+#include <ChimeraTK/Exception.h>
+
+#include <string>
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+/**********************************************************************************************************************/
+
+static DummyServer dummyServer{true, DEBUG};
+
+static std::string cdd(const std::string& serialParameters) {
+  return "(CommandBasedTTY:" + dummyServer.deviceNode + "?map=test.json" + serialParameters + ")";
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testValidSettings) {
+  // The pseudo terminal of the dummy accepts any line settings, including non-standard baud rates.
+  for(const std::string& parameters :
+      {"&baud=115200", "&baud=921600&parity=even&stopBits=2", "&baud=250000&dataBits=7&parity=odd&flowControl=xonxoff",
+          "&flowControl=RTSCTS"}) {
+    BOOST_TEST_CONTEXT(parameters) {
+      ChimeraTK::Device device(cdd(parameters));
+      device.open();
+      BOOST_TEST(device.read<std::string>("/IDN") == "Dummy server for command based serial backend.");
+      device.close();
+    }
+  }
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInvalidSettings) {
+  for(const std::string& parameters : {"&baud=fast", "&baud=0", "&dataBits=9", "&stopBits=3", "&parity=mark",
+          "&flowControl=dtrdsr", "&dataBits=6&flowControl=xonxoff"}) {
+    BOOST_TEST_CONTEXT(parameters) {
+      BOOST_CHECK_THROW(ChimeraTK::Device device(cdd(parameters)), ChimeraTK::logic_error);
+    }
+  }
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSerialSettingsOnTcp) {
+  BOOST_CHECK_THROW(ChimeraTK::Device device("(CommandBasedTCP:localhost?map=test.json&port=5025&baud=115200)"),
+      ChimeraTK::logic_error);
+}
+
+/**********************************************************************************************************************/
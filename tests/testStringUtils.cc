@@ -120,6 +120,45 @@ BOOST_AUTO_TEST_CASE(testHexConversion) {
 
 /**********************************************************************************************************************/
 
+BOOST_AUTO_TEST_CASE(hexKernels_test) {
+  // Lengths around the 16 and 32 byte blocks of the SIMD kernels, which all have to agree with the scalar one.
+  std::string bytes;
+  for(size_t i = 0; i < 259; ++i) {
+    bytes.push_back(static_cast<char>(i * 37 + 11));
+  }
+  std::string hexDigits = "0123456789ABCDEFabcdef";
+  std::string hex;
+  for(size_t i = 0; i < 2 * bytes.size(); ++i) {
+    hex.push_back(hexDigits[(i * 7) % hexDigits.size()]);
+  }
+
+  for(size_t nBytes : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 259}) {
+    std::string expectedHex(2 * nBytes, ' ');
+    encodeHex(bytes.data(), nBytes, expectedHex.data(), HexKernel::SCALAR);
+    std::string expectedBytes(nBytes, ' ');
+    decodeHex(hex.data(), nBytes, expectedBytes.data(), HexKernel::SCALAR);
+
+    for(auto kernel : {HexKernel::SSE2, HexKernel::AVX2}) {
+      std::string encoded(2 * nBytes, ' ');
+      encodeHex(bytes.data(), nBytes, encoded.data(), kernel);
+      BOOST_CHECK_EQUAL(encoded, expectedHex);
+      std::string decoded(nBytes, ' ');
+      decodeHex(hex.data(), nBytes, decoded.data(), kernel);
+      BOOST_CHECK(decoded == expectedBytes);
+    }
+    // The round trip through the string API, which uses the fastest kernel
+    BOOST_CHECK(binaryStrFromHexStr(expectedHex) == bytes.substr(0, nBytes));
+  }
+
+  // Against fixed values, also covering lower case digits
+  std::string decoded(4, ' ');
+  decodeHex("01aFfE9c", 4, decoded.data(), getHexKernel());
+  BOOST_CHECK(decoded == std::string("\x01\xAF\xFE\x9C", 4));
+  BOOST_CHECK_EQUAL(hexStrFromBinaryStr(std::string("\x00\x7F\x80\xFF", 4)), "007F80FF");
+}
+
+/**********************************************************************************************************************/
+
 BOOST_AUTO_TEST_CASE(nullReplacement_test) {
   std::string s = {"rtyuiR67\089oi", 13};
   s[5] = '\x00'; // replace 'R' with null so that the string literal use the single unicode char '\x0067'
@@ -978,3 +1017,34 @@ BOOST_AUTO_TEST_CASE(floatBinary_test) {
 }
 
 /**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(decStrConversion_test) {
+  BOOST_CHECK_EQUAL(numberFromDecStr<int32_t>("-12").value_or(0), -12);
+  BOOST_CHECK_EQUAL(numberFromDecStr<int32_t>("+12").value_or(0), 12);
+  BOOST_CHECK_EQUAL(numberFromDecStr<int8_t>("-128").value_or(0), -128);
+  BOOST_CHECK(not numberFromDecStr<int8_t>("128"));   // overflow
+  BOOST_CHECK(not numberFromDecStr<uint16_t>("-1"));  // overflow
+  BOOST_CHECK(not numberFromDecStr<int32_t>("12x"));  // not entirely a number
+  BOOST_CHECK(not numberFromDecStr<int32_t>(""));
+  BOOST_CHECK_EQUAL(numberFromDecStr<double>("4.").value_or(0), 4.);
+  BOOST_CHECK_EQUAL(numberFromDecStr<float>("+3.25").value_or(0), 3.25F);
+  BOOST_CHECK(not numberFromDecStr<float>("1e50"));
+
+  BOOST_CHECK_EQUAL(intFromHexStr<uint32_t>("1f").value_or(0), 0x1FU);
+  BOOST_CHECK_EQUAL(intFromHexStr<uint64_t>("FFFFFFFFFFFFFFFF").value_or(0), UINT64_MAX);
+  BOOST_CHECK(not intFromHexStr<int16_t>("8000")); // overflow
+  BOOST_CHECK(not intFromHexStr<int16_t>("-1"));
+  BOOST_CHECK(not intFromHexStr<uint32_t>("0x1f"));
+
+  BOOST_CHECK_EQUAL(decStrFromNumber(int8_t(-5)), "-5");
+  BOOST_CHECK_EQUAL(decStrFromNumber(uint64_t(UINT64_MAX)), "18446744073709551615");
+  BOOST_CHECK_EQUAL(decStrFromNumber(2.5F), "2.5");
+  BOOST_CHECK_EQUAL(decStrFromNumber(-1e-7), "-0.0000001");
+  BOOST_CHECK_EQUAL(decStrFromNumber(0.1F), "0.1"); // shortest for float, not for the double it converts to
+  // Round trip of the extremes
+  for(double d : {DBL_MAX, DBL_MIN, -DBL_EPSILON, 3.14e9}) {
+    BOOST_CHECK_EQUAL(numberFromDecStr<double>(decStrFromNumber(d)).value_or(0), d);
+  }
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE TcpSocketTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "IoReactor.h"
+#include "TcpCommandHandler.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <string>
+#include <thread>
+
+using boost::asio::ip::tcp;
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+/**
+ * A minimal TCP server on localhost. For each received line it sends the reply returned by the respond function,
+ * in a single write.
+ */
+struct LineServer {
+  explicit LineServer(std::function<std::string(const std::string&)> respond)
+  : acceptor(io, tcp::endpoint(tcp::v4(), 0)), port(std::to_string(acceptor.local_endpoint().port())) {
+    serverThread = std::thread([this, respond = std::move(respond)] {
+      try {
+        tcp::socket socket(io);
+        acceptor.accept(socket);
+        boost::asio::streambuf buffer;
+        while(true) {
+          size_t n = boost::asio::read_until(socket, buffer, "\r\n");
+          auto begin = boost::asio::buffers_begin(buffer.data());
+          std::string line(begin, begin + static_cast<std::ptrdiff_t>(n - 2));
+          buffer.consume(n);
+          boost::asio::write(socket, boost::asio::buffer(respond(line)));
+        }
+      }
+      catch(std::exception&) {
+        // connection closed by the client
+      }
+    });
+  }
+
+  ~LineServer() { serverThread.join(); }
+
+  boost::asio::io_context io;
+  tcp::acceptor acceptor;
+  std::string port;
+  std::thread serverThread;
+};
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMultiLineReplyInOnePacket) {
+  // All lines arrive in a single packet, so the first read receives everything. The following lines must not be lost.
+  LineServer server([](const std::string& line) { return line + "\r\nsecond\r\nthird\r\n"; });
+  TcpCommandHandler handler("localhost", server.port);
+
+  auto reply = handler.sendCommandAndReadLines("first", 3);
+  BOOST_TEST(reply == std::vector<std::string>({"first", "second", "third"}), boost::test_tools::per_element());
+
+  reply = handler.sendCommandAndReadLines("again", 3);
+  BOOST_TEST(reply == std::vector<std::string>({"again", "second", "third"}), boost::test_tools::per_element());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testBytesAfterLine) {
+  LineServer server([](const std::string& line) { return line + "\r\nXYZ"; });
+  TcpCommandHandler handler("localhost", server.port);
+
+  BOOST_TEST(handler.sendCommandAndReadLines("line", 1)[0] == "line");
+  // The bytes have arrived with the line, so the byte read has to take them from the receive buffer.
+  // Nothing is sent, hence the server does not reply again.
+  BOOST_TEST(handler.sendCommandAndReadBytes("", 3, "") == "XYZ");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testObservedBytes) {
+  std::string payload(3000, 'p');
+  LineServer server([&](const std::string& line) { return line == "more" ? payload : line + "\r\nXYZ"; });
+  TcpCommandHandler handler("localhost", server.port);
+
+  BOOST_TEST(handler.sendCommandAndReadLines("line", 1)[0] == "line");
+  // The observer gets the bytes already in the receive buffer first, then the rest as it arrives.
+  std::vector<std::string> chunks;
+  std::string reply = handler.sendCommandAndReadBytes(
+      "more", 3 + payload.size(), "\r\n", [&](std::string_view bytes) { chunks.emplace_back(bytes); });
+  BOOST_TEST(reply == "XYZ" + payload);
+  BOOST_REQUIRE(not chunks.empty());
+  BOOST_TEST(chunks.front() == "XYZ");
+  std::string observed;
+  for(const auto& chunk : chunks) {
+    observed += chunk;
+  }
+  BOOST_TEST(observed == reply);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testTimeout) {
+  LineServer server([](const std::string& line) { return line == "silent" ? std::string() : line + "\r\n"; });
+  TcpCommandHandler handler("localhost", server.port, "\r\n", 100);
+
+  BOOST_CHECK_EXCEPTION(handler.sendCommandAndReadLines("silent", 1), ChimeraTK::runtime_error,
+      [](const ChimeraTK::runtime_error& e) { return std::string(e.what()).find("timed out") != std::string::npos; });
+  // The connection is still usable after a timeout.
+  BOOST_TEST(handler.sendCommandAndReadLines("hello", 1)[0] == "hello");
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSharedReactor) {
+  // Sockets share one reactor, whose thread pool grows on request.
+  LineServer server1([](const std::string& line) { return line + "\r\n"; });
+  LineServer server2([](const std::string& line) { return line + "\r\n"; });
+  TcpCommandHandler handler1("localhost", server1.port);
+  TcpCommandHandler handler2("localhost", server2.port, "\r\n", 1000, 2);
+
+  BOOST_TEST(IoReactor::getInstance()->getNumberOfThreads() == 2);
+  BOOST_TEST(handler1.sendCommandAndReadLines("one", 1)[0] == "one");
+  BOOST_TEST(handler2.sendCommandAndReadLines("two", 1)[0] == "two");
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE UnsolicitedTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+
+#include <ChimeraTK/Device.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using ChimeraTK::AccessMode;
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+
+static DummyServer dummyServer{true, DEBUG};
+
+static std::string getCdd(const std::string& mapFile = "testUnsolicited.json") {
+  return "(CommandBasedTTY:" + dummyServer.deviceNode + "?map=" + mapFile + ")";
+}
+
+/**
+ * Wait for the next value of the accessor, with a timeout so a missing push fails the test instead of blocking it.
+ */
+static bool waitForValue(ChimeraTK::ScalarRegisterAccessor<int64_t>& accessor) {
+  for(int i = 0; i < 200; ++i) {
+    if(accessor.readNonBlocking()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testCatalogue) {
+  ChimeraTK::Device device(getCdd());
+  auto info = device.getRegisterCatalogue().getRegister("/limitEvent");
+  BOOST_TEST(info.isReadable());
+  BOOST_TEST(not info.isWriteable());
+  BOOST_TEST(info.getSupportedAccessModes().has(AccessMode::wait_for_new_data));
+
+  // The read command serves synchronous reads.
+  device.open();
+  auto synchronous = device.getScalarRegisterAccessor<int64_t>("/limitEvent");
+  synchronous.read();
+  BOOST_TEST(int64_t(synchronous) == int64_t(dummyServer.nLimitEvents));
+  device.close();
+
+  // The same register without read command is rejected.
+  nlohmann::json j;
+  std::ifstream("testUnsolicited.json") >> j;
+  j["registers"]["/limitEvent"].erase("read");
+  std::ofstream("testUnsolicitedWithoutRead.json") << j;
+  BOOST_CHECK_THROW(ChimeraTK::Device(getCdd("testUnsolicitedWithoutRead.json")).open(), ChimeraTK::logic_error);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testInitialValue) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  dummyServer.nLimitEvents = 17;
+  device.activateAsyncRead();
+
+  // The read command provides the initial value, without any unsolicited line.
+  BOOST_REQUIRE(waitForValue(limit));
+  BOOST_TEST(int64_t(limit) == 17);
+  BOOST_TEST(not limit.readNonBlocking());
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLinesAmongResponses) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  auto acc = device.getOneDRegisterAccessor<double>("/ACC");
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+
+  // The event lines come before the responses, but do not disturb them.
+  dummyServer.cwFrequency = 1234;
+  dummyServer.sendLimitEvents = true;
+  frequency.read();
+  acc.read();
+  dummyServer.sendLimitEvents = false;
+  BOOST_TEST(uint64_t(frequency) == 1234);
+  BOOST_TEST(acc[0] == float(dummyServer.acc[0]), boost::test_tools::tolerance(1e-6));
+  BOOST_TEST(acc[1] == float(dummyServer.acc[1]), boost::test_tools::tolerance(1e-6));
+
+  BOOST_REQUIRE(waitForValue(limit));
+  // The queue may hold the first event still, or already the last one.
+  BOOST_TEST(int64_t(limit) > 0);
+  BOOST_TEST(int64_t(limit) <= int64_t(dummyServer.nLimitEvents));
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLinesBetweenCommands) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+
+  // Writes have no response, so the event line is picked up by the listener.
+  dummyServer.sendLimitEvents = true;
+  frequency = 42;
+  frequency.write();
+  BOOST_REQUIRE(waitForValue(limit));
+  dummyServer.sendLimitEvents = false;
+  BOOST_TEST(int64_t(limit) == int64_t(dummyServer.nLimitEvents));
+  BOOST_TEST(not limit.readNonBlocking());
+
+  // Commands still get their responses after the listener has been at work.
+  frequency.read();
+  BOOST_TEST(uint64_t(frequency) == 42);
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testException) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+
+  // A failing command is pushed as exception.
+  dummyServer.sendNothing = true;
+  BOOST_CHECK_THROW(frequency.read(), ChimeraTK::runtime_error);
+  BOOST_CHECK_THROW(limit.read(), ChimeraTK::runtime_error);
+  dummyServer.sendNothing = false;
+
+  // After recovery, events arrive again.
+  device.open();
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+  dummyServer.sendLimitEvents = true;
+  frequency.write();
+  BOOST_REQUIRE(waitForValue(limit));
+  dummyServer.sendLimitEvents = false;
+  BOOST_TEST(int64_t(limit) == int64_t(dummyServer.nLimitEvents));
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStreamingDevice) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+
+  // The device sends events continuously. The listener must still let the commands through, and the events among the
+  // responses must not extend the timeout of the commands (1000 ms by default).
+  dummyServer.cwFrequency = 777;
+  dummyServer.streamLimitEvents = true;
+  std::chrono::steady_clock::duration longestRead{};
+  for(int i = 0; i < 20; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    frequency.read();
+    longestRead = std::max(longestRead, std::chrono::steady_clock::now() - start);
+    BOOST_TEST(uint64_t(frequency) == 777);
+  }
+  BOOST_REQUIRE(waitForValue(limit));
+  dummyServer.streamLimitEvents = false;
+  BOOST_TEST(std::chrono::duration_cast<std::chrono::milliseconds>(longestRead).count() < 1000);
+  BOOST_TEST(int64_t(limit) > 0);
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConnectionLost) {
+  ChimeraTK::Device device(getCdd());
+  device.open();
+  auto limit = device.getScalarRegisterAccessor<int64_t>("/limitEvent", 0, {AccessMode::wait_for_new_data});
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+
+  // Only the listener is reading from the device, so it has to report the lost connection.
+  dummyServer.deactivate();
+  bool hasThrown = false;
+  for(int i = 0; i < 200 and not hasThrown; ++i) {
+    try {
+      limit.readNonBlocking();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    catch(const ChimeraTK::runtime_error&) {
+      hasThrown = true;
+    }
+  }
+  BOOST_TEST(hasThrown);
+  BOOST_TEST(not device.isFunctional());
+
+  // After recovery, events arrive again.
+  dummyServer.activate();
+  device.open();
+  device.activateAsyncRead();
+  limit.read(); // the initial value
+  auto frequency = device.getScalarRegisterAccessor<uint64_t>("/cwFrequency");
+  dummyServer.sendLimitEvents = true;
+  frequency.write();
+  BOOST_REQUIRE(waitForValue(limit));
+  dummyServer.sendLimitEvents = false;
+  BOOST_TEST(int64_t(limit) == int64_t(dummyServer.nLimitEvents));
+  device.close();
+}
+
+/**********************************************************************************************************************/
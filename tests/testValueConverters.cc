@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ValueConvertersTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "ValueConverters.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+static InteractionInfo makeInfo(TransportLayerType type, bool isSigned = false, std::optional<size_t> width = {}) {
+  InteractionInfo iInfo;
+  iInfo.setTransportLayerType(type);
+  iInfo.isSigned = isSigned;
+  iInfo.fixedRegexCharacterWidthOpt = width;
+  return iInfo;
+}
+
+template<typename UserType>
+static UserType read(const ReadConverter<UserType>& converter, std::string_view text) {
+  return std::visit([&](const auto& convert) { return convert(text); }, converter);
+}
+
+template<typename UserType>
+static std::string write(const WriteConverter<UserType>& converter, const UserType& value) {
+  return std::visit([&](const auto& convert) { return convert(value); }, converter);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSelection) {
+  auto decInt = makeInfo(TransportLayerType::DEC_INT);
+  auto hexInt = makeInfo(TransportLayerType::HEX_INT);
+  auto signedHexInt = makeInfo(TransportLayerType::HEX_INT, true, 4);
+  auto binFloat = makeInfo(TransportLayerType::BIN_FLOAT, false, 8);
+  auto str = makeInfo(TransportLayerType::STRING);
+
+  BOOST_TEST((std::holds_alternative<DecimalReader<int32_t>>(makeReadConverter<int32_t>(decInt))));
+  BOOST_TEST((std::holds_alternative<HexIntReader<int32_t, false>>(makeReadConverter<int32_t>(hexInt))));
+  BOOST_TEST((std::holds_alternative<HexIntReader<int16_t, true>>(makeReadConverter<int16_t>(signedHexInt))));
+  BOOST_TEST((std::holds_alternative<HexFloatReader<float>>(makeReadConverter<float>(binFloat))));
+  BOOST_TEST((std::holds_alternative<StringReader<std::string>>(makeReadConverter<std::string>(decInt))));
+  BOOST_TEST((std::holds_alternative<StringReader<double>>(makeReadConverter<double>(str))));
+
+  BOOST_TEST((std::holds_alternative<DecimalWriter<double>>(makeWriteConverter<double>(decInt))));
+  BOOST_TEST((std::holds_alternative<HexIntWriter<uint8_t, false, false>>(makeWriteConverter<uint8_t>(hexInt))));
+  BOOST_TEST((std::holds_alternative<HexIntWriter<int16_t, true, true>>(makeWriteConverter<int16_t>(signedHexInt))));
+  BOOST_TEST((std::holds_alternative<HexFloatWriter<float>>(makeWriteConverter<float>(binFloat))));
+  BOOST_TEST((std::holds_alternative<StringWriter<std::string>>(makeWriteConverter<std::string>(hexInt))));
+
+  auto binInt = makeInfo(TransportLayerType::BIN_INT, true, 4);
+  BOOST_TEST((std::holds_alternative<BinaryIntReader<int16_t, true>>(makeBinaryReadConverter<int16_t>(binInt))));
+  BOOST_TEST((std::holds_alternative<BinaryFloatReader<float>>(makeBinaryReadConverter<float>(binFloat))));
+  BOOST_TEST((std::holds_alternative<BinaryAsHexReader<float>>(makeBinaryReadConverter<float>(binInt))));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConversions) {
+  BOOST_TEST(read(makeReadConverter<int32_t>(makeInfo(TransportLayerType::DEC_INT)), "-42") == -42);
+  BOOST_TEST(read(makeReadConverter<double>(makeInfo(TransportLayerType::DEC_FLOAT)), "+2.5") == 2.5);
+  BOOST_TEST(read(makeReadConverter<uint16_t>(makeInfo(TransportLayerType::HEX_INT)), "ab0C") == 0xAB0C);
+  BOOST_TEST(read(makeReadConverter<int16_t>(makeInfo(TransportLayerType::HEX_INT, true, 4)), "FFFE") == -2);
+  BOOST_TEST(read(makeReadConverter<float>(makeInfo(TransportLayerType::BIN_FLOAT, false, 8)), "40200000") == 2.5F);
+
+  BOOST_TEST(write(makeWriteConverter<int32_t>(makeInfo(TransportLayerType::DEC_INT)), -42) == "-42");
+  BOOST_TEST(write(makeWriteConverter<float>(makeInfo(TransportLayerType::DEC_FLOAT)), 2.5F) == "2.5");
+  BOOST_TEST(write(makeWriteConverter<int16_t>(makeInfo(TransportLayerType::HEX_INT, true, 4)), int16_t(-2)) ==
+      "FFFE");
+  BOOST_TEST(write(makeWriteConverter<float>(makeInfo(TransportLayerType::BIN_FLOAT, false, 8)), 2.5F) == "40200000");
+  BOOST_CHECK_THROW(
+      write(makeWriteConverter<uint16_t>(makeInfo(TransportLayerType::HEX_INT, false, 2)), uint16_t(0x100)),
+      ChimeraTK::runtime_error);
+
+  auto binary = makeBinaryReadConverter<int16_t>(makeInfo(TransportLayerType::BIN_INT, true, 4));
+  BOOST_TEST(std::visit([](const auto& convert) { return convert(std::string_view("\xFF\xFE", 2)); }, binary) == -2);
+}
+
+/**********************************************************************************************************************/
@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ZeroAllocationTest
+#include <boost/test/unit_test.hpp>
+using namespace boost::unit_test_framework;
+
+#include "DummyServer.h"
+#include "SerialCommandHandler.h"
+
+#include <ChimeraTK/Device.h>
+
+#include <boost/asio.hpp>
+#include <boost/process.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**********************************************************************************************************************/
+
+constexpr bool DEBUG = false;
+constexpr size_t nRepetitions = 100;
+
+/**********************************************************************************************************************/
+// The global allocation functions are replaced to count the allocations of the test's thread only. The DummyServer
+// answers from its own thread, which may allocate as much as it likes. The array and nothrow versions call these.
+
+namespace {
+  thread_local bool isCounting = false;
+  thread_local size_t nAllocations = 0;
+
+  /** Count the allocations in the scope of the AllocationCounter. */
+  struct AllocationCounter {
+    AllocationCounter() {
+      nAllocations = 0;
+      isCounting = true;
+    }
+    ~AllocationCounter() { isCounting = false; }
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+  };
+} // namespace
+
+void* operator new(size_t size) {
+  if(isCounting) {
+    ++nAllocations;
+  }
+  if(void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, [[maybe_unused]] size_t size) noexcept {
+  std::free(p);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testCommandHandler) {
+  DummyServer dummyServer{true, DEBUG};
+  SerialCommandHandler handler(dummyServer.deviceNode);
+
+  std::vector<std::string> lines;
+  // Let the buffers grow to their steady state size.
+  handler.sendCommandAndReadLinesInto(
+      "SOUR:FREQ:CW?", 1, CommandHandlerDefaultDelimiter{}, CommandHandlerDefaultDelimiter{}, lines);
+
+  {
+    AllocationCounter counter;
+    for(size_t i = 0; i < nRepetitions; ++i) {
+      handler.sendCommandAndReadLinesInto(
+          "SOUR:FREQ:CW?", 1, CommandHandlerDefaultDelimiter{}, CommandHandlerDefaultDelimiter{}, lines);
+    }
+  }
+  BOOST_TEST(nAllocations == 0);
+  BOOST_REQUIRE_EQUAL(lines.size(), 1);
+  BOOST_TEST(lines[0] == std::to_string(dummyServer.cwFrequency));
+}
+
+/**********************************************************************************************************************/
+
+/**
+ * Forwards a TCP port on localhost to the serial port of the DummyServer with socat, so the DummyServer also serves a
+ * CommandBasedTCP device. socat accepts a single connection, and is terminated with the relay.
+ */
+struct TcpRelay {
+  explicit TcpRelay(const std::string& deviceNode)
+  : port(getFreePort()),
+    socatRunner(boost::process::search_path("socat"),
+        boost::process::args({"TCP-LISTEN:" + port + ",bind=127.0.0.1,reuseaddr", deviceNode + ",raw,echo=0"})) {}
+
+  static std::string getFreePort() {
+    boost::asio::io_context io;
+    boost::asio::ip::tcp::acceptor acceptor(io, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 0));
+    return std::to_string(acceptor.local_endpoint().port());
+  }
+
+  std::string port;
+  boost::process::child socatRunner;
+};
+
+/**********************************************************************************************************************/
+
+/**
+ * Repeatedly write and read registers with different conversions on the opened device, and check that nothing is
+ * allocated once the buffers have grown to their steady state size.
+ */
+void checkReadAndWrite(DummyServer& dummyServer, ChimeraTK::Device& device) {
+  auto frequency = device.getScalarRegisterAccessor<int32_t>("/cwFrequency");
+  auto acceleration = device.getOneDRegisterAccessor<double>("/ACC");
+  auto float32 = device.getScalarRegisterAccessor<float>("/floatTest");
+  auto hexSigned = device.getOneDRegisterAccessor<int32_t>("/myHexSigned");
+  auto binarySigned = device.getScalarRegisterAccessor<int32_t>("/uLogSigned");
+
+  auto transferAll = [&] {
+    frequency.write();
+    frequency.read();
+    acceleration.write();
+    acceleration.read();
+    float32.write();
+    float32.read();
+    hexSigned.read();
+    binarySigned.read();
+  };
+
+  frequency = 1234;
+  acceleration[0] = 1.5;
+  acceleration[1] = -2.25;
+  float32 = 2.5F;
+  dummyServer.ulog = 0xFFFFFF85;
+  transferAll(); // Let the buffers grow to their steady state size.
+
+  {
+    AllocationCounter counter;
+    for(size_t i = 0; i < nRepetitions; ++i) {
+      transferAll();
+    }
+  }
+  BOOST_TEST(nAllocations == 0);
+
+  BOOST_TEST(int32_t(frequency) == 1234);
+  BOOST_TEST(acceleration[0] == 1.5);
+  BOOST_TEST(acceleration[1] == -2.25);
+  BOOST_TEST(float(float32) == 2.5F);
+  // Sign extended from the 32 bits of the values.
+  BOOST_TEST(hexSigned[0] == static_cast<int32_t>(0xBABEF00D));
+  BOOST_TEST(hexSigned[1] == static_cast<int32_t>(0xFEEDC0DE));
+  BOOST_TEST(hexSigned[2] == static_cast<int32_t>(0xBADDCAFE));
+  BOOST_TEST(int32_t(binarySigned) == -123);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadAndWrite) {
+  DummyServer dummyServer{true, DEBUG};
+  ChimeraTK::Device device("(CommandBasedTTY:" + dummyServer.deviceNode + "?map=test.json)");
+  device.open();
+
+  checkReadAndWrite(dummyServer, device);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadAndWriteTcp) {
+  DummyServer dummyServer{true, DEBUG};
+  TcpRelay relay(dummyServer.deviceNode);
+  ChimeraTK::Device device("(CommandBasedTCP:localhost?map=test.json&port=" + relay.port + ")");
+  // socat needs a moment until it listens.
+  for(size_t i = 0;; ++i) {
+    try {
+      device.open();
+      break;
+    }
+    catch(ChimeraTK::runtime_error&) {
+      if(i == 100) {
+        throw;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  checkReadAndWrite(dummyServer, device);
+}
+
+/**********************************************************************************************************************/